@@ -0,0 +1,4 @@
+#pragma once
+
+// SampleGameStates, shared with the unit tests
+#include "game_state/game_state_utils.h"
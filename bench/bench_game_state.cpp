@@ -0,0 +1,85 @@
+#include <benchmark/benchmark.h>
+#include "bench_common.h"
+#include "game_state/dice.h"
+#include "move/move_outcome.h"
+#include "move/score_table.h"
+
+static void BM_DiceFromInitializerList(benchmark::State &state) {
+    size_t face = 1;
+    for (auto _ : state) {
+        Dice dice{face, 2, 3, 4, 5};
+        benchmark::DoNotOptimize(dice);
+        face = face % 6 + 1;
+    }
+}
+BENCHMARK(BM_DiceFromInitializerList);
+
+static void BM_DiceFromVector(benchmark::State &state) {
+    std::vector<size_t> values{1, 2, 3, 4, 5};
+    for (auto _ : state) {
+        Dice dice(values);
+        benchmark::DoNotOptimize(dice);
+    }
+}
+BENCHMARK(BM_DiceFromVector);
+
+static void BM_DiceFromRollIndex(benchmark::State &state) {
+    RollIndex roll = 0;
+    for (auto _ : state) {
+        Dice dice = Dice::from_roll_index(roll);
+        benchmark::DoNotOptimize(dice);
+        roll = static_cast<RollIndex>((roll + 1) % NUM_ROLLS);
+    }
+}
+BENCHMARK(BM_DiceFromRollIndex);
+
+static void BM_DiceRollIndex(benchmark::State &state) {
+    Dice dice{6, 2, 3, 6, 1};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(dice.roll_index());
+    }
+}
+BENCHMARK(BM_DiceRollIndex);
+
+// Every category of every roll per iteration
+static void BM_CalculateScore(benchmark::State &state) {
+    std::vector<Dice> rolls;
+    for (size_t roll = 0; roll < NUM_ROLLS; ++roll) {
+        rolls.push_back(Dice::from_roll_index(static_cast<RollIndex>(roll)));
+    }
+    for (auto _ : state) {
+        size_t total = 0;
+        for (const Dice &dice : rolls) {
+            for (size_t category = 0; category < NUM_CATEGORIES; ++category) {
+                total += CalculateScore(dice, static_cast<Category>(category));
+            }
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * NUM_ROLLS * NUM_CATEGORIES);
+}
+BENCHMARK(BM_CalculateScore);
+
+static void BM_RollScoreTable(benchmark::State &state) {
+    for (auto _ : state) {
+        size_t total = 0;
+        for (size_t roll = 0; roll < NUM_ROLLS; ++roll) {
+            for (size_t category = 0; category < NUM_CATEGORIES; ++category) {
+                total += RollScore(static_cast<RollIndex>(roll), static_cast<Category>(category));
+            }
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * NUM_ROLLS * NUM_CATEGORIES);
+}
+BENCHMARK(BM_RollScoreTable);
+
+static void BM_ShortGameStateFromGameState(benchmark::State &state) {
+    auto states = SampleGameStates(64);
+    size_t i = 0;
+    for (auto _ : state) {
+        ShortGameState short_state(states[i++ % states.size()]);
+        benchmark::DoNotOptimize(short_state);
+    }
+}
+BENCHMARK(BM_ShortGameStateFromGameState);
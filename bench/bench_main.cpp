@@ -0,0 +1,153 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Usage: yahtzee_bench [benchmark flags] [--baseline=<file>] [--max_regression=<fraction>]
+//
+// JSON output uses the Google Benchmark flags:
+//   yahtzee_bench --benchmark_out=current.json --benchmark_out_format=json
+// A file written that way can be given as --baseline of a later run, which
+// then prints the CPU time of every benchmark against the baseline and exits
+// with 1 when one is slower by more than max_regression (default 0.10).
+
+namespace {
+
+// Console output that also keeps the CPU time of every run in nanoseconds
+class CollectingReporter : public benchmark::ConsoleReporter {
+public:
+    void ReportRuns(const std::vector<Run> &runs) override {
+        for (const Run &run : runs) {
+            if (!run.error_occurred) {
+                cpu_times_[run.benchmark_name()] =
+                    run.GetAdjustedCPUTime() / benchmark::GetTimeUnitMultiplier(run.time_unit) * 1e9;
+            }
+        }
+        ConsoleReporter::ReportRuns(runs);
+    }
+
+    const std::map<std::string, double> &GetCpuTimes() const { return cpu_times_; }
+
+private:
+    std::map<std::string, double> cpu_times_;
+};
+
+// Field of a flat JSON object, the text after `"key": `
+std::string JsonField(const std::string &object, const std::string &key) {
+    const std::string pattern = "\"" + key + "\":";
+    size_t position = object.find(pattern);
+    if (position == std::string::npos) {
+        return {};
+    }
+    position = object.find_first_not_of(" \t\r\n", position + pattern.size());
+    if (position == std::string::npos) {
+        return {};
+    }
+    if (object[position] == '"') {
+        return object.substr(position + 1, object.find('"', position + 1) - position - 1);
+    }
+    return object.substr(position, object.find_first_of(",}\r\n", position) - position);
+}
+
+double UnitToNanoseconds(const std::string &unit) {
+    if (unit == "s") return 1e9;
+    if (unit == "ms") return 1e6;
+    if (unit == "us") return 1e3;
+    return 1.0;
+}
+
+// CPU times in nanoseconds of a Google Benchmark JSON file, by benchmark name
+std::map<std::string, double> ReadBaseline(const std::string &path) {
+    std::ifstream file(path);
+    if (!file) {
+        throw std::runtime_error("Cannot open baseline " + path);
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    const std::string json = buffer.str();
+
+    std::map<std::string, double> cpu_times;
+    size_t position = json.find("\"benchmarks\"");
+    while (position != std::string::npos) {
+        const size_t begin = json.find('{', position);
+        if (begin == std::string::npos) {
+            break;
+        }
+        const size_t end = json.find('}', begin);
+        const std::string object = json.substr(begin, end - begin + 1);
+        const std::string name = JsonField(object, "name");
+        const std::string cpu_time = JsonField(object, "cpu_time");
+        if (!name.empty() && !cpu_time.empty()) {
+            cpu_times[name] = std::strtod(cpu_time.c_str(), nullptr) * UnitToNanoseconds(JsonField(object, "time_unit"));
+        }
+        position = end;
+    }
+    return cpu_times;
+}
+
+// Prints current against baseline times, returns the number of regressions
+int CompareWithBaseline(const std::map<std::string, double> &current, const std::map<std::string, double> &baseline,
+                        double max_regression) {
+    int regressions = 0;
+    std::cout << "\nComparison with baseline (CPU time, current / baseline):\n";
+    for (const auto &[name, time] : current) {
+        auto found = baseline.find(name);
+        if (found == baseline.end() || found->second <= 0.0) {
+            std::cout << "  " << std::left << std::setw(56) << name << " new\n";
+            continue;
+        }
+        const double ratio = time / found->second;
+        const bool regressed = ratio > 1.0 + max_regression;
+        regressions += regressed ? 1 : 0;
+        std::cout << "  " << std::left << std::setw(56) << name << std::right << std::fixed << std::setprecision(3)
+                  << ratio << (regressed ? "  REGRESSION" : "") << "\n";
+    }
+    return regressions;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    std::string baseline_path;
+    double max_regression = 0.10;
+
+    // Own flags are removed before Google Benchmark sees the arguments
+    std::vector<char *> arguments;
+    for (int i = 0; i < argc; ++i) {
+        if (std::strncmp(argv[i], "--baseline=", 11) == 0) {
+            baseline_path = argv[i] + 11;
+        } else if (std::strncmp(argv[i], "--max_regression=", 17) == 0) {
+            max_regression = std::strtod(argv[i] + 17, nullptr);
+        } else {
+            arguments.push_back(argv[i]);
+        }
+    }
+    int count = static_cast<int>(arguments.size());
+    benchmark::Initialize(&count, arguments.data());
+    if (benchmark::ReportUnrecognizedArguments(count, arguments.data())) {
+        return 1;
+    }
+
+    CollectingReporter reporter;
+    benchmark::RunSpecifiedBenchmarks(&reporter);
+    benchmark::Shutdown();
+
+    if (baseline_path.empty()) {
+        return 0;
+    }
+    try {
+        int regressions = CompareWithBaseline(reporter.GetCpuTimes(), ReadBaseline(baseline_path), max_regression);
+        return regressions > 0 ? 1 : 0;
+    } catch (const std::exception &error) {
+        std::cerr << error.what() << std::endl;
+        return 1;
+    }
+}
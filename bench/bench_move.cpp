@@ -0,0 +1,88 @@
+#include <benchmark/benchmark.h>
+#include "bench_common.h"
+#include "move/move.h"
+#include "move/move_list.h"
+#include "move/move_outcome.h"
+
+template<typename S>
+static std::vector<S> SampleStates() {
+    auto states = SampleGameStates(64);
+    return std::vector<S>(states.begin(), states.end());
+}
+
+template<typename S>
+static void BM_GetPossibleMovesVector(benchmark::State &state) {
+    auto states = SampleStates<S>();
+    size_t i = 0;
+    for (auto _ : state) {
+        auto moves = GetPossibleMoves(states[i++ % states.size()]);
+        benchmark::DoNotOptimize(moves.data());
+    }
+}
+BENCHMARK_TEMPLATE(BM_GetPossibleMovesVector, GameState);
+BENCHMARK_TEMPLATE(BM_GetPossibleMovesVector, ShortGameState);
+
+template<typename S>
+static void BM_GetPossibleMovesList(benchmark::State &state) {
+    auto states = SampleStates<S>();
+    MoveList moves;
+    size_t i = 0;
+    for (auto _ : state) {
+        GetPossibleMoves(states[i++ % states.size()], moves);
+        benchmark::DoNotOptimize(moves.size());
+    }
+}
+BENCHMARK_TEMPLATE(BM_GetPossibleMovesList, GameState);
+BENCHMARK_TEMPLATE(BM_GetPossibleMovesList, ShortGameState);
+
+// Every possible move of the sample states in turn
+template<typename S>
+static void BM_ApplyMove(benchmark::State &state) {
+    auto states = SampleStates<S>();
+    std::vector<std::pair<size_t, Move>> moves;
+    for (size_t i = 0; i < states.size(); ++i) {
+        for (const Move &move : GetPossibleMoves(states[i])) {
+            moves.emplace_back(i, move);
+        }
+    }
+    size_t i = 0;
+    for (auto _ : state) {
+        const auto &[index, move] = moves[i++ % moves.size()];
+        auto outcome = ApplyMove(states[index], move);
+        benchmark::DoNotOptimize(outcome);
+    }
+}
+BENCHMARK_TEMPLATE(BM_ApplyMove, GameState);
+BENCHMARK_TEMPLATE(BM_ApplyMove, ShortGameState);
+
+// Same moves applied and undone in place
+template<typename S>
+static void BM_MakeUnmakeMove(benchmark::State &state) {
+    auto states = SampleStates<S>();
+    std::vector<std::pair<size_t, CompactMove>> moves;
+    MoveList list;
+    for (size_t i = 0; i < states.size(); ++i) {
+        GetPossibleMoves(states[i], list);
+        for (size_t j = 0; j < list.size(); ++j) {
+            moves.emplace_back(i, list[j]);
+        }
+    }
+    size_t i = 0;
+    for (auto _ : state) {
+        const auto &[index, move] = moves[i++ % moves.size()];
+        UndoToken<S> token = MakeMove(states[index], move);
+        benchmark::DoNotOptimize(token);
+        UnmakeMove(states[index], token);
+    }
+}
+BENCHMARK_TEMPLATE(BM_MakeUnmakeMove, GameState);
+BENCHMARK_TEMPLATE(BM_MakeUnmakeMove, ShortGameState);
+
+static void BM_GetRerollOutcomes(benchmark::State &state) {
+    RerrolMove move(std::vector<size_t>{6, 6});
+    for (auto _ : state) {
+        auto outcomes = GetRerollOutcomes(move);
+        benchmark::DoNotOptimize(outcomes.data());
+    }
+}
+BENCHMARK(BM_GetRerollOutcomes);
@@ -0,0 +1,293 @@
+#include <benchmark/benchmark.h>
+#include "bench_common.h"
+#include "move/move_outcome.h"
+#include "simulation/log_analyzer.h"
+#include "simulation/simulator.h"
+#include "solver/advisor.h"
+#include "solver/duel_solver.h"
+#include "solver/expectimax.h"
+#include "solver/lazy_solver.h"
+#include "solver/policy_table.h"
+#include "solver/quantized_table.h"
+#include "solver/solver.h"
+#include "solver/turn_evaluator.h"
+
+#include <cstdio>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <string>
+
+// Full solve shared by the query benchmarks, done on first use
+static const Solver &SolvedTable() {
+    static const Solver solver = [] {
+        Solver solved;
+        solved.Solve();
+        return solved;
+    }();
+    return solver;
+}
+
+// One turn of a mid-game state, the unit of work of the solver; the Maxi
+// Yatzy rules roll six dice over a table of 1 GiB
+template<typename Rules>
+static void BM_TurnEvaluate(benchmark::State &state) {
+    using StateKey = typename Rules::StateKey;
+    std::vector<double> values(StateKey::NUM_INDICES, 0.0);
+    BasicTurnEvaluator<Rules> evaluator(values.data());
+    const std::vector<StateKey> keys = GetLayerStates<Rules>(6);
+    size_t i = 0;
+    for (auto _ : state) {
+        evaluator.Evaluate(keys[i++ % keys.size()]);
+        benchmark::DoNotOptimize(evaluator.GetTurnStartValue());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_TurnEvaluate, YahtzeeRules);
+BENCHMARK_TEMPLATE(BM_TurnEvaluate, MaxiYatzyNoSavedRerollsRules);
+
+static void BM_SolveLastLayers(benchmark::State &state) {
+    for (auto _ : state) {
+        Solver solver;
+        for (size_t filled = NUM_CATEGORIES + 1; filled-- > NUM_CATEGORIES - 3;) {
+            solver.SolveLayer(filled);
+        }
+        benchmark::DoNotOptimize(solver.GetValues().data());
+    }
+}
+BENCHMARK(BM_SolveLastLayers)->Unit(benchmark::kMillisecond);
+
+static void BM_FullSolve(benchmark::State &state) {
+    for (auto _ : state) {
+        Solver solver;
+        solver.Solve();
+        benchmark::DoNotOptimize(solver.GetValues().data());
+    }
+}
+BENCHMARK(BM_FullSolve)->Unit(benchmark::kSecond)->Iterations(1);
+
+static void BM_AdvisorQuery(benchmark::State &state) {
+    Advisor advisor(SolvedTable().GetValues().data());
+    auto states = SampleGameStates(256);
+    Advice advice;
+    size_t i = 0;
+    for (auto _ : state) {
+        advisor.Advise(states[i++ % states.size()], advice);
+        benchmark::DoNotOptimize(advice.best);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_AdvisorQuery);
+
+// Policy of the whole game (a 400 MB file) and the values it was built
+// from, written on first use and removed at exit
+class WholeGamePolicy {
+public:
+    static const WholeGamePolicy &Get() {
+        static const WholeGamePolicy files;
+        return files;
+    }
+
+    ~WholeGamePolicy() {
+        std::remove(GetPolicyPath(STRATEGY_PATH).c_str());
+        std::remove(STRATEGY_PATH);
+    }
+
+    const StrategyTable &GetStrategy() const { return strategy_; }
+    const PolicyTable &GetPolicy() const { return policy_; }
+
+private:
+    static constexpr const char *STRATEGY_PATH = "bench_policy_values.bin";
+
+    WholeGamePolicy() : strategy_(WriteValues()), policy_(WritePolicy(strategy_)) {}
+
+    static std::string WriteValues() {
+        const std::vector<double> &values = SolvedTable().GetValues();
+        WriteStrategyFile(STRATEGY_PATH, values.data(), values.size(), RuleVariant::Yahtzee,
+                          TableLayout::ShortStateKeyReachable);
+        return STRATEGY_PATH;
+    }
+
+    static std::string WritePolicy(const StrategyTable &strategy) {
+        WritePolicyFile(GetPolicyPath(STRATEGY_PATH), BuildPolicy(strategy.GetValues(), strategy.GetLayout()),
+                        strategy.GetLayout());
+        return GetPolicyPath(STRATEGY_PATH);
+    }
+
+    StrategyTable strategy_;
+    PolicyTable policy_;
+};
+
+// Best moves of the same states from the policy of the whole game
+static void BM_PolicyLookup(benchmark::State &state) {
+    const WholeGamePolicy &files = WholeGamePolicy::Get();
+    Advisor advisor(files.GetStrategy().GetValues(), files.GetStrategy().GetLayout(), &files.GetPolicy());
+    auto states = SampleGameStates(256);
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(advisor.GetBestMove(states[i++ % states.size()]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PolicyLookup);
+
+// Search of the rest of the turn with table leaves, starting from an empty transposition table
+static void BM_ExpectimaxOneTurn(benchmark::State &state) {
+    ExpectedScoreObjective objective(SolvedTable().GetValues().data());
+    ExpectimaxSearch search(objective, 16);
+    auto states = SampleGameStates(64);
+    size_t i = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        search.ClearTable();
+        state.ResumeTiming();
+        SearchResult result = search.Search(states[i++ % states.size()], 1);
+        benchmark::DoNotOptimize(result.best);
+    }
+}
+BENCHMARK(BM_ExpectimaxOneTurn)->Unit(benchmark::kMillisecond);
+
+// First query of a game with a cold cache, state.range(0) categories filled
+static void BM_LazyColdQuery(benchmark::State &state) {
+    auto states = SampleGameStates(16, static_cast<size_t>(state.range(0)));
+    size_t i = 0;
+    for (auto _ : state) {
+        LazySolver lazy;
+        benchmark::DoNotOptimize(lazy.GetStateValue(ShortGameState(states[i++ % states.size()])));
+    }
+}
+BENCHMARK(BM_LazyColdQuery)->Arg(6)->Arg(9)->Unit(benchmark::kMillisecond);
+
+// Two-player endgame from a mid-game sheet with state.range(0) categories
+// open for both players, on all hardware threads
+static void BM_DuelEndgame(benchmark::State &state) {
+    const size_t open = static_cast<size_t>(state.range(0));
+    const ShortStateKey key = ShortGameState(SampleGameStates(1, NUM_CATEGORIES - open)[0]).GetKey();
+    size_t pairs = 0;
+    for (auto _ : state) {
+        DuelSolver duel(key, key);
+        duel.Solve();
+        pairs = 0;
+        for (const LayerStats &layer : duel.GetLayerStats()) {
+            pairs += layer.num_states;
+        }
+    }
+    state.counters["pairs"] = static_cast<double>(pairs);
+    state.counters["pairs/s"] =
+        benchmark::Counter(static_cast<double>(pairs), benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(BM_DuelEndgame)->Arg(2)->Arg(3)->Unit(benchmark::kMillisecond);
+
+// Log of optimal games with a random move now and then, graded on all
+// hardware threads; state.range(0) == 1 takes the best moves from the policy
+static void BM_AnalyzeLog(benchmark::State &state) {
+    const double *values = SolvedTable().GetValues().data();
+    static const std::string log = [values] {
+        std::mt19937 rng(11);
+        Advisor advisor(values);
+        Advice advice;
+        std::string text;
+        for (size_t game = 0; game < 2000; ++game) {
+            GameState game_state;
+            for (size_t turn = 0; turn < NUM_CATEGORIES; ++turn) {
+                game_state.SetRemainingRerolls(2);
+                DiceCounts counts{};
+                while (true) {
+                    const size_t kept = std::accumulate(counts.begin(), counts.end(), size_t{0});
+                    for (size_t die = kept; die < NUM_DICE; ++die) {
+                        ++counts[rng() % NUM_FACES];
+                    }
+                    game_state.SetCurrentDice(Dice::from_roll_index(ToRollIndex(counts)));
+                    advisor.Advise(game_state, advice);
+                    const CompactMove move = advice.moves[rng() % 8 == 0 ? rng() % advice.moves.size() : advice.best];
+                    AppendLogDecision(text, std::to_string(game), game % 2 ? "alice" : "bob",
+                                      game_state.GetCurrentDice(), move);
+                    MakeMove(game_state, move);
+                    if (!move.IsReroll()) {
+                        break;
+                    }
+                    counts = KEEP_TABLE.counts[move.GetKeepIndex()];
+                }
+            }
+        }
+        return text;
+    }();
+    std::unique_ptr<LogAnalyzer> analyzer;
+    if (state.range(0) == 1) {
+        const WholeGamePolicy &files = WholeGamePolicy::Get();
+        analyzer = std::make_unique<LogAnalyzer>(files.GetStrategy().GetValues(), files.GetStrategy().GetLayout(), 0,
+                                                 &files.GetPolicy());
+    } else {
+        analyzer = std::make_unique<LogAnalyzer>(values);
+    }
+    uint64_t decisions = 0;
+    for (auto _ : state) {
+        decisions = analyzer->Analyze(log).decisions;
+    }
+    state.counters["decisions/s"] =
+        benchmark::Counter(static_cast<double>(decisions), benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(BM_AnalyzeLog)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
+// Random state lookups in each quantized encoding of the solved table
+static void BM_QuantizedLookup(benchmark::State &state) {
+    const ElementType element_type = static_cast<ElementType>(state.range(0));
+    const std::vector<double> &values = SolvedTable().GetValues();
+    const std::vector<unsigned char> data = EncodeQuantizedValues(values.data(), values.size(), element_type);
+    const QuantizedTable table(data.data(), data.size(), element_type, values.size());
+    std::mt19937 rng(5);
+    double sum = 0.0;
+    for (auto _ : state) {
+        sum += table.GetValue(rng() % values.size());
+    }
+    benchmark::DoNotOptimize(sum);
+    state.counters["bytes/value"] = static_cast<double>(data.size()) / values.size();
+}
+BENCHMARK(BM_QuantizedLookup)
+    ->Arg(static_cast<int>(ElementType::Fixed16))
+    ->Arg(static_cast<int>(ElementType::Float16))
+    ->Arg(static_cast<int>(ElementType::DeltaRice));
+
+// BM_AdvisorQuery reading the values straight from each quantized encoding
+static void BM_QuantizedAdvisorQuery(benchmark::State &state) {
+    const ElementType element_type = static_cast<ElementType>(state.range(0));
+    const std::vector<double> &values = SolvedTable().GetValues();
+    const std::vector<unsigned char> data = EncodeQuantizedValues(values.data(), values.size(), element_type);
+    const QuantizedTable table(data.data(), data.size(), element_type, values.size());
+    Advisor advisor(table);
+    auto states = SampleGameStates(256);
+    Advice advice;
+    size_t i = 0;
+    for (auto _ : state) {
+        advisor.Advise(states[i++ % states.size()], advice);
+        benchmark::DoNotOptimize(advice.best);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_QuantizedAdvisorQuery)
+    ->Arg(static_cast<int>(ElementType::Fixed16))
+    ->Arg(static_cast<int>(ElementType::Float16))
+    ->Arg(static_cast<int>(ElementType::DeltaRice));
+
+static void BM_SimulateGreedyGames(benchmark::State &state) {
+    Simulator simulator([] { return std::make_unique<GreedyPolicy>(); }, 1);
+    uint64_t seed = 0;
+    for (auto _ : state) {
+        SimulationStats stats = simulator.Run(GameState(), 1000, seed++);
+        benchmark::DoNotOptimize(stats.num_games);
+    }
+    state.SetItemsProcessed(state.iterations() * 1000);
+}
+BENCHMARK(BM_SimulateGreedyGames)->Unit(benchmark::kMillisecond);
+
+static void BM_SimulateOptimalGames(benchmark::State &state) {
+    const double *values = SolvedTable().GetValues().data();
+    Simulator simulator([values] { return std::make_unique<OptimalPolicy>(values); }, 1);
+    uint64_t seed = 0;
+    for (auto _ : state) {
+        SimulationStats stats = simulator.Run(GameState(), 100, seed++);
+        benchmark::DoNotOptimize(stats.num_games);
+    }
+    state.SetItemsProcessed(state.iterations() * 100);
+}
+BENCHMARK(BM_SimulateOptimalGames)->Unit(benchmark::kMillisecond);
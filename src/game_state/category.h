@@ -20,6 +20,14 @@ enum class Category : size_t {
 };
 
 constexpr size_t NUM_CATEGORIES = 13;
+constexpr size_t NUM_UPPER_CATEGORIES = 6;
+
+// Upper section bonus: UPPER_BONUS points once the upper total reaches the threshold
+constexpr size_t UPPER_BONUS_THRESHOLD = 63;
+constexpr size_t UPPER_BONUS = 35;
+
+// Extra points for a yahtzee scored in a yahtzee box that already holds one
+constexpr size_t YAHTZEE_BONUS = 100;
 
 // Function to convert Category enum to string
 inline const char* CategoryToString(Category category) {
@@ -39,4 +47,94 @@ inline const char* CategoryToString(Category category) {
         case Category::Chance: return "Chance";
         default: return "Unknown Category";
     }
-}
\ No newline at end of file
+}
+
+// Categories of Scandinavian Yatzy, see YatzyRules
+enum class YatzyCategory : size_t {
+    Ones = 0,
+    Twos = 1,
+    Threes = 2,
+    Fours = 3,
+    Fives = 4,
+    Sixes = 5,
+    OnePair = 6,
+    TwoPairs = 7,
+    ThreeOfAKind = 8,
+    FourOfAKind = 9,
+    SmallStraight = 10,
+    LargeStraight = 11,
+    FullHouse = 12,
+    Chance = 13,
+    Yatzy = 14
+};
+
+inline const char* CategoryToString(YatzyCategory category) {
+    switch (category) {
+        case YatzyCategory::Ones: return "Ones";
+        case YatzyCategory::Twos: return "Twos";
+        case YatzyCategory::Threes: return "Threes";
+        case YatzyCategory::Fours: return "Fours";
+        case YatzyCategory::Fives: return "Fives";
+        case YatzyCategory::Sixes: return "Sixes";
+        case YatzyCategory::OnePair: return "One Pair";
+        case YatzyCategory::TwoPairs: return "Two Pairs";
+        case YatzyCategory::ThreeOfAKind: return "Three of a Kind";
+        case YatzyCategory::FourOfAKind: return "Four of a Kind";
+        case YatzyCategory::SmallStraight: return "Small Straight";
+        case YatzyCategory::LargeStraight: return "Large Straight";
+        case YatzyCategory::FullHouse: return "Full House";
+        case YatzyCategory::Chance: return "Chance";
+        case YatzyCategory::Yatzy: return "Yatzy";
+        default: return "Unknown Category";
+    }
+}
+
+// Categories of Maxi Yatzy, see MaxiYatzyNoSavedRerollsRules
+enum class MaxiYatzyCategory : size_t {
+    Ones = 0,
+    Twos = 1,
+    Threes = 2,
+    Fours = 3,
+    Fives = 4,
+    Sixes = 5,
+    OnePair = 6,
+    TwoPairs = 7,
+    ThreePairs = 8,
+    ThreeOfAKind = 9,
+    FourOfAKind = 10,
+    FiveOfAKind = 11,
+    SmallStraight = 12,
+    LargeStraight = 13,
+    FullStraight = 14,
+    FullHouse = 15,
+    Villa = 16,
+    Tower = 17,
+    Chance = 18,
+    MaxiYatzy = 19
+};
+
+inline const char* CategoryToString(MaxiYatzyCategory category) {
+    switch (category) {
+        case MaxiYatzyCategory::Ones: return "Ones";
+        case MaxiYatzyCategory::Twos: return "Twos";
+        case MaxiYatzyCategory::Threes: return "Threes";
+        case MaxiYatzyCategory::Fours: return "Fours";
+        case MaxiYatzyCategory::Fives: return "Fives";
+        case MaxiYatzyCategory::Sixes: return "Sixes";
+        case MaxiYatzyCategory::OnePair: return "One Pair";
+        case MaxiYatzyCategory::TwoPairs: return "Two Pairs";
+        case MaxiYatzyCategory::ThreePairs: return "Three Pairs";
+        case MaxiYatzyCategory::ThreeOfAKind: return "Three of a Kind";
+        case MaxiYatzyCategory::FourOfAKind: return "Four of a Kind";
+        case MaxiYatzyCategory::FiveOfAKind: return "Five of a Kind";
+        case MaxiYatzyCategory::SmallStraight: return "Small Straight";
+        case MaxiYatzyCategory::LargeStraight: return "Large Straight";
+        case MaxiYatzyCategory::FullStraight: return "Full Straight";
+        case MaxiYatzyCategory::FullHouse: return "Full House";
+        case MaxiYatzyCategory::Villa: return "Villa";
+        case MaxiYatzyCategory::Tower: return "Tower";
+        case MaxiYatzyCategory::Chance: return "Chance";
+        case MaxiYatzyCategory::MaxiYatzy: return "Maxi Yatzy";
+        default: return "Unknown Category";
+    }
+}
@@ -1,51 +1,103 @@
 #include "dice.h"
+#include <cstdint>
 #include <stdexcept>
 #include <numeric>
+#include <string>
 
-Dice::Dice() : counts_{0, 0, 0, 0, 0, 0} {}
+template<typename Shape>
+BasicDice<Shape>::BasicDice() : counts_{} {}
 
-Dice::Dice(const std::vector<size_t>& values) : Dice() {
+template<typename Shape>
+BasicDice<Shape>::BasicDice(const std::vector<size_t>& values) : BasicDice() {
     for (size_t value : values) {
         add_die(value);
     }
 }
 
-Dice::Dice(std::initializer_list<size_t> values) : Dice() {
+template<typename Shape>
+BasicDice<Shape>::BasicDice(std::initializer_list<size_t> values) : BasicDice() {
     for (size_t value : values) {
         add_die(value);
     }
 }
 
-size_t Dice::operator[](size_t value) const {
-    if (value < 1 || value > 6) {
-        throw std::out_of_range("Dice value must be between 1 and 6");
+template<typename Shape>
+size_t BasicDice<Shape>::operator[](size_t value) const {
+    if (value < 1 || value > Shape::NUM_FACES) {
+        throw std::out_of_range("Dice value must be between 1 and " + std::to_string(Shape::NUM_FACES));
     }
     return counts_[value - 1];
 }
 
-size_t Dice::total() const {
-    return std::accumulate(counts_.begin(), counts_.end(), 0);
+template<typename Shape>
+size_t BasicDice<Shape>::total() const {
+    return std::accumulate(counts_.begin(), counts_.end(), size_t{0});
 }
 
-size_t Dice::sum() const {
+template<typename Shape>
+size_t BasicDice<Shape>::sum() const {
     size_t total_sum = 0;
-    for (size_t i = 0; i < 6; ++i) {
+    for (size_t i = 0; i < Shape::NUM_FACES; ++i) {
         total_sum += (i + 1) * counts_[i];
     }
     return total_sum;
 }
 
-void Dice::reset() {
+template<typename Shape>
+void BasicDice<Shape>::reset() {
     counts_.fill(0);
 }
 
-void Dice::add_die(size_t value) {
-    if (value < 1 || value > 6) {
-        throw std::invalid_argument("Dice value must be between 1 and 6");
+template<typename Shape>
+void BasicDice<Shape>::add_die(size_t value) {
+    if (value < 1 || value > Shape::NUM_FACES) {
+        throw std::invalid_argument("Dice value must be between 1 and " + std::to_string(Shape::NUM_FACES));
+    }
+    if (counts_[value - 1] == UINT8_MAX) {
+        throw std::length_error("Too many dice with one value");
     }
     counts_[value - 1]++;
 }
 
-const std::array<size_t, 6>& Dice::counts() const {
+template<typename Shape>
+std::array<size_t, Shape::NUM_FACES> BasicDice<Shape>::counts() const {
+    std::array<size_t, Shape::NUM_FACES> counts{};
+    for (size_t i = 0; i < Shape::NUM_FACES; ++i) {
+        counts[i] = counts_[i];
+    }
+    return counts;
+}
+
+template<typename Shape>
+const typename Shape::Counts& BasicDice<Shape>::raw_counts() const {
     return counts_;
-}
\ No newline at end of file
+}
+
+template<typename Shape>
+BasicDice<Shape> BasicDice<Shape>::from_roll_index(RollIndex index) {
+    if (index >= Shape::NUM_ROLLS) {
+        throw std::out_of_range("Roll index must be below " + std::to_string(Shape::NUM_ROLLS));
+    }
+    BasicDice dice;
+    dice.counts_ = SHAPE_ROLL_TABLE<Shape>.counts[index];
+    return dice;
+}
+
+template<typename Shape>
+typename BasicDice<Shape>::RollIndex BasicDice<Shape>::roll_index() const {
+    if (total() != Shape::NUM_DICE) {
+        throw std::invalid_argument("Roll index needs exactly " + std::to_string(Shape::NUM_DICE) + " dice");
+    }
+    return static_cast<RollIndex>(keep_index() - SHAPE_KEEP_OFFSETS<Shape>[Shape::NUM_DICE]);
+}
+
+template<typename Shape>
+typename BasicDice<Shape>::KeepIndex BasicDice<Shape>::keep_index() const {
+    if (total() > Shape::NUM_DICE) {
+        throw std::invalid_argument("Keep index needs at most " + std::to_string(Shape::NUM_DICE) + " dice");
+    }
+    return ToKeepIndex<Shape>(counts_);
+}
+
+template class BasicDice<FiveDice>;
+template class BasicDice<SixDice>;
@@ -1,24 +1,33 @@
 #pragma once
 
+#include "dice_index.h"
+
 #include <array>
 #include <vector>
 #include <cstddef>
 
-class Dice {
+// Кости формы Shape из dice_index.h: Shape::NUM_DICE костей с гранями 1-Shape::NUM_FACES.
+// Dice - пять шестигранных костей, на них играют все правила, кроме Maxi Yatzy.
+template<typename Shape>
+class BasicDice {
+public:
+    using RollIndex = typename Shape::RollIndex;
+    using KeepIndex = typename Shape::KeepIndex;
+
 private:
-    std::array<size_t, 6> counts_; // Количество выпавших костей с значениями 1-6
+    typename Shape::Counts counts_; // Количество выпавших костей с каждым значением, по байту на грань
 
 public:
     // Конструктор по умолчанию (все нули)
-    Dice();
+    BasicDice();
     
     // Конструктор из вектора выпавших значений
-    Dice(const std::vector<size_t>& values);
+    BasicDice(const std::vector<size_t>& values);
     
     // Конструктор из списка инициализации
-    Dice(std::initializer_list<size_t> values);
+    BasicDice(std::initializer_list<size_t> values);
     
-    // Получить количество костей с определенным значением (1-6)
+    // Получить количество костей с определенным значением (1-Shape::NUM_FACES)
     size_t operator[](size_t value) const;
     
     // Получить общее количество костей
@@ -34,5 +43,21 @@ public:
     void add_die(size_t value);
     
     // Получить массив счетчиков
-    const std::array<size_t, 6>& counts() const;
-};
\ No newline at end of file
+    std::array<size_t, Shape::NUM_FACES> counts() const;
+
+    // Счетчики в том виде, в каком они хранятся, по байту на грань, как в таблицах dice_index.h
+    const typename Shape::Counts& raw_counts() const;
+
+    // Кости по индексу броска из dice_index.h
+    static BasicDice from_roll_index(RollIndex index);
+
+    // Индекс броска, костей должно быть ровно Shape::NUM_DICE
+    RollIndex roll_index() const;
+
+    // Индекс набора из 0-Shape::NUM_DICE отложенных костей
+    KeepIndex keep_index() const;
+};
+
+using Dice = BasicDice<FiveDice>;
+
+static_assert(sizeof(Dice) == NUM_FACES, "Dice must stay a byte per face");
@@ -0,0 +1,389 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+// Enumeration of dice multisets with compile-time lookup tables.
+//
+// Every multiset of five dice (a roll) has a RollIndex in [0, NUM_ROLLS) and
+// every multiset of zero to five dice (dice kept before a reroll) has a
+// KeepIndex in [0, NUM_KEEPS). Keeps are ordered by size and then the same
+// way as rolls, so the keep of all five dice is KEEP_OFFSETS[NUM_DICE] + roll.
+//
+// The enumeration is the same for any number of dice and faces. A DiceShape
+// fixes both, and the SHAPE_* tables and the functions with a Shape
+// parameter are built for it. The plain names belong to FiveDice, the dice of
+// every rule set but Maxi Yatzy, which plays SixDice.
+
+namespace dice_index_detail {
+
+constexpr size_t Binomial(size_t n, size_t k) {
+    if (k > n) {
+        return 0;
+    }
+    size_t result = 1;
+    for (size_t i = 1; i <= k; ++i) {
+        result = result * (n - k + i) / i;
+    }
+    return result;
+}
+
+// Number of multisets of n dice over the given number of faces
+constexpr size_t NumMultisets(size_t n, size_t faces) {
+    return faces == 0 ? (n == 0 ? 1 : 0) : Binomial(n + faces - 1, faces - 1);
+}
+
+constexpr size_t Factorial(size_t n) {
+    return n <= 1 ? 1 : n * Factorial(n - 1);
+}
+
+}  // namespace dice_index_detail
+
+template<size_t NumDice, size_t NumFaces>
+struct DiceShape {
+    static constexpr size_t NUM_DICE = NumDice;
+    static constexpr size_t NUM_FACES = NumFaces;
+    static constexpr size_t NUM_ROLLS = dice_index_detail::NumMultisets(NumDice, NumFaces);
+    // Up to NumDice dice are NumDice dice with an extra blank face
+    static constexpr size_t NUM_KEEPS = dice_index_detail::NumMultisets(NumDice, NumFaces + 1);
+
+    // A byte per roll while the rolls fit one
+    using RollIndex = std::conditional_t<NUM_ROLLS <= 256, uint8_t, uint16_t>;
+    using KeepIndex = uint16_t;
+    using Counts = std::array<uint8_t, NumFaces>;
+
+    static_assert(NUM_KEEPS < 65536, "Keeps must fit a KeepIndex");
+};
+
+using FiveDice = DiceShape<5, 6>;
+using SixDice = DiceShape<6, 6>;
+
+constexpr size_t NUM_DICE = FiveDice::NUM_DICE;
+constexpr size_t NUM_FACES = FiveDice::NUM_FACES;
+constexpr size_t NUM_ROLLS = FiveDice::NUM_ROLLS;
+constexpr size_t NUM_KEEPS = FiveDice::NUM_KEEPS;
+
+using RollIndex = FiveDice::RollIndex;
+using KeepIndex = FiveDice::KeepIndex;
+using DiceCounts = FiveDice::Counts;
+
+static_assert(NUM_ROLLS == 252 && NUM_KEEPS == 462, "Wrong number of rolls or keeps");
+static_assert(SixDice::NUM_ROLLS == 462 && SixDice::NUM_KEEPS == 924, "Wrong number of six-dice rolls or keeps");
+
+namespace dice_index_detail {
+
+// RANK_OFFSETS[face][remaining][count]: multisets that come before the ones
+// with `count` dice on `face` when `remaining` dice are left for this face and
+// the ones after it. Counts are enumerated from high to low. A plain array,
+// which GCC indexes much faster than nested std::arrays when building the
+// tables at compile time.
+template<typename Shape>
+struct RankOffsets {
+    uint16_t values[Shape::NUM_FACES][Shape::NUM_DICE + 1][Shape::NUM_DICE + 1]{};
+};
+
+template<typename Shape>
+constexpr RankOffsets<Shape> BuildRankOffsets() {
+    RankOffsets<Shape> offsets{};
+    for (size_t face = 0; face < Shape::NUM_FACES; ++face) {
+        for (size_t remaining = 0; remaining <= Shape::NUM_DICE; ++remaining) {
+            for (size_t count = 0; count <= remaining; ++count) {
+                size_t before = 0;
+                for (size_t larger = count + 1; larger <= remaining; ++larger) {
+                    before += NumMultisets(remaining - larger, Shape::NUM_FACES - face - 1);
+                }
+                offsets.values[face][remaining][count] = static_cast<uint16_t>(before);
+            }
+        }
+    }
+    return offsets;
+}
+
+template<typename Shape>
+inline constexpr RankOffsets<Shape> RANK_OFFSETS = BuildRankOffsets<Shape>();
+
+template<typename Shape>
+constexpr std::array<uint16_t, Shape::NUM_DICE + 2> BuildKeepOffsets() {
+    std::array<uint16_t, Shape::NUM_DICE + 2> offsets{};
+    for (size_t n = 0; n <= Shape::NUM_DICE; ++n) {
+        offsets[n + 1] = static_cast<uint16_t>(offsets[n] + NumMultisets(n, Shape::NUM_FACES));
+    }
+    return offsets;
+}
+
+}  // namespace dice_index_detail
+
+// SHAPE_KEEP_OFFSETS<Shape>[n]: index of the first keep with n dice
+template<typename Shape>
+inline constexpr std::array<typename Shape::KeepIndex, Shape::NUM_DICE + 2> SHAPE_KEEP_OFFSETS =
+    dice_index_detail::BuildKeepOffsets<Shape>();
+
+inline constexpr const std::array<KeepIndex, NUM_DICE + 2> &KEEP_OFFSETS = SHAPE_KEEP_OFFSETS<FiveDice>;
+
+static_assert(SHAPE_KEEP_OFFSETS<SixDice>[SixDice::NUM_DICE + 1] == SixDice::NUM_KEEPS, "Wrong number of keeps");
+static_assert(KEEP_OFFSETS[NUM_DICE + 1] == NUM_KEEPS, "Wrong number of keeps");
+
+// Position of the multiset among the multisets with the same number of dice
+template<typename Shape = FiveDice>
+constexpr size_t MultisetRank(typename Shape::Counts counts) {
+    size_t remaining = 0;
+    for (uint8_t count : counts) {
+        remaining += count;
+    }
+    size_t rank = 0;
+    for (size_t face = 0; face + 1 < Shape::NUM_FACES; ++face) {
+        rank += dice_index_detail::RANK_OFFSETS<Shape>.values[face][remaining][counts[face]];
+        remaining -= counts[face];
+    }
+    return rank;
+}
+
+// Counts must hold exactly Shape::NUM_DICE dice
+template<typename Shape = FiveDice>
+constexpr typename Shape::RollIndex ToRollIndex(typename Shape::Counts counts) {
+    return static_cast<typename Shape::RollIndex>(MultisetRank<Shape>(counts));
+}
+
+// Counts must hold at most Shape::NUM_DICE dice
+template<typename Shape = FiveDice>
+constexpr typename Shape::KeepIndex ToKeepIndex(typename Shape::Counts counts) {
+    size_t n = 0;
+    for (uint8_t count : counts) {
+        n += count;
+    }
+    return static_cast<typename Shape::KeepIndex>(SHAPE_KEEP_OFFSETS<Shape>[n] + MultisetRank<Shape>(counts));
+}
+
+// Properties of every roll
+template<typename Shape>
+struct BasicRollTable {
+    static constexpr size_t SIZE = Shape::NUM_ROLLS;
+
+    std::array<typename Shape::Counts, SIZE> counts{};
+    std::array<uint8_t, SIZE> sum{};
+    std::array<uint8_t, SIZE> max_count{};          // most dice showing one face
+    std::array<uint8_t, SIZE> yahtzee_face{};       // face of a roll of all equal dice, 0 otherwise
+    std::array<bool, SIZE> is_yahtzee{};
+    std::array<bool, SIZE> is_full_house{};         // a face three times and one twice
+    std::array<bool, SIZE> is_small_straight{};     // four sequential faces
+    std::array<bool, SIZE> is_large_straight{};     // five sequential faces
+    std::array<uint16_t, SIZE> permutations{};      // ordered rolls giving this multiset
+    std::array<double, SIZE> probability{};         // probability of rolling it with all dice
+};
+
+// Properties of every keep
+template<typename Shape>
+struct BasicKeepTable {
+    std::array<typename Shape::Counts, Shape::NUM_KEEPS> counts{};
+    std::array<uint8_t, Shape::NUM_KEEPS> size{};
+    std::array<double, Shape::NUM_KEEPS> probability{};  // probability of rolling it with `size` dice
+};
+
+using RollTable = BasicRollTable<FiveDice>;
+using KeepTable = BasicKeepTable<FiveDice>;
+
+namespace dice_index_detail {
+
+// Enumerates multisets of n dice from high to low counts, matching MultisetRank
+template<typename Shape, typename Visitor>
+constexpr void ForEachMultiset(size_t n, Visitor &&visit) {
+    typename Shape::Counts counts{};
+    counts[0] = static_cast<uint8_t>(n);
+    while (true) {
+        visit(counts);
+        // Move one die from the last non-empty face before the tail one step right
+        size_t face = Shape::NUM_FACES - 1;
+        size_t tail = counts[face];
+        counts[face] = 0;
+        while (face > 0 && counts[face - 1] == 0) {
+            --face;
+        }
+        if (face == 0) {
+            return;
+        }
+        --counts[face - 1];
+        counts[face] = static_cast<uint8_t>(tail + 1);
+    }
+}
+
+// Ordered rolls of n dice giving the multiset
+template<typename Shape>
+constexpr size_t Permutations(const typename Shape::Counts &counts) {
+    size_t n = 0;
+    size_t divisor = 1;
+    for (uint8_t count : counts) {
+        n += count;
+        divisor *= Factorial(count);
+    }
+    return Factorial(n) / divisor;
+}
+
+template<typename Shape>
+constexpr double OrderedRolls(size_t n) {
+    double rolls = 1.0;
+    for (size_t die = 0; die < n; ++die) {
+        rolls *= static_cast<double>(Shape::NUM_FACES);
+    }
+    return rolls;
+}
+
+template<typename Shape>
+constexpr BasicRollTable<Shape> BuildRollTable() {
+    BasicRollTable<Shape> table{};
+    size_t index = 0;
+    ForEachMultiset<Shape>(Shape::NUM_DICE, [&](const typename Shape::Counts &counts) {
+        table.counts[index] = counts;
+        size_t sum = 0;
+        uint8_t max_count = 0;
+        bool has_three = false;
+        bool has_two = false;
+        size_t run = 0;
+        size_t longest_run = 0;
+        for (size_t face = 0; face < Shape::NUM_FACES; ++face) {
+            sum += (face + 1) * counts[face];
+            max_count = counts[face] > max_count ? counts[face] : max_count;
+            has_three = has_three || counts[face] == 3;
+            has_two = has_two || counts[face] == 2;
+            run = counts[face] > 0 ? run + 1 : 0;
+            longest_run = run > longest_run ? run : longest_run;
+            if (counts[face] == Shape::NUM_DICE) {
+                table.yahtzee_face[index] = static_cast<uint8_t>(face + 1);
+            }
+        }
+        const size_t permutations = Permutations<Shape>(counts);
+        table.sum[index] = static_cast<uint8_t>(sum);
+        table.max_count[index] = max_count;
+        table.is_yahtzee[index] = max_count == Shape::NUM_DICE;
+        table.is_full_house[index] = has_three && has_two;
+        table.is_small_straight[index] = longest_run >= 4;
+        table.is_large_straight[index] = longest_run >= 5;
+        table.permutations[index] = static_cast<uint16_t>(permutations);
+        table.probability[index] = static_cast<double>(permutations) / OrderedRolls<Shape>(Shape::NUM_DICE);
+        ++index;
+    });
+    return table;
+}
+
+template<typename Shape>
+constexpr BasicKeepTable<Shape> BuildKeepTable() {
+    BasicKeepTable<Shape> table{};
+    size_t index = 0;
+    for (size_t n = 0; n <= Shape::NUM_DICE; ++n) {
+        ForEachMultiset<Shape>(n, [&](const typename Shape::Counts &counts) {
+            table.counts[index] = counts;
+            table.size[index] = static_cast<uint8_t>(n);
+            table.probability[index] = static_cast<double>(Permutations<Shape>(counts)) / OrderedRolls<Shape>(n);
+            ++index;
+        });
+    }
+    return table;
+}
+
+// Sub-multisets of all keeps together
+template<typename Shape>
+constexpr size_t CountSubKeeps() {
+    size_t entries = 0;
+    for (size_t n = 0; n <= Shape::NUM_DICE; ++n) {
+        ForEachMultiset<Shape>(n, [&](const typename Shape::Counts &counts) {
+            size_t subs = 1;
+            for (uint8_t count : counts) {
+                subs *= count + 1;
+            }
+            entries += subs;
+        });
+    }
+    return entries;
+}
+
+}  // namespace dice_index_detail
+
+template<typename Shape>
+inline constexpr BasicRollTable<Shape> SHAPE_ROLL_TABLE = dice_index_detail::BuildRollTable<Shape>();
+template<typename Shape>
+inline constexpr BasicKeepTable<Shape> SHAPE_KEEP_TABLE = dice_index_detail::BuildKeepTable<Shape>();
+
+inline constexpr const RollTable &ROLL_TABLE = SHAPE_ROLL_TABLE<FiveDice>;
+inline constexpr const KeepTable &KEEP_TABLE = SHAPE_KEEP_TABLE<FiveDice>;
+
+// Every distinct sub-multiset of each keep, in increasing KeepIndex order.
+// For a roll these are all the different sets of dice that can be kept.
+template<typename Shape>
+class BasicSubKeepTable {
+public:
+    using KeepIndex = typename Shape::KeepIndex;
+
+    static constexpr size_t NUM_ENTRIES = dice_index_detail::CountSubKeeps<Shape>();
+    static constexpr size_t MAX_SUB_KEEPS = size_t{1} << Shape::NUM_DICE;
+
+    static_assert(NUM_ENTRIES < 65536, "Entries must fit the row offsets");
+
+    constexpr BasicSubKeepTable() {
+        constexpr size_t faces = Shape::NUM_FACES;
+        size_t entry = 0;
+        for (size_t keep = 0; keep < Shape::NUM_KEEPS; ++keep) {
+            offsets_[keep] = static_cast<uint16_t>(entry);
+            const typename Shape::Counts counts = SHAPE_KEEP_TABLE<Shape>.counts[keep];
+            // By size and then in MultisetRank order is increasing KeepIndex order
+            for (size_t n = 0; n <= SHAPE_KEEP_TABLE<Shape>.size[keep]; ++n) {
+                // Rank order puts as many dice as fit on the low faces first
+                typename Shape::Counts sub{};
+                size_t rest = n;
+                for (size_t face = 0; face < faces; ++face) {
+                    sub[face] = static_cast<uint8_t>(rest < counts[face] ? rest : counts[face]);
+                    rest -= sub[face];
+                }
+                while (true) {
+                    keeps_[entry++] = ToKeepIndex<Shape>(sub);
+                    // Take a die off the last face whose higher faces have room for it, refill them low first
+                    size_t face = faces - 1;
+                    size_t tail = sub[face];
+                    size_t room = counts[face] - sub[face];
+                    while (face > 0 && (sub[face - 1] == 0 || room == 0)) {
+                        --face;
+                        tail += sub[face];
+                        room += counts[face] - sub[face];
+                    }
+                    if (face == 0) {
+                        break;
+                    }
+                    --sub[face - 1];
+                    ++tail;
+                    for (; face < faces; ++face) {
+                        sub[face] = static_cast<uint8_t>(tail < counts[face] ? tail : counts[face]);
+                        tail -= sub[face];
+                    }
+                }
+            }
+        }
+        offsets_[Shape::NUM_KEEPS] = static_cast<uint16_t>(entry);
+    }
+
+    struct Row {
+        const KeepIndex *first;
+        const KeepIndex *last;
+
+        constexpr const KeepIndex *begin() const { return first; }
+        constexpr const KeepIndex *end() const { return last; }
+        constexpr size_t size() const { return static_cast<size_t>(last - first); }
+    };
+
+    constexpr Row GetRow(KeepIndex keep) const {
+        return Row{keeps_.data() + offsets_[keep], keeps_.data() + offsets_[keep + 1]};
+    }
+
+private:
+    std::array<uint16_t, Shape::NUM_KEEPS + 1> offsets_{};
+    std::array<KeepIndex, NUM_ENTRIES> keeps_{};
+};
+
+using SubKeepTable = BasicSubKeepTable<FiveDice>;
+
+template<typename Shape>
+inline constexpr BasicSubKeepTable<Shape> SHAPE_SUB_KEEP_TABLE{};
+
+inline constexpr const SubKeepTable &SUB_KEEP_TABLE = SHAPE_SUB_KEEP_TABLE<FiveDice>;
+
+static_assert(SubKeepTable::NUM_ENTRIES == 6188, "Wrong number of sub-keeps");
+static_assert(SUB_KEEP_TABLE.GetRow(NUM_KEEPS - 1).size() == 6, "Five equal dice have six sub-keeps");
@@ -5,12 +5,12 @@
 
 
 std::optional<size_t> GameState::GetCategoryScore(Category category) const {
-    return categories_score_.at(static_cast<size_t>(category));
+    return sheet_.GetCategoryScore(category);
 }
 
 void GameState::AddScoreToCategory(Category category, size_t score)
 {
-    categories_score_[static_cast<size_t>(category)] = categories_score_.at(static_cast<size_t>(category)).value_or(0) + score;
+    sheet_.AddScore(category, score);
 }
 
 size_t GameState::GetRemainingRerolls() const
@@ -24,7 +24,7 @@ void GameState::SetRemainingRerolls(size_t count)
     {
         throw std::out_of_range("Rerolls cannot exceed 3");
     }
-    rerolls_left_ = count;
+    rerolls_left_ = static_cast<uint8_t>(count);
 }
 
 const Dice &GameState::GetCurrentDice() const
@@ -39,19 +39,45 @@ void GameState::SetCurrentDice(const Dice &dice)
 
 size_t GameState::GetRemainingUpperBonus() const
 {
-    size_t upper_score = 0;
-    for (size_t i = 0; i < 6; ++i)
-    {
-        if (categories_score_[i].has_value())
-        {
-            upper_score += categories_score_[i].value();
-        }
-    }
-    return upper_score >= 63 ? 0 : 63 - upper_score;
+    return sheet_.GetRemainingUpperBonus();
 }
 
 bool GameState::IsYahtzeeRecorded() const
 {
-    constexpr size_t yahtzee_category = static_cast<size_t>(Category::Yahtzee);
-    return categories_score_[yahtzee_category].has_value() && categories_score_[yahtzee_category].value() > 0;
-}
\ No newline at end of file
+    return sheet_.GetScore(Category::Yahtzee) > 0;
+}
+
+uint32_t GameState::GetFilledMask() const
+{
+    return sheet_.GetFilledMask();
+}
+
+size_t GameState::GetUpperTotal() const
+{
+    return sheet_.GetUpperTotal();
+}
+
+size_t GameState::GetYahtzeeBonusCount() const
+{
+    return sheet_.GetYahtzeeBonusCount();
+}
+
+size_t GameState::GetTotalScore() const
+{
+    return sheet_.GetTotalScore();
+}
+
+void GameState::AddYahtzeeBonus()
+{
+    sheet_.AddYahtzeeBonus();
+}
+
+const ScoreSheet &GameState::GetSheet() const
+{
+    return sheet_;
+}
+
+void GameState::SetSheet(const ScoreSheet &sheet)
+{
+    sheet_ = sheet;
+}
@@ -2,14 +2,16 @@
 
 #include "category.h"
 #include "dice.h"
+#include "score_sheet.h"
 
+#include <cstdint>
 #include <optional>
 
 class GameState {
 private:
-    std::array<std::optional<size_t>, NUM_CATEGORIES> categories_score_{};
+    ScoreSheet sheet_{};
     Dice dice_{};
-    size_t rerolls_left_{2};
+    uint8_t rerolls_left_{2};
 
 public:
     GameState() = default;
@@ -24,4 +26,16 @@ public:
 
     size_t GetRemainingUpperBonus() const;
     bool IsYahtzeeRecorded() const;
-};
\ No newline at end of file
+
+    // Aggregates kept up to date by AddScoreToCategory and AddYahtzeeBonus
+    uint32_t GetFilledMask() const;
+    size_t GetUpperTotal() const;
+    size_t GetYahtzeeBonusCount() const;
+    size_t GetTotalScore() const;  // upper and yahtzee bonuses included
+    void AddYahtzeeBonus();
+
+    const ScoreSheet &GetSheet() const;
+    void SetSheet(const ScoreSheet &sheet);
+};
+
+static_assert(sizeof(GameState) <= 24, "A game state is the sheet, a byte per face and the rerolls");
\ No newline at end of file
@@ -2,7 +2,10 @@
 
 #include "game_state.h"
 #include "short_game_state.h"
+#include <algorithm>
+#include <random>
 #include <type_traits>
+#include <vector>
 
 // Template function to check if a category is used
 template<typename GameStateType>
@@ -69,3 +72,29 @@ size_t GetYahtzeeValue(const GameStateType& state) {
     }
     return 0;
 }
+
+// Mid-game states with a fresh roll showing, the same for every run
+inline std::vector<GameState> SampleGameStates(size_t count, size_t filled = 6) {
+    std::mt19937 rng(2024);
+    std::vector<GameState> states;
+    for (size_t i = 0; i < count; ++i) {
+        GameState state;
+        std::vector<size_t> categories(NUM_CATEGORIES);
+        for (size_t c = 0; c < NUM_CATEGORIES; ++c) {
+            categories[c] = c;
+        }
+        std::shuffle(categories.begin(), categories.end(), rng);
+        for (size_t c = 0; c < filled; ++c) {
+            Category category = static_cast<Category>(categories[c]);
+            size_t score = static_cast<size_t>(category) < NUM_UPPER_CATEGORIES
+                               ? (rng() % 4) * (static_cast<size_t>(category) + 1)
+                               : rng() % 2 * 25;
+            state.AddScoreToCategory(category, score);
+        }
+        std::uniform_int_distribution<size_t> die(1, 6);
+        state.SetCurrentDice(Dice{die(rng), die(rng), die(rng), die(rng), die(rng)});
+        state.SetRemainingRerolls(rng() % 3);
+        states.push_back(state);
+    }
+    return states;
+}
@@ -0,0 +1,289 @@
+#pragma once
+
+#include "category.h"
+#include "dice_index.h"
+#include "short_state_key.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Rule sets as compile-time policies.
+//
+// A policy fixes the categories, the base score of dice in each of them, the
+// bonuses and the categories a roll may be scored in. Code templated on a
+// policy (score tables, CalculateScore, move generation, BasicTurnEvaluator,
+// BasicSolver) compiles into separate kernels per rule set with the rules as
+// constants, so nothing branches on rule flags at run time. YahtzeeRules is
+// the default parameter everywhere and the rule set GameState plays.
+//
+// Members of a policy:
+//   VARIANT                  id written to strategy files
+//   Shape                    DiceShape of the dice rolled (dice_index.h)
+//   CategoryType             enum of the categories, NUM_CATEGORIES of them, upper ones first
+//   UPPER_BONUS_THRESHOLD    upper total that earns UPPER_BONUS
+//   HAS_JOKER                whether a scored yahtzee is tracked, for the bonus and the joker
+//   YAHTZEE_BONUS            points of every further yahtzee in a yahtzee box holding one
+//   StateKey                 turn-start key of the rule set
+//   Score(counts, c, joker)  base points of the dice in category c, joker scoring if asked
+//   AllowedCategories(open, joker_face)
+//                            categories a roll may take; joker_face is the face of a
+//                            yahtzee rolled with a yahtzee already scored, 0 otherwise
+
+enum class RuleVariant : uint32_t {
+    Yahtzee = 1,                  // rules of yahtzee_rules.md, with the forced joker
+    YahtzeeFreeJoker = 2,         // a joker may take any open category
+    Yatzy = 3,                    // Scandinavian Yatzy
+    MaxiYatzyNoSavedRerolls = 4,  // Maxi Yatzy, six dice, without saved rerolls
+};
+
+namespace rules_detail {
+
+// Counts of any DiceShape
+template<size_t NumFaces>
+using Counts = std::array<uint8_t, NumFaces>;
+
+template<size_t NumFaces>
+constexpr size_t Sum(const Counts<NumFaces> &counts) {
+    size_t sum = 0;
+    for (size_t face = 0; face < NumFaces; ++face) {
+        sum += (face + 1) * counts[face];
+    }
+    return sum;
+}
+
+template<size_t NumFaces>
+constexpr size_t MaxCount(const Counts<NumFaces> &counts) {
+    size_t max_count = 0;
+    for (uint8_t count : counts) {
+        max_count = count > max_count ? count : max_count;
+    }
+    return max_count;
+}
+
+template<size_t NumFaces>
+constexpr bool HasCount(const Counts<NumFaces> &counts, size_t wanted) {
+    for (uint8_t count : counts) {
+        if (count == wanted) {
+            return true;
+        }
+    }
+    return false;
+}
+
+template<size_t NumFaces>
+constexpr size_t LongestRun(const Counts<NumFaces> &counts) {
+    size_t run = 0;
+    size_t longest = 0;
+    for (uint8_t count : counts) {
+        run = count > 0 ? run + 1 : 0;
+        longest = run > longest ? run : longest;
+    }
+    return longest;
+}
+
+// Every face from first to last (1-6) shows
+template<size_t NumFaces>
+constexpr bool HasFaces(const Counts<NumFaces> &counts, size_t first, size_t last) {
+    for (size_t face = first; face <= last; ++face) {
+        if (counts[face - 1] == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Points of the highest faces showing at least `size` dice: `sets` different faces or nothing
+template<size_t NumFaces>
+constexpr size_t BestSets(const Counts<NumFaces> &counts, size_t size, size_t sets) {
+    size_t points = 0;
+    size_t found = 0;
+    for (size_t face = NumFaces; face > 0 && found < sets; --face) {
+        if (counts[face - 1] >= size) {
+            points += face * size;
+            ++found;
+        }
+    }
+    return found == sets ? points : 0;
+}
+
+// Best points of `large` dice of one face and `small` of another, or nothing
+template<size_t NumFaces>
+constexpr size_t BestSplit(const Counts<NumFaces> &counts, size_t large, size_t small) {
+    size_t best = 0;
+    for (size_t first = 1; first <= NumFaces; ++first) {
+        for (size_t second = 1; second <= NumFaces; ++second) {
+            if (first != second && counts[first - 1] >= large && counts[second - 1] >= small) {
+                const size_t points = first * large + second * small;
+                best = points > best ? points : best;
+            }
+        }
+    }
+    return best;
+}
+
+}  // namespace rules_detail
+
+// Fixed scores of the Yahtzee lower section
+constexpr size_t FULL_HOUSE_SCORE = 25;
+constexpr size_t SMALL_STRAIGHT_SCORE = 30;
+constexpr size_t LARGE_STRAIGHT_SCORE = 40;
+constexpr size_t YAHTZEE_SCORE = 50;
+
+// Rules of yahtzee_rules.md: a yahtzee rolled with one already scored earns
+// YAHTZEE_BONUS and is a joker that must take its upper box when open, else
+// any open lower box at full value, else any upper box for nothing
+struct YahtzeeRules {
+    static constexpr RuleVariant VARIANT = RuleVariant::Yahtzee;
+    using Shape = FiveDice;
+    using CategoryType = Category;
+    static constexpr size_t NUM_CATEGORIES = ::NUM_CATEGORIES;
+    static constexpr size_t NUM_UPPER_CATEGORIES = ::NUM_UPPER_CATEGORIES;
+    static constexpr size_t UPPER_BONUS_THRESHOLD = ::UPPER_BONUS_THRESHOLD;
+    static constexpr size_t UPPER_BONUS = ::UPPER_BONUS;
+    static constexpr bool HAS_JOKER = true;
+    static constexpr size_t YAHTZEE_BONUS = ::YAHTZEE_BONUS;
+    static constexpr size_t YAHTZEE_SCORE = ::YAHTZEE_SCORE;
+    static constexpr CategoryType YAHTZEE_CATEGORY = Category::Yahtzee;
+    using StateKey = ShortStateKey;
+
+    static constexpr size_t Score(const Shape::Counts &counts, size_t category, bool joker) {
+        using namespace rules_detail;
+        if (category < NUM_UPPER_CATEGORIES) {
+            return counts[category] * (category + 1);
+        }
+        switch (static_cast<Category>(category)) {
+            case Category::ThreeOfAKind: return MaxCount(counts) >= 3 ? Sum(counts) : 0;
+            case Category::FourOfAKind: return MaxCount(counts) >= 4 ? Sum(counts) : 0;
+            // A yahtzee always counts as a full house
+            case Category::FullHouse: {
+                const bool full_house =
+                    (HasCount(counts, 3) && HasCount(counts, 2)) || HasCount(counts, Shape::NUM_DICE);
+                return full_house ? FULL_HOUSE_SCORE : 0;
+            }
+            case Category::SmallStraight: return LongestRun(counts) >= 4 || joker ? SMALL_STRAIGHT_SCORE : 0;
+            case Category::LargeStraight: return LongestRun(counts) >= 5 || joker ? LARGE_STRAIGHT_SCORE : 0;
+            case Category::Yahtzee: return HasCount(counts, Shape::NUM_DICE) ? YAHTZEE_SCORE : 0;
+            case Category::Chance: return Sum(counts);
+            default: return 0;
+        }
+    }
+
+    static constexpr uint32_t AllowedCategories(uint32_t open_mask, size_t joker_face) {
+        constexpr uint32_t lower_mask =
+            ((uint32_t{1} << NUM_CATEGORIES) - 1) & ~((uint32_t{1} << NUM_UPPER_CATEGORIES) - 1);
+        if (joker_face != 0) {
+            const uint32_t upper_bit = uint32_t{1} << (joker_face - 1);
+            if (open_mask & upper_bit) {
+                return upper_bit;
+            }
+            if (open_mask & lower_mask) {
+                return open_mask & lower_mask;
+            }
+        }
+        return open_mask;
+    }
+};
+
+// Yahtzee with the free-choice joker: the joker scores the same but may take any open box
+struct FreeJokerYahtzeeRules : YahtzeeRules {
+    static constexpr RuleVariant VARIANT = RuleVariant::YahtzeeFreeJoker;
+
+    static constexpr uint32_t AllowedCategories(uint32_t open_mask, size_t) { return open_mask; }
+};
+
+// Scandinavian Yatzy: pairs instead of the Yahtzee lower section, sets score
+// their dice, straights are 1-5 and 2-6, a full house scores its sum, an upper
+// total of 63 earns 50 and there is neither a yatzy bonus nor a joker
+struct YatzyRules {
+    static constexpr RuleVariant VARIANT = RuleVariant::Yatzy;
+    using Shape = FiveDice;
+    using CategoryType = YatzyCategory;
+    static constexpr size_t NUM_CATEGORIES = 15;
+    static constexpr size_t NUM_UPPER_CATEGORIES = 6;
+    static constexpr size_t UPPER_BONUS_THRESHOLD = 63;
+    static constexpr size_t UPPER_BONUS = 50;
+    static constexpr bool HAS_JOKER = false;
+    static constexpr size_t YAHTZEE_BONUS = 0;
+    static constexpr size_t YAHTZEE_SCORE = 50;
+    static constexpr CategoryType YAHTZEE_CATEGORY = YatzyCategory::Yatzy;
+    using StateKey = BasicStateKey<NUM_CATEGORIES, UPPER_BONUS_THRESHOLD, false>;
+
+    static constexpr size_t Score(const Shape::Counts &counts, size_t category, bool) {
+        using namespace rules_detail;
+        if (category < NUM_UPPER_CATEGORIES) {
+            return counts[category] * (category + 1);
+        }
+        switch (static_cast<YatzyCategory>(category)) {
+            case YatzyCategory::OnePair: return BestSets(counts, 2, 1);
+            case YatzyCategory::TwoPairs: return BestSets(counts, 2, 2);
+            case YatzyCategory::ThreeOfAKind: return BestSets(counts, 3, 1);
+            case YatzyCategory::FourOfAKind: return BestSets(counts, 4, 1);
+            case YatzyCategory::SmallStraight: return HasFaces(counts, 1, 5) ? 15 : 0;
+            case YatzyCategory::LargeStraight: return HasFaces(counts, 2, 6) ? 20 : 0;
+            case YatzyCategory::FullHouse:
+                return HasCount(counts, 3) && HasCount(counts, 2) ? Sum(counts) : 0;
+            case YatzyCategory::Chance: return Sum(counts);
+            case YatzyCategory::Yatzy: return HasCount(counts, Shape::NUM_DICE) ? YAHTZEE_SCORE : 0;
+            default: return 0;
+        }
+    }
+
+    static constexpr uint32_t AllowedCategories(uint32_t open_mask, size_t) { return open_mask; }
+};
+
+static_assert(YatzyRules::NUM_CATEGORIES == static_cast<size_t>(YatzyCategory::Yatzy) + 1,
+              "Every Yatzy category needs a bit");
+
+// Maxi Yatzy scoring without its saved rerolls, so not Maxi Yatzy itself:
+// Yatzy with six dice and 20 categories. Three pairs, five of a kind, the full
+// straight 1-6 (21), the villa (two threes of a kind), the tower (four and two
+// of a kind) and a maxi yatzy of 100 are added, sets and houses score their
+// dice, and an upper total of 84 earns 50.
+//
+// In Maxi Yatzy unused rerolls are saved for later turns; here every turn has
+// exactly two. Saving them would add a key field of up to 38 rerolls, a table
+// 39 times the 2^27 values of the key and more than its 32 bits.
+struct MaxiYatzyNoSavedRerollsRules {
+    static constexpr RuleVariant VARIANT = RuleVariant::MaxiYatzyNoSavedRerolls;
+    using Shape = SixDice;
+    using CategoryType = MaxiYatzyCategory;
+    static constexpr size_t NUM_CATEGORIES = 20;
+    static constexpr size_t NUM_UPPER_CATEGORIES = 6;
+    static constexpr size_t UPPER_BONUS_THRESHOLD = 84;
+    static constexpr size_t UPPER_BONUS = 50;
+    static constexpr bool HAS_JOKER = false;
+    static constexpr size_t YAHTZEE_BONUS = 0;
+    static constexpr size_t YAHTZEE_SCORE = 100;
+    static constexpr CategoryType YAHTZEE_CATEGORY = MaxiYatzyCategory::MaxiYatzy;
+    using StateKey = BasicStateKey<NUM_CATEGORIES, UPPER_BONUS_THRESHOLD, false>;
+
+    static constexpr size_t Score(const Shape::Counts &counts, size_t category, bool) {
+        using namespace rules_detail;
+        if (category < NUM_UPPER_CATEGORIES) {
+            return counts[category] * (category + 1);
+        }
+        switch (static_cast<MaxiYatzyCategory>(category)) {
+            case MaxiYatzyCategory::OnePair: return BestSets(counts, 2, 1);
+            case MaxiYatzyCategory::TwoPairs: return BestSets(counts, 2, 2);
+            case MaxiYatzyCategory::ThreePairs: return BestSets(counts, 2, 3);
+            case MaxiYatzyCategory::ThreeOfAKind: return BestSets(counts, 3, 1);
+            case MaxiYatzyCategory::FourOfAKind: return BestSets(counts, 4, 1);
+            case MaxiYatzyCategory::FiveOfAKind: return BestSets(counts, 5, 1);
+            case MaxiYatzyCategory::SmallStraight: return HasFaces(counts, 1, 5) ? 15 : 0;
+            case MaxiYatzyCategory::LargeStraight: return HasFaces(counts, 2, 6) ? 20 : 0;
+            case MaxiYatzyCategory::FullStraight: return HasFaces(counts, 1, 6) ? 21 : 0;
+            case MaxiYatzyCategory::FullHouse: return BestSplit(counts, 3, 2);
+            case MaxiYatzyCategory::Villa: return BestSets(counts, 3, 2);
+            case MaxiYatzyCategory::Tower: return BestSplit(counts, 4, 2);
+            case MaxiYatzyCategory::Chance: return Sum(counts);
+            case MaxiYatzyCategory::MaxiYatzy: return HasCount(counts, Shape::NUM_DICE) ? YAHTZEE_SCORE : 0;
+            default: return 0;
+        }
+    }
+
+    static constexpr uint32_t AllowedCategories(uint32_t open_mask, size_t) { return open_mask; }
+};
+
+static_assert(MaxiYatzyNoSavedRerollsRules::NUM_CATEGORIES == static_cast<size_t>(MaxiYatzyCategory::MaxiYatzy) + 1,
+              "Every Maxi Yatzy category needs a bit");
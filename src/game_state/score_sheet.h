@@ -0,0 +1,145 @@
+#pragma once
+
+#include "category.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+
+// Score sheet packed into two 64-bit words.
+//
+// Every category has a score field and a bit in the filled mask; the upper
+// total, the count of yahtzee bonuses and the grand total (bonuses included)
+// are kept up to date on every change instead of being summed on demand.
+// Categories 10-12 get wider fields so that a yahtzee box scored twice fits.
+//
+// low:  [59..0] 6-bit scores of categories 0-9, [63..60] yahtzee bonus count
+// high: [23..0] 8-bit scores of categories 10-12, [36..24] filled mask,
+//       [45..37] upper total, [57..46] grand total
+class ScoreSheet {
+private:
+    static constexpr uint32_t LOW_SCORE_BITS = 6;
+    static constexpr uint32_t HIGH_SCORE_BITS = 8;
+    static constexpr size_t LOW_CATEGORIES = 10;
+    static constexpr uint32_t BONUS_SHIFT = 60;
+    static constexpr uint32_t MASK_SHIFT = 24;
+    static constexpr uint32_t UPPER_SHIFT = 37;
+    static constexpr uint32_t UPPER_BITS = 9;
+    static constexpr uint32_t TOTAL_SHIFT = 46;
+    static constexpr uint32_t TOTAL_BITS = 12;
+
+    static constexpr uint64_t Field(uint32_t bits) { return (uint64_t{1} << bits) - 1; }
+
+    uint64_t low_{0};
+    uint64_t high_{0};
+
+    constexpr void SetScoreBits(size_t index, uint64_t score) {
+        if (index < LOW_CATEGORIES) {
+            const uint32_t shift = static_cast<uint32_t>(index) * LOW_SCORE_BITS;
+            low_ = (low_ & ~(Field(LOW_SCORE_BITS) << shift)) | (score << shift);
+        } else {
+            const uint32_t shift = static_cast<uint32_t>(index - LOW_CATEGORIES) * HIGH_SCORE_BITS;
+            high_ = (high_ & ~(Field(HIGH_SCORE_BITS) << shift)) | (score << shift);
+        }
+    }
+
+    constexpr void SetUpperTotal(uint64_t total) {
+        high_ = (high_ & ~(Field(UPPER_BITS) << UPPER_SHIFT)) | (total << UPPER_SHIFT);
+    }
+
+    constexpr void AddToTotal(uint64_t points) {
+        high_ += points << TOTAL_SHIFT;
+    }
+
+public:
+    static constexpr size_t MAX_LOW_SCORE = (size_t{1} << LOW_SCORE_BITS) - 1;
+    static constexpr size_t MAX_HIGH_SCORE = (size_t{1} << HIGH_SCORE_BITS) - 1;
+    static constexpr size_t MAX_YAHTZEE_BONUSES = (size_t{1} << (64 - BONUS_SHIFT)) - 1;
+
+    // Highest score a single category can hold
+    static constexpr size_t GetCapacity(Category category) {
+        return static_cast<size_t>(category) < LOW_CATEGORIES ? MAX_LOW_SCORE : MAX_HIGH_SCORE;
+    }
+
+    static_assert(NUM_UPPER_CATEGORIES <= LOW_CATEGORIES, "Upper categories use the low word");
+    static_assert(NUM_UPPER_CATEGORIES * MAX_LOW_SCORE < (size_t{1} << UPPER_BITS), "Upper total must fit");
+    static_assert(LOW_CATEGORIES * MAX_LOW_SCORE + (NUM_CATEGORIES - LOW_CATEGORIES) * MAX_HIGH_SCORE +
+                          UPPER_BONUS + MAX_YAHTZEE_BONUSES * YAHTZEE_BONUS <
+                      (size_t{1} << TOTAL_BITS),
+                  "Grand total must fit");
+    static_assert(TOTAL_SHIFT + TOTAL_BITS <= 64, "High word overflow");
+
+    constexpr ScoreSheet() = default;
+
+    constexpr bool IsFilled(Category category) const {
+        return (GetFilledMask() >> static_cast<uint32_t>(category)) & 1u;
+    }
+
+    // Score of the category without bonuses, 0 while it is open
+    constexpr size_t GetScore(Category category) const {
+        const size_t index = static_cast<size_t>(category);
+        if (index < LOW_CATEGORIES) {
+            return (low_ >> (index * LOW_SCORE_BITS)) & Field(LOW_SCORE_BITS);
+        }
+        return (high_ >> ((index - LOW_CATEGORIES) * HIGH_SCORE_BITS)) & Field(HIGH_SCORE_BITS);
+    }
+
+    std::optional<size_t> GetCategoryScore(Category category) const {
+        if (static_cast<size_t>(category) >= NUM_CATEGORIES) {
+            throw std::out_of_range("Unknown category");
+        }
+        return IsFilled(category) ? std::optional<size_t>(GetScore(category)) : std::nullopt;
+    }
+
+    // Fills the category, adding to the score it already has
+    void AddScore(Category category, size_t score) {
+        const size_t index = static_cast<size_t>(category);
+        if (index >= NUM_CATEGORIES) {
+            throw std::out_of_range("Unknown category");
+        }
+        const size_t new_score = GetScore(category) + score;
+        if (new_score > GetCapacity(category)) {
+            throw std::out_of_range("Category score exceeds the sheet capacity");
+        }
+        SetScoreBits(index, new_score);
+        high_ |= uint64_t{1} << (MASK_SHIFT + index);
+        AddToTotal(score);
+
+        if (index < NUM_UPPER_CATEGORIES) {
+            const size_t old_upper = GetUpperTotal();
+            SetUpperTotal(old_upper + score);
+            if (old_upper < UPPER_BONUS_THRESHOLD && old_upper + score >= UPPER_BONUS_THRESHOLD) {
+                AddToTotal(UPPER_BONUS);
+            }
+        }
+    }
+
+    void AddYahtzeeBonus() {
+        if (GetYahtzeeBonusCount() == MAX_YAHTZEE_BONUSES) {
+            throw std::out_of_range("Too many yahtzee bonuses");
+        }
+        low_ += uint64_t{1} << BONUS_SHIFT;
+        AddToTotal(YAHTZEE_BONUS);
+    }
+
+    constexpr uint32_t GetFilledMask() const {
+        return static_cast<uint32_t>((high_ >> MASK_SHIFT) & Field(NUM_CATEGORIES));
+    }
+
+    constexpr size_t GetUpperTotal() const { return (high_ >> UPPER_SHIFT) & Field(UPPER_BITS); }
+    constexpr size_t GetYahtzeeBonusCount() const { return low_ >> BONUS_SHIFT; }
+
+    // Every point on the sheet, upper and yahtzee bonuses included
+    constexpr size_t GetTotalScore() const { return (high_ >> TOTAL_SHIFT) & Field(TOTAL_BITS); }
+
+    constexpr size_t GetRemainingUpperBonus() const {
+        const size_t upper = GetUpperTotal();
+        return upper >= UPPER_BONUS_THRESHOLD ? 0 : UPPER_BONUS_THRESHOLD - upper;
+    }
+
+    constexpr bool operator==(const ScoreSheet &other) const { return low_ == other.low_ && high_ == other.high_; }
+    constexpr bool operator!=(const ScoreSheet &other) const { return !(*this == other); }
+};
+
+static_assert(sizeof(ScoreSheet) == 16, "The score sheet must stay two words");
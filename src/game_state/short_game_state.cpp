@@ -4,32 +4,34 @@
 #include <stdexcept>
 
 ShortGameState::ShortGameState(const GameState &full_state) {
-    for (size_t i = 0; i < NUM_CATEGORIES; ++i) {
-        categories_used_[i] = full_state.GetCategoryScore(static_cast<Category>(i)).has_value();
-    }
+    key_ = ShortStateKey(full_state.GetFilledMask(), static_cast<uint32_t>(full_state.GetRemainingUpperBonus()),
+                         full_state.IsYahtzeeRecorded());
     dice_ = full_state.GetCurrentDice();
-    rerolls_left_ = full_state.GetRemainingRerolls();
-    remaining_upper_bonus_ = full_state.GetRemainingUpperBonus();
-    yahtzee_recorded_ = full_state.IsYahtzeeRecorded();
+    SetRemainingRerolls(full_state.GetRemainingRerolls());
 }
 
+ShortGameState::ShortGameState(ShortStateKey key) : key_(key) {}
+
 bool ShortGameState::IsCategoryUsed(Category category) const {
-    return categories_used_[static_cast<size_t>(category)];
+    return key_.IsCategoryUsed(category);
 }
 
 void ShortGameState::AddScoreToCategory(Category category, size_t score) {
-    if (category == Category::Yahtzee && score > 0) {
-        yahtzee_recorded_ = true;
+    bool yahtzee_recorded = key_.IsYahtzeeRecorded() || (category == Category::Yahtzee && score > 0);
+    uint32_t remaining_upper_bonus = key_.RemainingUpperBonus();
+    if (static_cast<size_t>(category) < NUM_UPPER_CATEGORIES) {
+        remaining_upper_bonus = score >= remaining_upper_bonus ? 0 : remaining_upper_bonus - static_cast<uint32_t>(score);
     }
-    categories_used_[static_cast<size_t>(category)] = true; // Mark category as used
+    uint32_t used_mask = key_.UsedMask() | (uint32_t{1} << static_cast<uint32_t>(category)); // Mark category as used
+    key_ = ShortStateKey(used_mask, remaining_upper_bonus, yahtzee_recorded);
 }
 
 size_t ShortGameState::GetRemainingUpperBonus() const {
-    return remaining_upper_bonus_;
+    return key_.RemainingUpperBonus();
 }
 
 bool ShortGameState::IsYahtzeeRecorded() const {
-    return yahtzee_recorded_;
+    return key_.IsYahtzeeRecorded();
 }
 
 const Dice &ShortGameState::GetCurrentDice() const {
@@ -48,5 +50,13 @@ void ShortGameState::SetRemainingRerolls(size_t count) {
     if (count > 3) {
         throw std::out_of_range("Rerolls cannot exceed 3");
     }
-    rerolls_left_ = count;
-}
\ No newline at end of file
+    rerolls_left_ = static_cast<uint8_t>(count);
+}
+
+ShortStateKey ShortGameState::GetKey() const {
+    return key_;
+}
+
+void ShortGameState::SetKey(ShortStateKey key) {
+    key_ = key;
+}
@@ -3,19 +3,23 @@
 #include "category.h"
 #include "dice.h"
 #include "game_state.h"
+#include "short_state_key.h"
+
+#include <cstdint>
 
 class ShortGameState {
 private:
-    std::array<bool, NUM_CATEGORIES> categories_used_{};
+    ShortStateKey key_{};
     Dice dice_{};
-    size_t rerolls_left_{2};
-    size_t remaining_upper_bonus_{};
-    bool yahtzee_recorded_{};
+    uint8_t rerolls_left_{2};
 
 public:
     ShortGameState() = default;
     ShortGameState(const GameState &full_state);
 
+    // State at the start of a turn: no dice rolled yet, two rerolls
+    explicit ShortGameState(ShortStateKey key);
+
     ~ShortGameState() = default;
 
     bool IsCategoryUsed(Category category) const;
@@ -26,4 +30,10 @@ public:
     void SetCurrentDice(const Dice &dice);
     size_t GetRemainingRerolls() const;
     void SetRemainingRerolls(size_t count);
+
+    // Packed used categories, upper remainder and yahtzee flag
+    ShortStateKey GetKey() const;
+    void SetKey(ShortStateKey key);
 };
+
+static_assert(sizeof(ShortGameState) <= 12, "A short game state is the key, a byte per face and the rerolls");
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "category.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+// Packed turn-start part of ShortGameState: used categories, points missing
+// for the upper bonus and the yahtzee flag, 20 bits in total.
+//
+// Bit layout: [19..7] used category mask, [6..1] upper remainder, [0] yahtzee.
+// Every combination of fields is a valid key, so the key value itself is a
+// dense perfect index in [0, NUM_INDICES) that tables can use as an offset.
+//
+// BasicStateKey packs the same fields for other rule sets (see rules.h): the
+// mask holds NumCategories bits, the remainder field fits UpperThreshold and
+// rule sets without a joker have no yahtzee bit. ShortStateKey is the key of
+// the Yahtzee rules.
+template<size_t NumCategories, size_t UpperThreshold, bool HasYahtzeeFlag>
+class BasicStateKey {
+private:
+    static constexpr uint32_t YAHTZEE_BITS = HasYahtzeeFlag ? 1 : 0;
+    static constexpr uint32_t UPPER_BITS = UpperThreshold < 64 ? 6 : UpperThreshold < 128 ? 7 : 8;
+    static constexpr uint32_t UPPER_SHIFT = YAHTZEE_BITS;
+    static constexpr uint32_t MASK_SHIFT = UPPER_SHIFT + UPPER_BITS;
+    static constexpr uint32_t UPPER_FIELD = (uint32_t{1} << UPPER_BITS) - 1;
+
+    static_assert(UpperThreshold <= UPPER_FIELD, "Upper remainder must fit its field");
+    static_assert(MASK_SHIFT + NumCategories <= 32, "Key must fit 32 bits");
+
+    uint32_t value_{UpperThreshold << UPPER_SHIFT};
+
+public:
+    static constexpr bool HAS_YAHTZEE_FLAG = HasYahtzeeFlag;
+    static constexpr size_t UPPER_THRESHOLD = UpperThreshold;
+    static constexpr uint32_t FULL_MASK = (uint32_t{1} << NumCategories) - 1;
+    static constexpr size_t NUM_INDICES = size_t{1} << (MASK_SHIFT + NumCategories);
+
+    // Start of the game: nothing used, full upper remainder, no yahtzee
+    constexpr BasicStateKey() = default;
+
+    // Keys without a yahtzee bit ignore yahtzee_recorded
+    constexpr BasicStateKey(uint32_t used_mask, uint32_t remaining_upper_bonus, bool yahtzee_recorded)
+        : value_((used_mask << MASK_SHIFT) | (remaining_upper_bonus << UPPER_SHIFT) |
+                 (HasYahtzeeFlag && yahtzee_recorded ? 1u : 0u)) {}
+
+    static constexpr BasicStateKey FromIndex(size_t index) {
+        BasicStateKey key;
+        key.value_ = static_cast<uint32_t>(index);
+        return key;
+    }
+
+    constexpr size_t Index() const { return value_; }
+    constexpr uint32_t Value() const { return value_; }
+
+    constexpr uint32_t UsedMask() const { return value_ >> MASK_SHIFT; }
+    constexpr uint32_t RemainingUpperBonus() const { return (value_ >> UPPER_SHIFT) & UPPER_FIELD; }
+    constexpr bool IsYahtzeeRecorded() const { return HasYahtzeeFlag && (value_ & 1u); }
+
+    // Category or YatzyCategory, whichever the rule set uses
+    template<typename CategoryType>
+    constexpr bool IsCategoryUsed(CategoryType category) const {
+        return (UsedMask() >> static_cast<uint32_t>(category)) & 1u;
+    }
+
+    // Number of used categories, the solver layer of the state
+    constexpr size_t FilledCount() const {
+        size_t count = 0;
+        for (uint32_t mask = UsedMask(); mask != 0; mask &= mask - 1) {
+            ++count;
+        }
+        return count;
+    }
+
+    constexpr bool IsGameOver() const { return UsedMask() == FULL_MASK; }
+
+    constexpr bool operator==(const BasicStateKey &other) const { return value_ == other.value_; }
+    constexpr bool operator!=(const BasicStateKey &other) const { return value_ != other.value_; }
+};
+
+using ShortStateKey = BasicStateKey<NUM_CATEGORIES, UPPER_BONUS_THRESHOLD, true>;
+
+// Multiplicative mix, keys are small dense integers and need spreading
+struct ShortStateKeyHash {
+    template<size_t NumCategories, size_t UpperThreshold, bool HasYahtzeeFlag>
+    size_t operator()(const BasicStateKey<NumCategories, UpperThreshold, HasYahtzeeFlag> &key) const noexcept {
+        uint64_t x = static_cast<uint64_t>(key.Value()) * 0x9E3779B97F4A7C15ull;
+        return static_cast<size_t>(x ^ (x >> 32));
+    }
+};
+
+namespace std {
+template<size_t NumCategories, size_t UpperThreshold, bool HasYahtzeeFlag>
+struct hash<BasicStateKey<NumCategories, UpperThreshold, HasYahtzeeFlag>> : ShortStateKeyHash {};
+}  // namespace std
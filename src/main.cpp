@@ -1,6 +1,154 @@
+#include "metrics/metrics.h"
+#include "solver/policy_table.h"
+#include "solver/quantized_table.h"
+#include "solver/solver.h"
+#include "solver/strategy_file.h"
+#include "solver/threshold_solver.h"
+
+#include <chrono>
 #include <iostream>
+#include <string>
+
+namespace {
+
+void PrintLayerStats(const std::vector<LayerStats> &layers) {
+    for (const LayerStats &layer : layers) {
+        std::cout << "  layer " << layer.filled_count << ": " << layer.num_states << " states, "
+                  << layer.seconds << " s, imbalance " << layer.imbalance << ", steals " << layer.steals
+                  << std::endl;
+    }
+}
+
+// Chance of reaching a range of final scores from the start of the game
+int SolveThresholds() {
+    ThresholdSolver solver;
+
+    auto start = std::chrono::steady_clock::now();
+    solver.Solve();
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+
+    std::cout << "Solved in " << elapsed.count() << " s" << std::endl;
+    PrintLayerStats(solver.GetLayerStats());
+    std::cout << "Table size: " << solver.GetStorageBytes() / (1024 * 1024) << " MiB" << std::endl;
+    for (size_t target = 100; target <= 350; target += 50) {
+        std::cout << "P(score >= " << target << ") = " << solver.GetProbability(ShortStateKey(), target)
+                  << std::endl;
+    }
+    return 0;
+}
+
+// Writes the table in every quantized encoding next to prefix, with the
+// corrections of the decisions they change, and reports their size and how
+// many decisions the values alone change
+int Quantize(const std::string &prefix) {
+    Solver solver;
+    solver.Solve();
+    const std::vector<double> &values = solver.GetValues();
+
+    std::vector<double> reachable;
+    for (size_t index = 0; index < values.size(); ++index) {
+        if (IsReachable(ShortStateKey::FromIndex(index))) {
+            reachable.push_back(values[index]);
+        }
+    }
+
+    const std::pair<ElementType, const char *> encodings[] = {
+        {ElementType::Fixed16, "fixed16"}, {ElementType::Float16, "float16"}, {ElementType::DeltaRice, "delta"}};
+    for (const auto &[element_type, name] : encodings) {
+        const std::string path = prefix + "." + name;
+        const std::vector<unsigned char> data = EncodeQuantizedValues(reachable.data(), reachable.size(), element_type);
+        std::vector<double> decoded;
+        QuantizedTable(data.data(), data.size(), element_type, reachable.size(), TableLayout::ShortStateKeyReachable)
+            .Decode(decoded);
+        std::vector<uint64_t> corrections;
+        const QuantizationReport report = CompareDecisions(reachable.data(), decoded.data(), decoded.size(),
+                                                           TableLayout::ShortStateKeyReachable, 0, 1, &corrections);
+        WriteStrategyFile(path, values.data(), values.size(), RuleVariant::Yahtzee,
+                          TableLayout::ShortStateKeyReachable, element_type, corrections);
+        const QuantizedTable table(path);
+        std::cout << path << ": " << table.GetDataSize() << " bytes with " << table.GetNumCorrections()
+                  << " corrections, " << static_cast<double>(reachable.size() * sizeof(double)) / table.GetDataSize()
+                  << "x smaller, max EV error " << report.max_ev_error << ", " << report.changed_decisions
+                  << " of " << report.decisions << " decisions changed, worst by " << report.max_decision_loss
+                  << ", smallest decision gap " << report.min_decision_gap << std::endl;
+    }
+    return 0;
+}
+
+// Expected score of another rule set from the start of the game
+template<typename Rules>
+int SolveRules() {
+    BasicSolver<Rules> solver;
+
+    auto start = std::chrono::steady_clock::now();
+    solver.Solve();
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+
+    std::cout << "Solved in " << elapsed.count() << " s" << std::endl;
+    PrintLayerStats(solver.GetLayerStats());
+    std::cout << "Expected score: " << solver.GetStateValue(typename Rules::StateKey()) << std::endl;
+    return 0;
+}
+
+}  // namespace
+
+// Usage: yahtzee_solver [strategy_file [--policy]]
+//        yahtzee_solver --thresholds
+//        yahtzee_solver --quantize prefix
+//        yahtzee_solver --rules free-joker|yatzy|maxi-yatzy-fixed
+// Solves the game and optionally writes the table, in the reachable layout,
+// for StrategyTable to map, and its policy next to it, or solves the best chances of reaching every final score,
+// or writes the table in every quantized encoding to prefix.<encoding>, or solves another rule set.
+// Builds with YAHTZEE_METRICS print the metrics of the solve at the end.
+int main(int argc, char **argv) {
+    if (argc > 1 && std::string(argv[1]) == "--thresholds") {
+        return SolveThresholds();
+    }
+    if (argc > 2 && std::string(argv[1]) == "--quantize") {
+        return Quantize(argv[2]);
+    }
+    if (argc > 2 && std::string(argv[1]) == "--rules") {
+        const std::string rules = argv[2];
+        if (rules == "free-joker") {
+            return SolveRules<FreeJokerYahtzeeRules>();
+        }
+        if (rules == "yatzy") {
+            return SolveRules<YatzyRules>();
+        }
+        if (rules == "maxi-yatzy-fixed") {
+            return SolveRules<MaxiYatzyNoSavedRerollsRules>();
+        }
+        std::cerr << "Unknown rules " << rules << std::endl;
+        return 1;
+    }
+
+    Solver solver;
+
+    auto start = std::chrono::steady_clock::now();
+    solver.Solve();
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+
+    std::cout << "Solved in " << elapsed.count() << " s" << std::endl;
+    PrintLayerStats(solver.GetLayerStats());
+    std::cout << "Expected score: " << solver.GetStateValue(ShortGameState()) << std::endl;
 
-int main() {
-    std::cout << "Hello from Yahtzee Solver!" << std::endl;
+    if (argc > 1) {
+        const auto &values = solver.GetValues();
+        WriteStrategyFile(argv[1], values.data(), values.size(), RuleVariant::Yahtzee,
+                          TableLayout::ShortStateKeyReachable);
+        std::cout << "Strategy table written to " << argv[1] << std::endl;
+    }
+    if (argc > 2 && std::string(argv[2]) == "--policy") {
+        const StrategyTable table(argv[1]);
+        start = std::chrono::steady_clock::now();
+        const std::vector<uint8_t> policy = BuildPolicy(table.GetValues(), table.GetLayout());
+        elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+        WritePolicyFile(GetPolicyPath(argv[1]), policy, table.GetLayout());
+        std::cout << "Policy of " << policy.size() / (1024 * 1024) << " MiB built in " << elapsed.count()
+                  << " s and written to " << GetPolicyPath(argv[1]) << std::endl;
+    }
+    if constexpr (METRICS_ENABLED) {
+        std::cout << MetricsToPrometheus(GetMetrics());
+    }
     return 0;
 }
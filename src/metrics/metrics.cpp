@@ -0,0 +1,297 @@
+#include "metrics.h"
+
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+constexpr const char *COUNTER_NAMES[NUM_METRIC_COUNTERS] = {
+    "apply_move_calls",
+    "make_move_calls",
+    "get_possible_moves_calls",
+    "turn_evaluations",
+    "solved_states",
+    "solve_nanoseconds",
+    "state_cache_hits",
+    "state_cache_misses",
+    "transposition_hits",
+    "transposition_misses",
+    "advisor_queries",
+    "policy_lookups",
+};
+
+constexpr const char *HISTOGRAM_NAMES[NUM_METRIC_HISTOGRAMS] = {
+    "solve_layer_nanoseconds",
+    "advisor_query_nanoseconds",
+    "lazy_query_nanoseconds",
+};
+
+struct HistogramShard {
+    std::atomic<uint64_t> buckets[HistogramSnapshot::NUM_BUCKETS]{};
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> sum{0};
+};
+
+// Written by one thread at a time, read and reset by any
+struct MetricsShard {
+    std::atomic<uint64_t> counters[NUM_METRIC_COUNTERS]{};
+    HistogramShard histograms[NUM_METRIC_HISTOGRAMS];
+};
+
+// Adds without a locked read-modify-write, the shard having a single writer
+void Bump(std::atomic<uint64_t> &value, uint64_t amount) {
+    value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+size_t GetBucket(uint64_t value) {
+    size_t bits = 0;
+    while (value != 0 && bits + 1 < HistogramSnapshot::NUM_BUCKETS) {
+        value >>= 1;
+        ++bits;
+    }
+    return bits;
+}
+
+class MetricsRegistry {
+public:
+    MetricsShard *Acquire() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!free_.empty()) {
+            MetricsShard *shard = free_.back();
+            free_.pop_back();
+            return shard;
+        }
+        shards_.push_back(std::make_unique<MetricsShard>());
+        return shards_.back().get();
+    }
+
+    void Release(MetricsShard *shard) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        free_.push_back(shard);
+    }
+
+    MetricsSnapshot Collect() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        MetricsSnapshot snapshot;
+        for (const auto &shard : shards_) {
+            for (size_t i = 0; i < NUM_METRIC_COUNTERS; ++i) {
+                snapshot.counters[i] += shard->counters[i].load(std::memory_order_relaxed);
+            }
+            for (size_t h = 0; h < NUM_METRIC_HISTOGRAMS; ++h) {
+                const HistogramShard &from = shard->histograms[h];
+                HistogramSnapshot &to = snapshot.histograms[h];
+                for (size_t b = 0; b < HistogramSnapshot::NUM_BUCKETS; ++b) {
+                    to.buckets[b] += from.buckets[b].load(std::memory_order_relaxed);
+                }
+                to.count += from.count.load(std::memory_order_relaxed);
+                to.sum += from.sum.load(std::memory_order_relaxed);
+            }
+        }
+        return snapshot;
+    }
+
+    void Reset() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto &shard : shards_) {
+            for (auto &counter : shard->counters) {
+                counter.store(0, std::memory_order_relaxed);
+            }
+            for (HistogramShard &histogram : shard->histograms) {
+                for (auto &bucket : histogram.buckets) {
+                    bucket.store(0, std::memory_order_relaxed);
+                }
+                histogram.count.store(0, std::memory_order_relaxed);
+                histogram.sum.store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+
+private:
+    std::mutex mutex_;
+    std::vector<std::unique_ptr<MetricsShard>> shards_;
+    std::vector<MetricsShard *> free_;
+};
+
+// Never destroyed: threads may still record while static objects go away
+MetricsRegistry &GetRegistry() {
+    static MetricsRegistry *registry = new MetricsRegistry();
+    return *registry;
+}
+
+class ShardHolder {
+public:
+    ShardHolder() : shard_(GetRegistry().Acquire()) {}
+    ~ShardHolder() { GetRegistry().Release(shard_); }
+
+    MetricsShard &Get() { return *shard_; }
+
+private:
+    MetricsShard *shard_;
+};
+
+MetricsShard &GetThreadShard() {
+    thread_local ShardHolder holder;
+    return holder.Get();
+}
+
+double Ratio(uint64_t numerator, uint64_t denominator) {
+    return denominator == 0 ? 0.0 : static_cast<double>(numerator) / static_cast<double>(denominator);
+}
+
+std::string FormatDouble(double value) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.9g", value);
+    return buffer;
+}
+
+}  // namespace
+
+const char *GetMetricName(MetricCounter counter) {
+    return COUNTER_NAMES[static_cast<size_t>(counter)];
+}
+
+const char *GetMetricName(MetricHistogram histogram) {
+    return HISTOGRAM_NAMES[static_cast<size_t>(histogram)];
+}
+
+uint64_t HistogramSnapshot::GetBucketLimit(size_t bucket) {
+    if (bucket + 1 >= NUM_BUCKETS) {
+        return UINT64_MAX;
+    }
+    return (uint64_t{1} << bucket) - 1;
+}
+
+double HistogramSnapshot::GetMean() const {
+    return Ratio(sum, count);
+}
+
+uint64_t HistogramSnapshot::GetQuantile(double fraction) const {
+    if (count == 0) {
+        return 0;
+    }
+    const double target = fraction * static_cast<double>(count);
+    uint64_t seen = 0;
+    for (size_t b = 0; b < NUM_BUCKETS; ++b) {
+        seen += buckets[b];
+        if (buckets[b] != 0 && static_cast<double>(seen) >= target) {
+            return GetBucketLimit(b);
+        }
+    }
+    return GetBucketLimit(NUM_BUCKETS - 1);
+}
+
+double MetricsSnapshot::GetStateCacheHitRate() const {
+    return Ratio(Get(MetricCounter::StateCacheHits),
+                 Get(MetricCounter::StateCacheHits) + Get(MetricCounter::StateCacheMisses));
+}
+
+double MetricsSnapshot::GetTranspositionHitRate() const {
+    return Ratio(Get(MetricCounter::TranspositionHits),
+                 Get(MetricCounter::TranspositionHits) + Get(MetricCounter::TranspositionMisses));
+}
+
+double MetricsSnapshot::GetSolvedStatesPerSecond() const {
+    return 1e9 * Ratio(Get(MetricCounter::SolvedStates), Get(MetricCounter::SolveNanoseconds));
+}
+
+MetricsSnapshot GetMetrics() {
+    if constexpr (!METRICS_ENABLED) {
+        return MetricsSnapshot();
+    }
+    return GetRegistry().Collect();
+}
+
+void ResetMetrics() {
+    if constexpr (METRICS_ENABLED) {
+        GetRegistry().Reset();
+    }
+}
+
+std::string MetricsToJson(const MetricsSnapshot &snapshot) {
+    std::string json = "{\"enabled\":";
+    json += snapshot.enabled ? "true" : "false";
+    json += ",\"counters\":{";
+    for (size_t i = 0; i < NUM_METRIC_COUNTERS; ++i) {
+        json += i == 0 ? "\"" : ",\"";
+        json += COUNTER_NAMES[i];
+        json += "\":" + std::to_string(snapshot.counters[i]);
+    }
+    json += "},\"rates\":{\"state_cache_hit_rate\":" + FormatDouble(snapshot.GetStateCacheHitRate());
+    json += ",\"transposition_hit_rate\":" + FormatDouble(snapshot.GetTranspositionHitRate());
+    json += ",\"solved_states_per_second\":" + FormatDouble(snapshot.GetSolvedStatesPerSecond());
+    json += "},\"histograms\":{";
+    for (size_t h = 0; h < NUM_METRIC_HISTOGRAMS; ++h) {
+        const HistogramSnapshot &histogram = snapshot.histograms[h];
+        json += h == 0 ? "\"" : ",\"";
+        json += HISTOGRAM_NAMES[h];
+        json += "\":{\"count\":" + std::to_string(histogram.count);
+        json += ",\"sum\":" + std::to_string(histogram.sum);
+        json += ",\"mean\":" + FormatDouble(histogram.GetMean());
+        json += ",\"p50\":" + std::to_string(histogram.GetQuantile(0.5));
+        json += ",\"p99\":" + std::to_string(histogram.GetQuantile(0.99));
+        json += ",\"buckets\":[";
+        bool first = true;
+        for (size_t b = 0; b < HistogramSnapshot::NUM_BUCKETS; ++b) {
+            if (histogram.buckets[b] == 0) {
+                continue;
+            }
+            json += first ? "{\"le\":" : ",{\"le\":";
+            json += std::to_string(HistogramSnapshot::GetBucketLimit(b));
+            json += ",\"count\":" + std::to_string(histogram.buckets[b]) + "}";
+            first = false;
+        }
+        json += "]}";
+    }
+    json += "}}";
+    return json;
+}
+
+std::string MetricsToPrometheus(const MetricsSnapshot &snapshot) {
+    std::string text;
+    for (size_t i = 0; i < NUM_METRIC_COUNTERS; ++i) {
+        const std::string name = std::string("yahtzee_") + COUNTER_NAMES[i] + "_total";
+        text += "# TYPE " + name + " counter\n";
+        text += name + " " + std::to_string(snapshot.counters[i]) + "\n";
+    }
+    text += "# TYPE yahtzee_state_cache_hit_rate gauge\n";
+    text += "yahtzee_state_cache_hit_rate " + FormatDouble(snapshot.GetStateCacheHitRate()) + "\n";
+    text += "# TYPE yahtzee_transposition_hit_rate gauge\n";
+    text += "yahtzee_transposition_hit_rate " + FormatDouble(snapshot.GetTranspositionHitRate()) + "\n";
+    text += "# TYPE yahtzee_solved_states_per_second gauge\n";
+    text += "yahtzee_solved_states_per_second " + FormatDouble(snapshot.GetSolvedStatesPerSecond()) + "\n";
+
+    // Buckets are cumulative in Prometheus; the empty tail past the last value is left out
+    for (size_t h = 0; h < NUM_METRIC_HISTOGRAMS; ++h) {
+        const HistogramSnapshot &histogram = snapshot.histograms[h];
+        const std::string name = std::string("yahtzee_") + HISTOGRAM_NAMES[h];
+        text += "# TYPE " + name + " histogram\n";
+        uint64_t cumulative = 0;
+        for (size_t b = 0; b + 1 < HistogramSnapshot::NUM_BUCKETS && cumulative < histogram.count; ++b) {
+            cumulative += histogram.buckets[b];
+            text += name + "_bucket{le=\"" + std::to_string(HistogramSnapshot::GetBucketLimit(b)) + "\"} " +
+                    std::to_string(cumulative) + "\n";
+        }
+        text += name + "_bucket{le=\"+Inf\"} " + std::to_string(histogram.count) + "\n";
+        text += name + "_sum " + std::to_string(histogram.sum) + "\n";
+        text += name + "_count " + std::to_string(histogram.count) + "\n";
+    }
+    return text;
+}
+
+namespace metrics_detail {
+
+void Add(MetricCounter counter, uint64_t amount) {
+    Bump(GetThreadShard().counters[static_cast<size_t>(counter)], amount);
+}
+
+void Record(MetricHistogram histogram, uint64_t value) {
+    HistogramShard &shard = GetThreadShard().histograms[static_cast<size_t>(histogram)];
+    Bump(shard.buckets[GetBucket(value)], 1);
+    Bump(shard.count, 1);
+    Bump(shard.sum, value);
+}
+
+}  // namespace metrics_detail
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Process-wide counters and latency histograms of the solver and its queries.
+//
+// Recording compiles to nothing unless the build sets YAHTZEE_METRICS (the
+// CMake option of the same name), so hot paths like MakeMove carry no cost
+// in normal builds. The reading side always exists and reports zeros and
+// enabled == false when recording is compiled out.
+//
+// Every thread records into a shard of its own with relaxed atomic stores, no
+// read-modify-write and no sharing; GetMetrics sums the shards. Shards of
+// finished threads are handed to new ones with their counts, so totals keep
+// the work of threads that are gone.
+#ifndef YAHTZEE_METRICS
+#define YAHTZEE_METRICS 0
+#endif
+
+constexpr bool METRICS_ENABLED = YAHTZEE_METRICS != 0;
+
+enum class MetricCounter : uint32_t {
+    ApplyMoveCalls,
+    MakeMoveCalls,
+    GetPossibleMovesCalls,
+    TurnEvaluations,     // turns evaluated from their score level up
+    SolvedStates,        // states of the layers solved by Solver
+    SolveNanoseconds,    // wall time of those layers
+    StateCacheHits,      // StateValueCache lookups
+    StateCacheMisses,
+    TranspositionHits,   // expectimax table probes
+    TranspositionMisses,
+    AdvisorQueries,
+    PolicyLookups,       // Advisor::GetBestMove answered from a PolicyTable
+    Count
+};
+
+enum class MetricHistogram : uint32_t {
+    SolveLayerNanoseconds,
+    AdvisorQueryNanoseconds,
+    LazyQueryNanoseconds,  // LazySolver::GetStateValue
+    Count
+};
+
+constexpr size_t NUM_METRIC_COUNTERS = static_cast<size_t>(MetricCounter::Count);
+constexpr size_t NUM_METRIC_HISTOGRAMS = static_cast<size_t>(MetricHistogram::Count);
+
+// Snake case name, the key in JSON and the suffix of the Prometheus name
+const char *GetMetricName(MetricCounter counter);
+const char *GetMetricName(MetricHistogram histogram);
+
+// Bucket b counts the values with b significant bits: 0 in bucket 0, [2^(b-1), 2^b) in bucket b
+struct HistogramSnapshot {
+    static constexpr size_t NUM_BUCKETS = 64;  // the last one takes everything above
+
+    std::array<uint64_t, NUM_BUCKETS> buckets{};
+    uint64_t count{0};
+    uint64_t sum{0};
+
+    static uint64_t GetBucketLimit(size_t bucket);  // largest value of the bucket
+    double GetMean() const;
+    // Upper limit of the bucket holding the given fraction of the values, 0 when empty
+    uint64_t GetQuantile(double fraction) const;
+};
+
+struct MetricsSnapshot {
+    bool enabled{METRICS_ENABLED};
+    std::array<uint64_t, NUM_METRIC_COUNTERS> counters{};
+    std::array<HistogramSnapshot, NUM_METRIC_HISTOGRAMS> histograms{};
+
+    uint64_t Get(MetricCounter counter) const { return counters[static_cast<size_t>(counter)]; }
+    const HistogramSnapshot &Get(MetricHistogram histogram) const {
+        return histograms[static_cast<size_t>(histogram)];
+    }
+
+    double GetStateCacheHitRate() const;
+    double GetTranspositionHitRate() const;
+    double GetSolvedStatesPerSecond() const;
+};
+
+// Sums of every shard; counts recorded meanwhile may or may not be included
+MetricsSnapshot GetMetrics();
+// Zeroes every shard; counts recorded meanwhile may survive
+void ResetMetrics();
+
+// One object with the counters, the derived rates and the non-empty buckets of the histograms
+std::string MetricsToJson(const MetricsSnapshot &snapshot);
+// Prometheus text exposition: yahtzee_<name> counters and cumulative histograms
+std::string MetricsToPrometheus(const MetricsSnapshot &snapshot);
+
+namespace metrics_detail {
+
+void Add(MetricCounter counter, uint64_t amount);
+void Record(MetricHistogram histogram, uint64_t value);
+
+}  // namespace metrics_detail
+
+inline void CountMetric(MetricCounter counter, uint64_t amount = 1) {
+    if constexpr (METRICS_ENABLED) {
+        metrics_detail::Add(counter, amount);
+    }
+}
+
+inline void RecordMetric(MetricHistogram histogram, uint64_t value) {
+    if constexpr (METRICS_ENABLED) {
+        metrics_detail::Record(histogram, value);
+    }
+}
+
+// Records the nanoseconds from construction to destruction
+class ScopedMetricTimer {
+public:
+    explicit ScopedMetricTimer(MetricHistogram histogram) : histogram_(histogram) {
+        if constexpr (METRICS_ENABLED) {
+            start_ = std::chrono::steady_clock::now();
+        }
+    }
+
+    ~ScopedMetricTimer() {
+        if constexpr (METRICS_ENABLED) {
+            const auto elapsed = std::chrono::steady_clock::now() - start_;
+            metrics_detail::Record(histogram_,
+                                   static_cast<uint64_t>(
+                                       std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+        }
+    }
+
+    ScopedMetricTimer(const ScopedMetricTimer &) = delete;
+    ScopedMetricTimer &operator=(const ScopedMetricTimer &) = delete;
+
+private:
+    MetricHistogram histogram_;
+    std::chrono::steady_clock::time_point start_{};
+};
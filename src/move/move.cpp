@@ -1,9 +1,10 @@
 #include "move.h"
+#include "move_list.h"
 #include "../game_state/game_state_utils.h"
+#include "../metrics/metrics.h"
 
 #include <stdexcept>
-#include <set>
-#include <algorithm>
+#include <type_traits>
 
 RerrolMove::RerrolMove(const std::vector<size_t>& keep_values) 
     : keep_values_(keep_values) {
@@ -25,44 +26,6 @@ Category ScoreMove::GetCategory() const {
     return category_;
 }
 
-// Helper function to generate all possible reroll moves without duplicates
-template<typename GameStateType>
-std::vector<RerrolMove> GenerateRerollMoves(const GameStateType& state) {
-    std::set<std::vector<size_t>> unique_combinations;
-    const Dice& dice = GetCurrentDice(state);
-    
-    // Get all current dice values
-    std::vector<size_t> current_values;
-    for (size_t value = 1; value <= 6; ++value) {
-        for (size_t count = 0; count < dice[value]; ++count) {
-            current_values.push_back(value);
-        }
-    }
-    
-    // Generate all possible subsets of dice to keep (2^n possibilities)
-    size_t n = current_values.size();
-    for (size_t mask = 0; mask < (1ULL << n); ++mask) {
-        std::vector<size_t> keep_values;
-        for (size_t i = 0; i < n; ++i) {
-            if (mask & (1ULL << i)) {
-                keep_values.push_back(current_values[i]);
-            }
-        }
-        
-        // Sort to make combination unique regardless of order
-        std::sort(keep_values.begin(), keep_values.end());
-        unique_combinations.insert(keep_values);
-    }
-    
-    // Convert set to vector of RerrolMove
-    std::vector<RerrolMove> moves;
-    for (const auto& combination : unique_combinations) {
-        moves.emplace_back(combination);
-    }
-    
-    return moves;
-}
-
 // Helper function to check if yahtzee is recorded with positive score
 template<typename GameStateType>
 bool IsYahtzeeRecordedWithPositiveScore(const GameStateType& state) {
@@ -75,69 +38,81 @@ bool IsYahtzeeRecordedWithPositiveScore(const GameStateType& state) {
     }
 }
 
-// Helper function to generate all possible score moves
-template<typename GameStateType>
-std::vector<ScoreMove> GenerateScoreMoves(const GameStateType& state) {
-    std::vector<ScoreMove> moves;
-    
-    bool is_yahtzee = IsCurrentDiceYahtzee(state);
-    bool yahtzee_recorded_positive = IsYahtzeeRecordedWithPositiveScore(state);
-    
-    // Check for joker rules (multiple yahtzees)
-    if (is_yahtzee && yahtzee_recorded_positive) {
-        size_t yahtzee_value = GetYahtzeeValue(state);
-        Category corresponding_upper_category = static_cast<Category>(yahtzee_value - 1);
-        
-        // Joker rule: if corresponding upper category is open, must choose it
-        if (!IsCategoryUsed(state, corresponding_upper_category)) {
-            moves.emplace_back(corresponding_upper_category);
-            return moves;
-        } else {
-            // If upper category is filled, can choose any lower category
-            for (size_t i = static_cast<size_t>(Category::ThreeOfAKind); 
-                 i <= static_cast<size_t>(Category::Chance); ++i) {
-                Category category = static_cast<Category>(i);
-                if (!IsCategoryUsed(state, category)) {
-                    moves.emplace_back(category);
-                }
-            }
-            return moves;
+// Bit mask of the categories a score move may use
+template<typename GameStateType, typename Rules>
+uint32_t GetScoreMoveMask(const GameStateType& state) {
+    static_assert(std::is_same_v<typename Rules::CategoryType, Category>, "Game states hold a Yahtzee sheet");
+
+    uint32_t open_mask = 0;
+    for (size_t i = 0; i < NUM_CATEGORIES; ++i) {
+        if (!IsCategoryUsed(state, static_cast<Category>(i))) {
+            open_mask |= uint32_t{1} << i;
         }
     }
-    
-    // Normal case: can choose any unused category
-    for (size_t i = 0; i < NUM_CATEGORIES; ++i) {
-        Category category = static_cast<Category>(i);
-        if (!IsCategoryUsed(state, category)) {
-            moves.emplace_back(category);
+
+    // A yahtzee on top of a scored one is a joker, the rules narrow its categories
+    if (IsCurrentDiceYahtzee(state) && IsYahtzeeRecordedWithPositiveScore(state)) {
+        return Rules::AllowedCategories(open_mask, GetYahtzeeValue(state));
+    }
+    return Rules::AllowedCategories(open_mask, 0);
+}
+
+template<typename GameStateType, typename Rules>
+void GetPossibleMoves(const GameStateType& state, MoveList& moves) {
+    CountMetric(MetricCounter::GetPossibleMovesCalls);
+    moves.clear();
+
+    // If we have rerolls left, every distinct set of dice to keep is a move
+    if (GetRemainingRerolls(state) > 0) {
+        KeepIndex current = GetCurrentDice(state).keep_index();
+        for (KeepIndex keep : SUB_KEEP_TABLE.GetRow(current)) {
+            moves.push_back(CompactMove::Reroll(keep));
         }
     }
-    
-    return moves;
+
+    for (uint32_t mask = GetScoreMoveMask<GameStateType, Rules>(state); mask != 0; mask &= mask - 1) {
+        size_t category = 0;
+        while (!((mask >> category) & 1u)) {
+            ++category;
+        }
+        moves.push_back(CompactMove::Score(static_cast<Category>(category)));
+    }
 }
 
-// Main template function to get all possible moves
+Move CompactMove::ToMove() const {
+    if (!IsReroll()) {
+        return ScoreMove(GetCategory());
+    }
+    std::vector<size_t> keep_values;
+    const DiceCounts& counts = KEEP_TABLE.counts[GetKeepIndex()];
+    for (size_t face = 0; face < NUM_FACES; ++face) {
+        keep_values.insert(keep_values.end(), counts[face], face + 1);
+    }
+    return RerrolMove(keep_values);
+}
+
+// Adapter over the allocation-free move list
 template<typename GameStateType>
 std::vector<Move> GetPossibleMoves(const GameStateType& state) {
+    MoveList list;
+    GetPossibleMoves(state, list);
+
     std::vector<Move> moves;
-    
-    // If we have rerolls left, generate all possible reroll moves
-    if (GetRemainingRerolls(state) > 0) {
-        auto reroll_moves = GenerateRerollMoves(state);
-        for (const auto& reroll_move : reroll_moves) {
-            moves.emplace_back(reroll_move);
-        }
-    }
-    
-    // Generate all possible scoring moves
-    auto score_moves = GenerateScoreMoves(state);
-    for (const auto& score_move : score_moves) {
-        moves.emplace_back(score_move);
+    moves.reserve(list.size());
+    for (CompactMove move : list) {
+        moves.push_back(move.ToMove());
     }
-    
     return moves;
 }
 
 // Explicit template instantiation
+template uint32_t GetScoreMoveMask<GameState>(const GameState& state);
+template uint32_t GetScoreMoveMask<ShortGameState>(const ShortGameState& state);
+template uint32_t GetScoreMoveMask<GameState, FreeJokerYahtzeeRules>(const GameState& state);
+template uint32_t GetScoreMoveMask<ShortGameState, FreeJokerYahtzeeRules>(const ShortGameState& state);
+template void GetPossibleMoves<GameState>(const GameState& state, MoveList& moves);
+template void GetPossibleMoves<ShortGameState>(const ShortGameState& state, MoveList& moves);
+template void GetPossibleMoves<GameState, FreeJokerYahtzeeRules>(const GameState& state, MoveList& moves);
+template void GetPossibleMoves<ShortGameState, FreeJokerYahtzeeRules>(const ShortGameState& state, MoveList& moves);
 template std::vector<Move> GetPossibleMoves<GameState>(const GameState& state);
 template std::vector<Move> GetPossibleMoves<ShortGameState>(const ShortGameState& state);
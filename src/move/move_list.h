@@ -0,0 +1,66 @@
+#pragma once
+
+#include "move.h"
+#include "../game_state/category.h"
+#include "../game_state/dice_index.h"
+#include "../game_state/rules.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Move packed into 16 bits: a KeepIndex for rerolls, NUM_KEEPS + category for scoring
+class CompactMove {
+private:
+    uint16_t value_{0};
+
+    constexpr explicit CompactMove(uint16_t value) : value_(value) {}
+
+public:
+    constexpr CompactMove() = default;
+
+    static constexpr CompactMove Reroll(KeepIndex keep) { return CompactMove(keep); }
+    static constexpr CompactMove Score(Category category) {
+        return CompactMove(static_cast<uint16_t>(NUM_KEEPS + static_cast<size_t>(category)));
+    }
+
+    constexpr bool IsReroll() const { return value_ < NUM_KEEPS; }
+    constexpr KeepIndex GetKeepIndex() const { return value_; }
+    constexpr Category GetCategory() const { return static_cast<Category>(value_ - NUM_KEEPS); }
+    constexpr uint16_t Value() const { return value_; }
+
+    constexpr bool operator==(const CompactMove &other) const { return value_ == other.value_; }
+    constexpr bool operator!=(const CompactMove &other) const { return value_ != other.value_; }
+
+    // Adapter to the Move variant (allocates the keep values of a reroll)
+    Move ToMove() const;
+};
+
+// Fixed-capacity list of moves, never allocates
+class MoveList {
+public:
+    static constexpr size_t MAX_MOVES = SubKeepTable::MAX_SUB_KEEPS + NUM_CATEGORIES;
+
+    constexpr void push_back(CompactMove move) { moves_[size_++] = move; }
+    constexpr void clear() { size_ = 0; }
+
+    constexpr size_t size() const { return size_; }
+    constexpr bool empty() const { return size_ == 0; }
+    constexpr const CompactMove &operator[](size_t i) const { return moves_[i]; }
+    constexpr const CompactMove *begin() const { return moves_.data(); }
+    constexpr const CompactMove *end() const { return moves_.data() + size_; }
+
+private:
+    std::array<CompactMove, MAX_MOVES> moves_{};
+    uint8_t size_{0};
+};
+
+// Bit per category that may be scored now, including the joker rules.
+// Rules is YahtzeeRules or FreeJokerYahtzeeRules, the rule sets of the Yahtzee score sheet.
+template<typename GameStateType, typename Rules = YahtzeeRules>
+uint32_t GetScoreMoveMask(const GameStateType& state);
+
+// All moves from a game state: rerolls first, in increasing keep order, then scores.
+// The current dice must hold at most five dice.
+template<typename GameStateType, typename Rules = YahtzeeRules>
+void GetPossibleMoves(const GameStateType& state, MoveList& moves);
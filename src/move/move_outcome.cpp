@@ -1,5 +1,9 @@
 #include "move_outcome.h"
+#include "reroll_matrix.h"
+#include "score_table.h"
+#include "../metrics/metrics.h"
 #include <algorithm>
+#include <type_traits>
 
 // Helper function to calculate score for a category based on dice
 size_t CalculateScore(const Dice& dice, Category category) {
@@ -91,134 +95,137 @@ size_t CalculateScore(const Dice& dice, Category category) {
 
 // Helper function to check if current dice form a yahtzee
 bool IsYahtzee(const Dice& dice) {
-    const auto& counts = dice.counts();
+    const auto& counts = dice.raw_counts();
     for (size_t count : counts) {
         if (count == 5) return true;
     }
     return false;
 }
 
-// Template specialization for GameState
-template<>
-MoveOutcome<GameState> ApplyMove<GameState>(const GameState& state, const Move& move) {
-    GameState new_state = state;
-    size_t score_delta = 0;
-    
-    if (std::holds_alternative<ScoreMove>(move)) {
-        const ScoreMove& score_move = std::get<ScoreMove>(move);
-        Category category = score_move.GetCategory();
-        
-        // Calculate base score for the category
-        size_t base_score = CalculateScore(state.GetCurrentDice(), category);
-        
-        // Handle Yahtzee bonus rules
-        bool is_yahtzee = IsYahtzee(state.GetCurrentDice());
-        bool yahtzee_recorded = state.IsYahtzeeRecorded();
-        
-        if (is_yahtzee && yahtzee_recorded && category != Category::Yahtzee) {
-            // Joker rules apply - can use any category
-            score_delta = base_score;
-            new_state.AddScoreToCategory(category, base_score);
-            
-            // Check for upper bonus
-            if (static_cast<size_t>(category) < 6) { // Upper section category
-                size_t current_upper = 0;
-                for (size_t i = 0; i < 6; ++i) {
-                    if (auto score = new_state.GetCategoryScore(static_cast<Category>(i))) {
-                        current_upper += score.value();
-                    }
-                }
-                if (current_upper >= 63) {
-                    score_delta += 35; // Upper section bonus
-                }
-            }
-        } else {
-            // Normal scoring
-            score_delta = base_score;
-            new_state.AddScoreToCategory(category, base_score);
-            
-            // Check for upper bonus
-            if (static_cast<size_t>(category) < 6) { // Upper section category
-                size_t current_upper = 0;
-                for (size_t i = 0; i < 6; ++i) {
-                    if (auto score = new_state.GetCategoryScore(static_cast<Category>(i))) {
-                        current_upper += score.value();
-                    }
-                }
-                if (current_upper >= 63) {
-                    score_delta += 35; // Upper section bonus
-                }
-            }
-            
-            // Handle Yahtzee bonus for multiple yahtzees
-            if (category == Category::Yahtzee && base_score == 50 && yahtzee_recorded) {
-                score_delta += 100; // Yahtzee bonus
-            }
+// Base score from the score tables, dice that aren't a full roll fall back to CalculateScore
+size_t TableScore(const Dice& dice, Category category, bool joker) {
+    if (dice.total() != NUM_DICE) {
+        return CalculateScore(dice, category);
+    }
+    RollIndex roll = dice.roll_index();
+    return joker ? JokerRollScore(roll, category) : RollScore(roll, category);
+}
+
+namespace {
+
+UndoToken<GameState> SaveUndo(const GameState& state) {
+    return UndoToken<GameState>{state.GetSheet(), 0, static_cast<uint8_t>(state.GetRemainingRerolls())};
+}
+
+UndoToken<ShortGameState> SaveUndo(const ShortGameState& state) {
+    return UndoToken<ShortGameState>{state.GetKey(), 0, static_cast<uint8_t>(state.GetRemainingRerolls())};
+}
+
+// Scores the current dice in the category, returns the points with bonuses
+template<typename GameStateType>
+size_t ScoreInPlace(GameStateType& state, Category category) {
+    // Handle Yahtzee bonus rules
+    bool is_yahtzee = IsYahtzee(state.GetCurrentDice());
+    bool yahtzee_recorded = state.IsYahtzeeRecorded();
+    bool joker = is_yahtzee && yahtzee_recorded && category != Category::Yahtzee;
+    bool had_upper_bonus = state.GetRemainingUpperBonus() == 0;
+
+    // Calculate base score for the category
+    size_t base_score = TableScore(state.GetCurrentDice(), category, joker);
+    size_t score_delta = base_score;
+    state.AddScoreToCategory(category, base_score);
+
+    // Every further yahtzee earns the bonus while the yahtzee box holds one, whichever box it takes
+    if (is_yahtzee && yahtzee_recorded) {
+        score_delta += YahtzeeRules::YAHTZEE_BONUS;
+        if constexpr (std::is_same_v<GameStateType, GameState>) {
+            state.AddYahtzeeBonus();
         }
+    }
+
+    // Upper section bonus is awarded once, when the threshold is crossed
+    if (!had_upper_bonus && state.GetRemainingUpperBonus() == 0) {
+        score_delta += UPPER_BONUS;
+    }
+    return score_delta;
+}
+
+// For reroll moves, just decrease reroll count
+// Actual dice rerolling should be handled separately, GetRerollOutcomes lists the possible results
+template<typename GameStateType>
+void RerollInPlace(GameStateType& state) {
+    size_t current_rerolls = state.GetRemainingRerolls();
+    if (current_rerolls > 0) {
+        state.SetRemainingRerolls(current_rerolls - 1);
+    }
+}
+
+}  // namespace
+
+template<typename GameStateType>
+UndoToken<GameStateType> MakeMove(GameStateType& state, const Move& move) {
+    CountMetric(MetricCounter::MakeMoveCalls);
+    UndoToken<GameStateType> token = SaveUndo(state);
+    if (const ScoreMove* score_move = std::get_if<ScoreMove>(&move)) {
+        token.score_delta = static_cast<uint16_t>(ScoreInPlace(state, score_move->GetCategory()));
     } else if (std::holds_alternative<RerrolMove>(move)) {
-        const RerrolMove& reroll_move = std::get<RerrolMove>(move);
-        
-        // For reroll moves, just decrease reroll count
-        // Actual dice rerolling should be handled separately
-        size_t current_rerolls = state.GetRemainingRerolls();
-        if (current_rerolls > 0) {
-            new_state.SetRemainingRerolls(current_rerolls - 1);
-        }
-        // Note: Dice don't change here - that should be handled by the caller
+        RerollInPlace(state);
     } else {
         throw std::invalid_argument("Unknown move type");
     }
-    
-    return MoveOutcome<GameState>{new_state, score_delta};
+    return token;
 }
 
-// Template specialization for ShortGameState
-template<>
-MoveOutcome<ShortGameState> ApplyMove<ShortGameState>(const ShortGameState& state, const Move& move) {
-    ShortGameState new_state = state;
-    size_t score_delta = 0;
-    
-    if (std::holds_alternative<ScoreMove>(move)) {
-        const ScoreMove& score_move = std::get<ScoreMove>(move);
-        Category category = score_move.GetCategory();
-        
-        // Calculate base score for the category
-        size_t base_score = CalculateScore(state.GetCurrentDice(), category);
-        
-        // Handle Yahtzee bonus rules
-        bool is_yahtzee = IsYahtzee(state.GetCurrentDice());
-        bool yahtzee_recorded = state.IsYahtzeeRecorded();
-        
-        if (is_yahtzee && yahtzee_recorded && category != Category::Yahtzee) {
-            // Joker rules apply - can use any category
-            score_delta = base_score;
-            new_state.AddScoreToCategory(category, base_score);
-        } else {
-            // Normal scoring
-            score_delta = base_score;
-            new_state.AddScoreToCategory(category, base_score);
-            
-            // Handle Yahtzee bonus for multiple yahtzees
-            if (category == Category::Yahtzee && base_score == 50 && yahtzee_recorded) {
-                score_delta += 100; // Yahtzee bonus
-            }
-        }
-    } else if (std::holds_alternative<RerrolMove>(move)) {
-        const RerrolMove& reroll_move = std::get<RerrolMove>(move);
-        
-        // For reroll moves, just decrease reroll count
-        size_t current_rerolls = state.GetRemainingRerolls();
-        if (current_rerolls > 0) {
-            new_state.SetRemainingRerolls(current_rerolls - 1);
-        }
-        // Note: Dice don't change here - that should be handled by the caller
+template<typename GameStateType>
+UndoToken<GameStateType> MakeMove(GameStateType& state, CompactMove move) {
+    CountMetric(MetricCounter::MakeMoveCalls);
+    UndoToken<GameStateType> token = SaveUndo(state);
+    if (move.IsReroll()) {
+        RerollInPlace(state);
     } else {
-        throw std::invalid_argument("Unknown move type");
+        token.score_delta = static_cast<uint16_t>(ScoreInPlace(state, move.GetCategory()));
     }
-    
-    return MoveOutcome<ShortGameState>{new_state, score_delta};
+    return token;
+}
+
+template<>
+void UnmakeMove<GameState>(GameState& state, const UndoToken<GameState>& token) {
+    state.SetSheet(token.sheet);
+    state.SetRemainingRerolls(token.rerolls_left);
+}
+
+template<>
+void UnmakeMove<ShortGameState>(ShortGameState& state, const UndoToken<ShortGameState>& token) {
+    state.SetKey(token.key);
+    state.SetRemainingRerolls(token.rerolls_left);
+}
+
+template<typename GameStateType>
+MoveOutcome<GameStateType> ApplyMove(const GameStateType& state, const Move& move) {
+    CountMetric(MetricCounter::ApplyMoveCalls);
+    GameStateType new_state = state;
+    size_t score_delta = MakeMove(new_state, move).score_delta;
+    return MoveOutcome<GameStateType>{new_state, score_delta};
+}
+
+std::vector<std::pair<Dice, double>> GetRerollOutcomes(const RerrolMove& move) {
+    Dice kept(move.GetKeepValues());
+    RerollMatrix::Row row = REROLL_MATRIX.GetRow(kept.keep_index());
+
+    std::vector<std::pair<Dice, double>> outcomes;
+    outcomes.reserve(row.size);
+    for (size_t i = 0; i < row.size; ++i) {
+        outcomes.emplace_back(Dice::from_roll_index(row.rolls[i]), row.probabilities[i]);
+    }
+    return outcomes;
 }
 
 // Explicit template instantiation
 template struct MoveOutcome<GameState>;
 template struct MoveOutcome<ShortGameState>;
+template MoveOutcome<GameState> ApplyMove<GameState>(const GameState&, const Move&);
+template MoveOutcome<ShortGameState> ApplyMove<ShortGameState>(const ShortGameState&, const Move&);
+template UndoToken<GameState> MakeMove<GameState>(GameState&, const Move&);
+template UndoToken<ShortGameState> MakeMove<ShortGameState>(ShortGameState&, const Move&);
+template UndoToken<GameState> MakeMove<GameState>(GameState&, CompactMove);
+template UndoToken<ShortGameState> MakeMove<ShortGameState>(ShortGameState&, CompactMove);
@@ -1,9 +1,15 @@
 #pragma once
 
 #include "move.h"
+#include "move_list.h"
+#include "../game_state/dice_index.h"
 #include "../game_state/game_state.h"
+#include "../game_state/rules.h"
 #include "../game_state/short_game_state.h"
+#include <cstdint>
 #include <stdexcept>
+#include <utility>
+#include <vector>
 
 template<typename GameStateType>
 struct MoveOutcome {
@@ -11,6 +17,48 @@ struct MoveOutcome {
     size_t score_delta;
 };
 
+// Base score of the dice in a category, without bonuses
+size_t CalculateScore(const Dice& dice, Category category);
+
+// The same for the categories and dice of any rule set (see rules.h), from the score function of the rules
+template<typename Rules>
+size_t CalculateScore(const BasicDice<typename Rules::Shape>& dice, typename Rules::CategoryType category) {
+    return Rules::Score(dice.raw_counts(), static_cast<size_t>(category), false);
+}
+
 // Declaration of ApplyMove function
 template<typename GameStateType>
 MoveOutcome<GameStateType> ApplyMove(const GameStateType& state, const Move& move);
+
+// What MakeMove changed: the part of the state a move can touch before the
+// move, and the points the move scored. Dice are never changed by a move.
+template<typename GameStateType>
+struct UndoToken;
+
+template<>
+struct UndoToken<GameState> {
+    ScoreSheet sheet;
+    uint16_t score_delta;
+    uint8_t rerolls_left;
+};
+
+template<>
+struct UndoToken<ShortGameState> {
+    ShortStateKey key;
+    uint16_t score_delta;
+    uint8_t rerolls_left;
+};
+
+// Applies the move to the state in place, following the rules of ApplyMove
+template<typename GameStateType>
+UndoToken<GameStateType> MakeMove(GameStateType& state, const Move& move);
+
+template<typename GameStateType>
+UndoToken<GameStateType> MakeMove(GameStateType& state, CompactMove move);
+
+// Restores the state as it was before MakeMove; tokens of several moves are undone in reverse order
+template<typename GameStateType>
+void UnmakeMove(GameStateType& state, const UndoToken<GameStateType>& token);
+
+// Every dice result of a reroll move (kept dice plus rerolled ones) with its probability
+std::vector<std::pair<Dice, double>> GetRerollOutcomes(const RerrolMove& move);
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "../game_state/dice_index.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Sparse keep -> roll transition matrix in CSR layout, generated at compile time.
+//
+// Row k lists every roll reachable by keeping the dice of KeepIndex k and
+// rerolling the rest, with its exact probability. Columns within a row are in
+// increasing RollIndex order and rows are stored back to back, so a sweep over
+// all keeps streams both arrays once from start to end.
+//
+// BasicRerollMatrix is the matrix of any DiceShape; RerollMatrix is the one of FiveDice.
+template<typename Shape>
+class BasicRerollMatrix {
+public:
+    using RollIndex = typename Shape::RollIndex;
+    using KeepIndex = typename Shape::KeepIndex;
+
+    // Sum over keeps of the number of outcomes of rerolling the other dice:
+    // keep and reroll together are a multiset over twice the faces
+    static constexpr size_t NUM_ENTRIES = dice_index_detail::NumMultisets(Shape::NUM_DICE, 2 * Shape::NUM_FACES);
+
+    static_assert(NUM_ENTRIES < 65536, "Entries must fit the row offsets");
+
+    struct Row {
+        const RollIndex *rolls;
+        const double *probabilities;
+        size_t size;
+    };
+
+    constexpr BasicRerollMatrix() {
+        const auto &keeps = SHAPE_KEEP_TABLE<Shape>;
+        const auto &offsets = SHAPE_KEEP_OFFSETS<Shape>;
+        size_t entry = 0;
+        for (size_t keep = 0; keep < Shape::NUM_KEEPS; ++keep) {
+            row_offsets_[keep] = static_cast<uint16_t>(entry);
+            const size_t rerolled = Shape::NUM_DICE - keeps.size[keep];
+            for (size_t extra = offsets[rerolled]; extra < offsets[rerolled + 1]; ++extra) {
+                typename Shape::Counts result = keeps.counts[keep];
+                for (size_t face = 0; face < Shape::NUM_FACES; ++face) {
+                    result[face] = static_cast<uint8_t>(result[face] + keeps.counts[extra][face]);
+                }
+                // Insertion keeps the row sorted by roll
+                size_t position = entry;
+                const RollIndex roll = ToRollIndex<Shape>(result);
+                while (position > row_offsets_[keep] && rolls_[position - 1] > roll) {
+                    rolls_[position] = rolls_[position - 1];
+                    probabilities_[position] = probabilities_[position - 1];
+                    --position;
+                }
+                rolls_[position] = roll;
+                probabilities_[position] = keeps.probability[extra];
+                ++entry;
+            }
+        }
+        row_offsets_[Shape::NUM_KEEPS] = static_cast<uint16_t>(entry);
+    }
+
+    constexpr Row GetRow(KeepIndex keep) const {
+        return Row{rolls_.data() + row_offsets_[keep], probabilities_.data() + row_offsets_[keep],
+                   static_cast<size_t>(row_offsets_[keep + 1] - row_offsets_[keep])};
+    }
+
+    constexpr const uint16_t *RowOffsets() const { return row_offsets_.data(); }
+    constexpr const RollIndex *Rolls() const { return rolls_.data(); }
+    constexpr const double *Probabilities() const { return probabilities_.data(); }
+
+private:
+    std::array<uint16_t, Shape::NUM_KEEPS + 1> row_offsets_{};
+    std::array<RollIndex, NUM_ENTRIES> rolls_{};
+    std::array<double, NUM_ENTRIES> probabilities_{};
+};
+
+using RerollMatrix = BasicRerollMatrix<FiveDice>;
+
+template<typename Shape>
+inline constexpr BasicRerollMatrix<Shape> SHAPE_REROLL_MATRIX{};
+
+inline constexpr const RerollMatrix &REROLL_MATRIX = SHAPE_REROLL_MATRIX<FiveDice>;
+
+static_assert(RerollMatrix::NUM_ENTRIES == 4368, "Wrong number of entries");
+static_assert(REROLL_MATRIX.RowOffsets()[NUM_KEEPS] == RerollMatrix::NUM_ENTRIES, "Wrong number of entries");
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "../game_state/category.h"
+#include "../game_state/dice_index.h"
+#include "../game_state/rules.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Base scores of every roll in every category, generated at compile time.
+// SCORE_TABLE matches CalculateScore, which stays as the reference.
+// JOKER_SCORE_TABLE is used when a yahtzee roll is played as a joker: the
+// full house and both straights then score their full value.
+//
+// RULE_SCORE_TABLE and RULE_JOKER_SCORE_TABLE are the same tables for any
+// rule set (see rules.h); the joker table of rules without a joker is the
+// plain one. Their rows are the rolls of the dice of the rule set.
+
+template<typename Rules>
+using RuleScoreTable = std::array<std::array<uint8_t, Rules::NUM_CATEGORIES>, Rules::Shape::NUM_ROLLS>;
+
+using ScoreTable = RuleScoreTable<YahtzeeRules>;
+
+namespace score_table_detail {
+
+template<typename Rules>
+constexpr RuleScoreTable<Rules> BuildScoreTable(bool joker) {
+    const auto &rolls = SHAPE_ROLL_TABLE<typename Rules::Shape>;
+    RuleScoreTable<Rules> table{};
+    for (size_t roll = 0; roll < Rules::Shape::NUM_ROLLS; ++roll) {
+        const bool joker_roll = joker && rolls.is_yahtzee[roll];
+        for (size_t category = 0; category < Rules::NUM_CATEGORIES; ++category) {
+            table[roll][category] = static_cast<uint8_t>(Rules::Score(rolls.counts[roll], category, joker_roll));
+        }
+    }
+    return table;
+}
+
+}  // namespace score_table_detail
+
+template<typename Rules>
+inline constexpr RuleScoreTable<Rules> RULE_SCORE_TABLE = score_table_detail::BuildScoreTable<Rules>(false);
+template<typename Rules>
+inline constexpr RuleScoreTable<Rules> RULE_JOKER_SCORE_TABLE =
+    score_table_detail::BuildScoreTable<Rules>(Rules::HAS_JOKER);
+
+inline constexpr const ScoreTable &SCORE_TABLE = RULE_SCORE_TABLE<YahtzeeRules>;
+inline constexpr const ScoreTable &JOKER_SCORE_TABLE = RULE_JOKER_SCORE_TABLE<YahtzeeRules>;
+
+constexpr size_t RollScore(RollIndex roll, Category category) {
+    return SCORE_TABLE[roll][static_cast<size_t>(category)];
+}
+
+constexpr size_t JokerRollScore(RollIndex roll, Category category) {
+    return JOKER_SCORE_TABLE[roll][static_cast<size_t>(category)];
+}
@@ -0,0 +1,472 @@
+#include "log_analyzer.h"
+#include "../game_state/game_state.h"
+#include "../move/move_outcome.h"
+#include "../solver/strategy_file.h"
+#include "../solver/turn_evaluator.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <map>
+#include <unordered_map>
+
+namespace {
+
+constexpr size_t NPOS = std::string_view::npos;
+
+bool IsBlank(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+size_t NextLine(std::string_view log, size_t line) {
+    const void *newline = std::memchr(log.data() + line, '\n', log.size() - line);
+    return newline == nullptr ? log.size() : static_cast<size_t>(static_cast<const char *>(newline) - log.data()) + 1;
+}
+
+// Fields of a line, split at blanks
+class LineReader {
+public:
+    LineReader(std::string_view log, size_t begin, size_t end) : line_(log.substr(begin, end - begin)) {}
+
+    // Next field, empty at the end of the line
+    std::string_view Next() {
+        while (position_ < line_.size() && (IsBlank(line_[position_]) || line_[position_] == '\n')) {
+            ++position_;
+        }
+        const size_t begin = position_;
+        while (position_ < line_.size() && !IsBlank(line_[position_]) && line_[position_] != '\n') {
+            ++position_;
+        }
+        return line_.substr(begin, position_ - begin);
+    }
+
+private:
+    std::string_view line_;
+    size_t position_{0};
+};
+
+// Game of a decision line, empty for blank and comment lines
+std::string_view GameField(std::string_view log, size_t line) {
+    std::string_view game = LineReader(log, line, NextLine(log, line)).Next();
+    return !game.empty() && game[0] == '#' ? std::string_view() : game;
+}
+
+// First line at or after pos that starts a game, the end of the log if none
+size_t FindGameStart(std::string_view log, size_t pos) {
+    if (pos == 0 || pos >= log.size()) {
+        return std::min(pos, log.size());
+    }
+    size_t line = log[pos - 1] == '\n' ? pos : NextLine(log, pos);
+    std::string_view previous;
+    for (size_t end = line; previous.empty() && end > 0;) {
+        const size_t newline = end >= 2 ? log.rfind('\n', end - 2) : NPOS;
+        const size_t start = newline == NPOS ? 0 : newline + 1;
+        previous = GameField(log, start);
+        end = start;
+    }
+    while (line < log.size()) {
+        std::string_view game = GameField(log, line);
+        if (!game.empty() && game != previous) {
+            break;
+        }
+        line = NextLine(log, line);
+    }
+    return line;
+}
+
+bool ParseDice(std::string_view field, size_t max_dice, DiceCounts &counts) {
+    counts = {};
+    if (field.size() > max_dice) {
+        return false;
+    }
+    for (char c : field) {
+        if (c < '1' || c > '6') {
+            return false;
+        }
+        ++counts[static_cast<size_t>(c - '1')];
+    }
+    return true;
+}
+
+// Moves by letter: k<kept dice> or s<category>
+bool ParseMove(std::string_view field, CompactMove &move, DiceCounts &kept) {
+    if (field.empty()) {
+        return false;
+    }
+    if (field[0] == 'k') {
+        if (!ParseDice(field.substr(1), NUM_DICE, kept)) {
+            return false;
+        }
+        move = CompactMove::Reroll(ToKeepIndex(kept));
+        return true;
+    }
+    if (field[0] != 's' || field.size() < 2 || field.size() > 3) {
+        return false;
+    }
+    size_t category = 0;
+    for (char c : field.substr(1)) {
+        if (c < '0' || c > '9') {
+            return false;
+        }
+        category = category * 10 + static_cast<size_t>(c - '0');
+    }
+    if (category >= NUM_CATEGORIES) {
+        return false;
+    }
+    move = CompactMove::Score(static_cast<Category>(category));
+    return true;
+}
+
+bool Contains(const DiceCounts &dice, const DiceCounts &kept) {
+    for (size_t face = 0; face < NUM_FACES; ++face) {
+        if (kept[face] > dice[face]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+void AppendLogDecision(std::string &log, std::string_view game, std::string_view player, const Dice &dice,
+                       CompactMove move) {
+    log.append(game).append(1, ' ').append(player).append(1, ' ');
+    for (size_t face = 1; face <= NUM_FACES; ++face) {
+        log.append(dice[face], static_cast<char>('0' + face));
+    }
+    if (move.IsReroll()) {
+        log.append(" k");
+        const DiceCounts &kept = KEEP_TABLE.counts[move.GetKeepIndex()];
+        for (size_t face = 0; face < NUM_FACES; ++face) {
+            log.append(kept[face], static_cast<char>('1' + face));
+        }
+    } else {
+        log.append(" s").append(std::to_string(static_cast<size_t>(move.GetCategory())));
+    }
+    log.append(1, '\n');
+}
+
+double PlayerStats::GetMeanEvLoss() const {
+    return decisions == 0 ? 0.0 : total_ev_loss / static_cast<double>(decisions);
+}
+
+double PlayerStats::GetEvLossPerGame() const {
+    return games == 0 ? 0.0 : total_ev_loss / static_cast<double>(games);
+}
+
+double PlayerStats::GetMeanScore() const {
+    return completed_games == 0 ? 0.0 : static_cast<double>(total_score) / static_cast<double>(completed_games);
+}
+
+void PlayerStats::Merge(const PlayerStats &other) {
+    games += other.games;
+    completed_games += other.completed_games;
+    total_score += other.total_score;
+    decisions += other.decisions;
+    suboptimal_decisions += other.suboptimal_decisions;
+    total_ev_loss += other.total_ev_loss;
+    max_ev_loss = std::max(max_ev_loss, other.max_ev_loss);
+}
+
+double LogAnalysis::GetDecisionsPerSecond() const {
+    return seconds > 0.0 ? static_cast<double>(decisions) / seconds : 0.0;
+}
+
+// Grades whole games; totals by player, grades by block
+class LogAnalyzer::Worker {
+public:
+    // Power of two, about 24 KB each
+    static constexpr size_t NUM_TURNS = 256;
+
+    Worker(const double *state_values, TableLayout layout, const PolicyTable *policy)
+        : state_values_(state_values), layout_(layout), policy_(policy) {
+        for (size_t i = 0; i < NUM_TURNS; ++i) {
+            turns_.push_back(std::make_unique<Turn>(state_values, layout));
+        }
+    }
+
+    void Reset() {
+        players_.clear();
+        games_ = 0;
+        decisions_ = 0;
+        invalid_games_ = 0;
+    }
+
+    // Grades the games of the lines [begin, end), which start and end at games
+    void AnalyzeBlock(std::string_view log, size_t begin, size_t end, std::vector<DecisionGrade> *grades) {
+        size_t line = begin;
+        while (line < end) {
+            std::string_view game = GameField(log, line);
+            if (game.empty()) {
+                line = NextLine(log, line);
+                continue;
+            }
+            size_t game_end = line;
+            while (game_end < end) {
+                std::string_view next = GameField(log, game_end);
+                if (!next.empty() && next != game) {
+                    break;
+                }
+                game_end = NextLine(log, game_end);
+            }
+            AnalyzeGame(log, line, game_end, grades);
+            line = game_end;
+        }
+    }
+
+    void AddTo(LogAnalysis &analysis, std::map<std::string, PlayerStats, std::less<>> &players) const {
+        analysis.games += games_;
+        analysis.decisions += decisions_;
+        analysis.invalid_games += invalid_games_;
+        for (const auto &[name, stats] : players_) {
+            auto it = players.find(name);
+            if (it == players.end()) {
+                it = players.emplace(std::string(name), PlayerStats{}).first;
+                it->second.name = std::string(name);
+            }
+            it->second.Merge(stats);
+        }
+    }
+
+private:
+    // Turn of one state: its evaluator and the keep values worked out so
+    // far at each reroll level, valid where their stamp is that of the state
+    struct Turn {
+        Turn(const double *state_values, TableLayout layout) : evaluator(state_values, layout) {}
+
+        TurnEvaluator evaluator;
+        ShortStateKey key{};
+        uint32_t stamp{1};
+        std::array<std::array<uint32_t, NUM_KEEPS>, TurnEvaluator::TURN_REROLLS> keep_stamps{};
+        std::array<std::array<double, NUM_KEEPS>, TurnEvaluator::TURN_REROLLS> keep_values{};
+    };
+
+    Turn &GetTurn(ShortStateKey key) {
+        Turn &turn = *turns_[ShortStateKeyHash()(key) & (NUM_TURNS - 1)];
+        if (turn.key != key) {
+            turn.key = key;
+            if (++turn.stamp == 0) {
+                turn.keep_stamps = {};
+                turn.stamp = 1;
+            }
+        }
+        return turn;
+    }
+
+    double GetKeepValue(Turn &turn, size_t rerolls, KeepIndex keep) {
+        uint32_t &stamp = turn.keep_stamps[rerolls - 1][keep];
+        double &value = turn.keep_values[rerolls - 1][keep];
+        if (stamp != turn.stamp) {
+            turn.evaluator.Evaluate(turn.key, rerolls - 1);
+            value = turn.evaluator.GetKeepValue(rerolls, keep);
+            stamp = turn.stamp;
+        }
+        return value;
+    }
+
+    // Points of the score move plus the value of the next turn-start state
+    double GetScoreValue(ShortStateKey key, RollIndex roll, uint32_t category) const {
+        const ScoreOutcome outcome = GetScoreOutcome(key, roll, static_cast<Category>(category));
+        return static_cast<double>(outcome.points) + state_values_[GetLayoutOffset(outcome.next, layout_)];
+    }
+
+    double GetMoveValue(ShortStateKey key, size_t rerolls, RollIndex roll, CompactMove move) {
+        if (move.IsReroll()) {
+            return GetKeepValue(GetTurn(key), rerolls, move.GetKeepIndex());
+        }
+        return GetScoreValue(key, roll, static_cast<uint32_t>(move.GetCategory()));
+    }
+
+    void AnalyzeGame(std::string_view log, size_t begin, size_t end, std::vector<DecisionGrade> *grades) {
+        const size_t first_grade = grades != nullptr ? grades->size() : 0;
+        GameState state;
+        std::string_view player;
+        PlayerStats stats;
+        size_t turns = 0;
+        bool rerolled = false;  // the dice of the next line keep those of the last reroll
+        DiceCounts kept{};
+
+        for (size_t line = begin; line < end; line = NextLine(log, line)) {
+            LineReader reader(log, line, NextLine(log, line));
+            std::string_view game = reader.Next();
+            if (game.empty() || game[0] == '#') {
+                continue;
+            }
+            std::string_view name = reader.Next();
+            if (player.empty()) {
+                player = name;
+            }
+            DiceCounts dice;
+            CompactMove move;
+            DiceCounts move_kept;
+            if (name != player || !ParseDice(reader.Next(), NUM_DICE, dice) ||
+                !ParseMove(reader.Next(), move, move_kept) || !reader.Next().empty() || turns == NUM_CATEGORIES) {
+                return Reject(grades, first_grade);
+            }
+            size_t total = 0;
+            for (uint8_t count : dice) {
+                total += count;
+            }
+            if (total != NUM_DICE || (rerolled && !Contains(dice, kept))) {
+                return Reject(grades, first_grade);
+            }
+            if (!rerolled) {
+                state.SetRemainingRerolls(TurnEvaluator::TURN_REROLLS);
+            }
+            const RollIndex roll = ToRollIndex(dice);
+            state.SetCurrentDice(Dice::from_roll_index(roll));
+
+            double loss = 0.0;
+            if (!Grade(state, roll, move, move_kept, loss)) {
+                return Reject(grades, first_grade);
+            }
+            stats.decisions++;
+            stats.total_ev_loss += loss;
+            stats.max_ev_loss = std::max(stats.max_ev_loss, loss);
+            stats.suboptimal_decisions += loss > TOLERANCE ? 1 : 0;
+            if (grades != nullptr) {
+                grades->push_back({line, static_cast<float>(loss)});
+            }
+
+            MakeMove(state, move);
+            rerolled = move.IsReroll();
+            if (rerolled) {
+                kept = move_kept;
+            } else {
+                state.SetCurrentDice(Dice());
+                ++turns;
+            }
+        }
+        if (player.empty()) {
+            return;  // only comments
+        }
+        stats.games = 1;
+        if (turns == NUM_CATEGORIES) {
+            stats.completed_games = 1;
+            stats.total_score = state.GetTotalScore();
+        }
+        ++games_;
+        decisions_ += stats.decisions;
+        players_[player].Merge(stats);
+    }
+
+    // Expected value of the best move minus that of the chosen one; false
+    // when the rules do not allow the move. Score moves only look up the
+    // next states, so final rolls evaluate nothing, and every keep value is
+    // worked out once per state. With a policy the best move is a lookup,
+    // and a decision that plays it costs nothing.
+    bool Grade(const GameState &state, RollIndex roll, CompactMove move, const DiceCounts &move_kept, double &loss) {
+        const size_t rerolls = state.GetRemainingRerolls();
+        const ShortStateKey key(state.GetFilledMask(), static_cast<uint32_t>(state.GetRemainingUpperBonus()),
+                                state.IsYahtzeeRecorded());
+        const uint32_t allowed = GetAllowedCategoryMask(key, roll);
+        if (move.IsReroll() ? rerolls == 0 || !Contains(ROLL_TABLE.counts[roll], move_kept)
+                            : !((allowed >> static_cast<uint32_t>(move.GetCategory())) & 1u)) {
+            return false;
+        }
+
+        if (policy_ != nullptr) {
+            const uint8_t code = policy_->GetMoveCode(key, rerolls, roll);
+            if (code != PolicyTable::NO_MOVE) {
+                if (code == PolicyTable::EncodeMove(move, roll)) {
+                    loss = 0.0;
+                } else {
+                    loss = GetMoveValue(key, rerolls, roll, PolicyTable::DecodeMove(code, roll)) -
+                           GetMoveValue(key, rerolls, roll, move);
+                }
+                return true;
+            }
+        }
+
+        double best = -std::numeric_limits<double>::infinity();
+        for (uint32_t mask = allowed; mask != 0; mask &= mask - 1) {
+            uint32_t category = 0;
+            while (!((mask >> category) & 1u)) {
+                ++category;
+            }
+            best = std::max(best, GetScoreValue(key, roll, category));
+        }
+        if (rerolls > 0) {
+            Turn &turn = GetTurn(key);
+            for (KeepIndex keep : SUB_KEEP_TABLE.GetRow(static_cast<KeepIndex>(KEEP_OFFSETS[NUM_DICE] + roll))) {
+                best = std::max(best, GetKeepValue(turn, rerolls, keep));
+            }
+        }
+        loss = best - GetMoveValue(key, rerolls, roll, move);
+        return true;
+    }
+
+    void Reject(std::vector<DecisionGrade> *grades, size_t first_grade) {
+        if (grades != nullptr) {
+            grades->resize(first_grade);
+        }
+        ++invalid_games_;
+    }
+
+    const double *state_values_;
+    TableLayout layout_;
+    const PolicyTable *policy_;
+    std::vector<std::unique_ptr<Turn>> turns_;
+    std::unordered_map<std::string_view, PlayerStats> players_;
+    uint64_t games_{0};
+    uint64_t decisions_{0};
+    uint64_t invalid_games_{0};
+};
+
+LogAnalyzer::LogAnalyzer(const double *state_values, TableLayout layout, size_t num_threads,
+                         const PolicyTable *policy)
+    : scheduler_(num_threads) {
+    for (size_t worker = 0; worker < scheduler_.GetNumThreads(); ++worker) {
+        workers_.push_back(std::make_unique<Worker>(state_values, layout, policy));
+    }
+}
+
+LogAnalyzer::~LogAnalyzer() = default;
+
+LogAnalysis LogAnalyzer::AnalyzeFile(const std::string &path, bool keep_grades) {
+    std::error_code error;
+    const auto size = std::filesystem::file_size(path, error);
+    if (error) {
+        throw std::runtime_error("Cannot open " + path);
+    }
+    if (size == 0) {
+        return Analyze(std::string_view(), keep_grades);
+    }
+    MappedFile file(path);
+    return Analyze(std::string_view(reinterpret_cast<const char *>(file.GetData()), file.GetSize()), keep_grades);
+}
+
+LogAnalysis LogAnalyzer::Analyze(std::string_view log, bool keep_grades) {
+    const auto start = std::chrono::steady_clock::now();
+    for (auto &worker : workers_) {
+        worker->Reset();
+    }
+    const size_t num_blocks = (log.size() + BLOCK_BYTES - 1) / BLOCK_BYTES;
+    std::vector<std::vector<DecisionGrade>> block_grades(keep_grades ? num_blocks : 0);
+
+    scheduler_.ParallelFor(num_blocks, 1, [&](size_t begin, size_t end, size_t worker) {
+        for (size_t block = begin; block < end; ++block) {
+            const size_t block_begin = FindGameStart(log, block * BLOCK_BYTES);
+            const size_t block_end = FindGameStart(log, (block + 1) * BLOCK_BYTES);
+            workers_[worker]->AnalyzeBlock(log, block_begin, block_end,
+                                           keep_grades ? &block_grades[block] : nullptr);
+        }
+    });
+
+    LogAnalysis analysis;
+    std::map<std::string, PlayerStats, std::less<>> players;
+    for (const auto &worker : workers_) {
+        worker->AddTo(analysis, players);
+    }
+    for (auto &[name, stats] : players) {
+        analysis.players.push_back(std::move(stats));
+    }
+    for (std::vector<DecisionGrade> &grades : block_grades) {
+        analysis.grades.insert(analysis.grades.end(), grades.begin(), grades.end());
+    }
+    analysis.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return analysis;
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "../game_state/dice.h"
+#include "../move/move_list.h"
+#include "../solver/policy_table.h"
+#include "../solver/table_layout.h"
+#include "../solver/task_scheduler.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Game logs: one decision per line, `<game> <player> <dice> <move>`.
+//
+// game and player are tokens without blanks; the lines of a game are
+// consecutive and every game starts from an empty sheet. dice is the roll
+// showing as five digits 1-6. move is `k` and the digits of the kept dice
+// for a reroll (`k` alone rerolls everything) or `s` and the category index
+// for a score move, e.g. `7 alice 23456 s10`. Blank lines and lines
+// starting with '#' are ignored.
+
+// Appends the log line of a decision
+void AppendLogDecision(std::string &log, std::string_view game, std::string_view player, const Dice &dice,
+                       CompactMove move);
+
+// EV lost by one decision; offset is the byte offset of its line in the log
+struct DecisionGrade {
+    uint64_t offset{0};
+    float ev_loss{0.0f};
+};
+
+// Totals of the games of one player
+struct PlayerStats {
+    std::string name;
+    uint64_t games{0};
+    uint64_t completed_games{0};  // games that filled every category
+    uint64_t total_score{0};      // final scores of the completed games
+    uint64_t decisions{0};
+    uint64_t suboptimal_decisions{0};  // decisions that lost more than LogAnalyzer::TOLERANCE
+    double total_ev_loss{0.0};
+    double max_ev_loss{0.0};
+
+    double GetMeanEvLoss() const;        // per decision
+    double GetEvLossPerGame() const;
+    double GetMeanScore() const;         // of the completed games
+
+    void Merge(const PlayerStats &other);
+};
+
+struct LogAnalysis {
+    uint64_t games{0};
+    uint64_t decisions{0};
+    // Games left out: unreadable lines, moves the rules do not allow or dice
+    // that do not hold the kept ones
+    uint64_t invalid_games{0};
+    std::vector<PlayerStats> players;       // by name
+    std::vector<DecisionGrade> grades;      // in log order, when asked for
+    double seconds{0.0};
+
+    double GetDecisionsPerSecond() const;
+};
+
+// Grades every decision of game logs against the optimal expected score.
+//
+// A game is replayed from an empty GameState with MakeMove, and every
+// decision costs the expected value of its best move minus that of the
+// chosen one, both from a table of turn-start values (Solver::GetValues() or
+// a mapped StrategyTable with its layout) that must outlive the analyzer.
+// With a PolicyTable of the same values the best move is a lookup, and the
+// decisions that play it are graded without evaluating their turn.
+//
+// Logs are parsed in place, from a string or a memory-mapped file. The log
+// is cut into blocks of about BLOCK_BYTES moved forward to the next game, so
+// every game is graded by one worker of a TaskScheduler. Workers keep a
+// direct-mapped set of turns by state with their TurnEvaluator and keep
+// values, so the turns every game goes through, like the first one, are
+// evaluated once per worker. Final rolls only look up the states their
+// score moves lead to.
+class LogAnalyzer {
+public:
+    static constexpr size_t BLOCK_BYTES = size_t{1} << 20;
+    static constexpr double TOLERANCE = 1e-9;
+
+    // num_threads == 0 uses all hardware threads
+    explicit LogAnalyzer(const double *state_values, TableLayout layout = TableLayout::ShortStateKeyDense,
+                         size_t num_threads = 0, const PolicyTable *policy = nullptr);
+    ~LogAnalyzer();
+
+    // Throws std::runtime_error when the file cannot be read
+    LogAnalysis AnalyzeFile(const std::string &path, bool keep_grades = false);
+    LogAnalysis Analyze(std::string_view log, bool keep_grades = false);
+
+private:
+    class Worker;
+
+    TaskScheduler scheduler_;
+    std::vector<std::unique_ptr<Worker>> workers_;
+};
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Philox4x32-10 counter-based random number generator (Salmon et al., 2011).
+//
+// Every 128-bit counter maps to four independent 32-bit outputs under a
+// 64-bit key, so a stream is fully described by (key, stream id) and needs
+// no state to be carried between threads. The generator keys on the seed
+// and reserves the upper half of the counter for the stream id, the lower
+// half counts blocks within the stream.
+class Philox4x32 {
+public:
+    using Block = std::array<uint32_t, 4>;
+    using result_type = uint32_t;
+
+    Philox4x32(uint64_t seed, uint64_t stream) : key_(seed), stream_(stream) {}
+
+    // One block of the Philox4x32-10 bijection
+    static Block Generate(Block counter, uint64_t key) {
+        uint32_t k0 = static_cast<uint32_t>(key);
+        uint32_t k1 = static_cast<uint32_t>(key >> 32);
+        for (int round = 0; round < 10; ++round) {
+            const uint64_t product0 = uint64_t{M0} * counter[0];
+            const uint64_t product1 = uint64_t{M1} * counter[2];
+            counter = {static_cast<uint32_t>(product1 >> 32) ^ counter[1] ^ k0, static_cast<uint32_t>(product1),
+                       static_cast<uint32_t>(product0 >> 32) ^ counter[3] ^ k1, static_cast<uint32_t>(product0)};
+            k0 += W0;
+            k1 += W1;
+        }
+        return counter;
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return UINT32_MAX; }
+
+    result_type operator()() {
+        if (position_ == buffer_.size()) {
+            buffer_ = Generate({static_cast<uint32_t>(block_), static_cast<uint32_t>(block_ >> 32),
+                                static_cast<uint32_t>(stream_), static_cast<uint32_t>(stream_ >> 32)},
+                               key_);
+            ++block_;
+            position_ = 0;
+        }
+        return buffer_[position_++];
+    }
+
+    // Uniform integer in [0, bound), without modulo bias (Lemire's method)
+    uint32_t Uniform(uint32_t bound) {
+        uint64_t product = uint64_t{(*this)()} * bound;
+        if (static_cast<uint32_t>(product) < bound) {
+            const uint32_t threshold = static_cast<uint32_t>(-bound) % bound;
+            while (static_cast<uint32_t>(product) < threshold) {
+                product = uint64_t{(*this)()} * bound;
+            }
+        }
+        return static_cast<uint32_t>(product >> 32);
+    }
+
+private:
+    static constexpr uint32_t M0 = 0xD2511F53;
+    static constexpr uint32_t M1 = 0xCD9E8D57;
+    static constexpr uint32_t W0 = 0x9E3779B9;
+    static constexpr uint32_t W1 = 0xBB67AE85;
+
+    uint64_t key_;
+    uint64_t stream_;
+    uint64_t block_{0};
+    Block buffer_{};
+    size_t position_{4};
+};
@@ -0,0 +1,31 @@
+#include "policy.h"
+#include "../move/move_outcome.h"
+
+OptimalPolicy::OptimalPolicy(const double *state_values, TableLayout layout) : advisor_(state_values, layout) {}
+
+size_t OptimalPolicy::ChooseMove(const GameState &state, const MoveList &) {
+    // The advisor lists the moves in GetPossibleMoves order as well
+    advisor_.Advise(state, advice_);
+    return advice_.best;
+}
+
+size_t GreedyPolicy::ChooseMove(const GameState &state, const MoveList &moves) {
+    GameState scratch = state;
+    size_t best = 0;
+    size_t best_points = 0;
+    bool found = false;
+    for (size_t i = 0; i < moves.size(); ++i) {
+        if (moves[i].IsReroll()) {
+            continue;
+        }
+        UndoToken<GameState> token = MakeMove(scratch, moves[i]);
+        UnmakeMove(scratch, token);
+        size_t points = token.score_delta;
+        if (!found || points > best_points) {
+            best = i;
+            best_points = points;
+            found = true;
+        }
+    }
+    return best;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "../game_state/game_state.h"
+#include "../move/move_list.h"
+#include "../solver/advisor.h"
+
+#include <cstddef>
+
+// Decides the moves of simulated games. The simulator keeps one policy per
+// worker thread, so implementations need no locking.
+class Policy {
+public:
+    virtual ~Policy() = default;
+
+    // Index in moves of the move to play. The dice of the state are a full
+    // roll and moves are GetPossibleMoves of the state.
+    virtual size_t ChooseMove(const GameState &state, const MoveList &moves) = 0;
+};
+
+// Best expected score, from a table of turn-start values (Solver::GetValues()
+// or a mapped StrategyTable with its layout) that must outlive the policy
+class OptimalPolicy : public Policy {
+public:
+    explicit OptimalPolicy(const double *state_values, TableLayout layout = TableLayout::ShortStateKeyDense);
+
+    size_t ChooseMove(const GameState &state, const MoveList &moves) override;
+
+private:
+    Advisor advisor_;
+    Advice advice_;
+};
+
+// Never rerolls and scores the most points now, bonuses included
+class GreedyPolicy : public Policy {
+public:
+    size_t ChooseMove(const GameState &state, const MoveList &moves) override;
+};
@@ -0,0 +1,163 @@
+#include "simulator.h"
+#include "../move/move_outcome.h"
+#include "../move/score_table.h"
+
+#include <stdexcept>
+
+namespace {
+
+// Adds random dice to the kept ones up to a full roll
+Dice RollDice(DiceCounts counts, size_t kept, Philox4x32 &rng) {
+    for (size_t die = kept; die < NUM_DICE; ++die) {
+        ++counts[rng.Uniform(NUM_FACES)];
+    }
+    return Dice::from_roll_index(ToRollIndex(counts));
+}
+
+// Points already on the sheet, upper bonus included
+size_t SheetPoints(const GameState &state) {
+    size_t points = 0;
+    bool upper_used = false;
+    for (size_t i = 0; i < NUM_CATEGORIES; ++i) {
+        auto score = state.GetCategoryScore(static_cast<Category>(i));
+        points += score.value_or(0);
+        upper_used = upper_used || (i < NUM_UPPER_CATEGORIES && score.has_value());
+    }
+    if (upper_used && state.GetRemainingUpperBonus() == 0) {
+        points += UPPER_BONUS;
+    }
+    return points;
+}
+
+size_t OpenCategories(const GameState &state) {
+    size_t open = 0;
+    for (size_t i = 0; i < NUM_CATEGORIES; ++i) {
+        open += state.GetCategoryScore(static_cast<Category>(i)).has_value() ? 0 : 1;
+    }
+    return open;
+}
+
+template<typename T>
+void AddToHistogram(std::vector<T> &histogram, size_t bucket, T count) {
+    if (histogram.size() <= bucket) {
+        histogram.resize(bucket + 1, 0);
+    }
+    histogram[bucket] += count;
+}
+
+}  // namespace
+
+double SimulationStats::GetMeanScore() const {
+    if (num_games == 0) {
+        return 0.0;
+    }
+    double total = 0.0;
+    for (size_t score = 0; score < score_histogram.size(); ++score) {
+        total += static_cast<double>(score) * static_cast<double>(score_histogram[score]);
+    }
+    return total / static_cast<double>(num_games);
+}
+
+double SimulationStats::GetCategoryFillRate(Category category) const {
+    return num_games == 0 ? 0.0
+                          : static_cast<double>(category_scored[static_cast<size_t>(category)]) /
+                                static_cast<double>(num_games);
+}
+
+double SimulationStats::GetUpperBonusRate() const {
+    return num_games == 0 ? 0.0 : static_cast<double>(upper_bonus_games) / static_cast<double>(num_games);
+}
+
+uint64_t SimulationStats::GetYahtzeeBonusCount() const {
+    uint64_t count = 0;
+    for (size_t bonuses = 0; bonuses < yahtzee_bonus_histogram.size(); ++bonuses) {
+        count += bonuses * yahtzee_bonus_histogram[bonuses];
+    }
+    return count;
+}
+
+void SimulationStats::AddGame(const GameState &final_state, size_t score, size_t yahtzee_bonuses) {
+    ++num_games;
+    AddToHistogram<uint64_t>(score_histogram, score, 1);
+    for (size_t i = 0; i < NUM_CATEGORIES; ++i) {
+        category_scored[i] += final_state.GetCategoryScore(static_cast<Category>(i)).value_or(0) > 0 ? 1 : 0;
+    }
+    upper_bonus_games += final_state.GetRemainingUpperBonus() == 0 ? 1 : 0;
+    AddToHistogram<uint64_t>(yahtzee_bonus_histogram, yahtzee_bonuses, 1);
+}
+
+void SimulationStats::Merge(const SimulationStats &other) {
+    num_games += other.num_games;
+    for (size_t score = 0; score < other.score_histogram.size(); ++score) {
+        AddToHistogram(score_histogram, score, other.score_histogram[score]);
+    }
+    for (size_t i = 0; i < NUM_CATEGORIES; ++i) {
+        category_scored[i] += other.category_scored[i];
+    }
+    upper_bonus_games += other.upper_bonus_games;
+    for (size_t bonuses = 0; bonuses < other.yahtzee_bonus_histogram.size(); ++bonuses) {
+        AddToHistogram(yahtzee_bonus_histogram, bonuses, other.yahtzee_bonus_histogram[bonuses]);
+    }
+}
+
+Simulator::Simulator(const PolicyFactory &make_policy, size_t num_threads) : scheduler_(num_threads) {
+    for (size_t worker = 0; worker < scheduler_.GetNumThreads(); ++worker) {
+        policies_.push_back(make_policy());
+    }
+}
+
+SimulationStats Simulator::Run(const GameState &start, size_t num_games, uint64_t seed) {
+    std::vector<SimulationStats> worker_stats(scheduler_.GetNumThreads());
+    scheduler_.ParallelFor(num_games, CHUNK_GAMES, [&](size_t begin, size_t end, size_t worker) {
+        for (size_t game = begin; game < end; ++game) {
+            Philox4x32 rng(seed, game);
+            PlayGame(start, *policies_[worker], rng, worker_stats[worker]);
+        }
+    });
+
+    // Integer totals, the merge order does not matter
+    SimulationStats stats;
+    for (const SimulationStats &part : worker_stats) {
+        stats.Merge(part);
+    }
+    return stats;
+}
+
+size_t Simulator::PlayGame(const GameState &start, Policy &policy, Philox4x32 &rng, SimulationStats &stats) {
+    GameState state = start;
+    size_t score = SheetPoints(start);
+    size_t yahtzee_bonuses = 0;
+    MoveList moves;
+
+    for (size_t turns = OpenCategories(start); turns > 0;) {
+        if (state.GetCurrentDice().total() != NUM_DICE) {
+            state.SetCurrentDice(RollDice(DiceCounts{}, 0, rng));
+            state.SetRemainingRerolls(2);
+        }
+
+        GetPossibleMoves(state, moves);
+        const size_t choice = policy.ChooseMove(state, moves);
+        if (choice >= moves.size()) {
+            throw std::out_of_range("Policy chose a move that does not exist");
+        }
+        const CompactMove move = moves[choice];
+
+        if (move.IsReroll()) {
+            const KeepIndex keep = move.GetKeepIndex();
+            state.SetCurrentDice(RollDice(KEEP_TABLE.counts[keep], KEEP_TABLE.size[keep], rng));
+            state.SetRemainingRerolls(state.GetRemainingRerolls() - 1);
+            continue;
+        }
+
+        const RollIndex roll = state.GetCurrentDice().roll_index();
+        if (ROLL_TABLE.is_yahtzee[roll] && state.GetCategoryScore(Category::Yahtzee) == YAHTZEE_SCORE) {
+            ++yahtzee_bonuses;
+        }
+        score += MakeMove(state, move).score_delta;
+        state.SetCurrentDice(Dice());
+        --turns;
+    }
+
+    stats.AddGame(state, score, yahtzee_bonuses);
+    return score;
+}
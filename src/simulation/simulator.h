@@ -0,0 +1,61 @@
+#pragma once
+
+#include "philox.h"
+#include "policy.h"
+#include "../game_state/category.h"
+#include "../game_state/game_state.h"
+#include "../solver/task_scheduler.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+// Totals over simulated games
+struct SimulationStats {
+    uint64_t num_games{0};
+    std::vector<uint64_t> score_histogram;                     // games per final score
+    std::array<uint64_t, NUM_CATEGORIES> category_scored{};    // games where the category scored points
+    uint64_t upper_bonus_games{0};                             // games that reached the upper bonus
+    // Games per number of extra yahtzees: yahtzees rolled and scored after the
+    // yahtzee box already holds 50, the rolls the yahtzee bonus rule is about
+    std::vector<uint64_t> yahtzee_bonus_histogram;
+
+    double GetMeanScore() const;
+    double GetCategoryFillRate(Category category) const;
+    double GetUpperBonusRate() const;
+    uint64_t GetYahtzeeBonusCount() const;
+
+    void AddGame(const GameState &final_state, size_t score, size_t yahtzee_bonuses);
+    void Merge(const SimulationStats &other);
+};
+
+// Plays complete games with real dice under a policy.
+//
+// Moves come from GetPossibleMoves and score moves are applied with
+// ApplyMove; rerolls keep the chosen dice and roll the rest. Game i draws
+// its dice from Philox4x32(seed, i), so a run is reproducible for a seed
+// whatever the thread count. Games are spread over a TaskScheduler with one
+// policy per worker.
+class Simulator {
+public:
+    using PolicyFactory = std::function<std::unique_ptr<Policy>()>;
+
+    // num_threads == 0 uses all hardware threads
+    explicit Simulator(const PolicyFactory &make_policy, size_t num_threads = 0);
+
+    // Plays num_games games from the state. Without a full roll showing, the
+    // games start with the first roll of a turn.
+    SimulationStats Run(const GameState &start, size_t num_games, uint64_t seed);
+
+    // Plays one game to the end and adds it to the stats, returns its final score
+    static size_t PlayGame(const GameState &start, Policy &policy, Philox4x32 &rng, SimulationStats &stats);
+
+private:
+    static constexpr size_t CHUNK_GAMES = 64;
+
+    TaskScheduler scheduler_;
+    std::vector<std::unique_ptr<Policy>> policies_;
+};
@@ -0,0 +1,67 @@
+#include "advisor.h"
+#include "../game_state/short_game_state.h"
+#include "../metrics/metrics.h"
+
+#include <stdexcept>
+
+Advisor::Advisor(const double *state_values, TableLayout layout, const PolicyTable *policy)
+    : evaluator_(state_values, layout), policy_(policy) {}
+
+Advisor::Advisor(const QuantizedTable &table, const PolicyTable *policy)
+    : evaluator_(table), quantized_(&table), policy_(policy) {}
+
+void Advisor::Advise(const GameState &state, Advice &advice) {
+    CountMetric(MetricCounter::AdvisorQueries);
+    ScopedMetricTimer timer(MetricHistogram::AdvisorQueryNanoseconds);
+    const Dice &dice = state.GetCurrentDice();
+    if (dice.total() != NUM_DICE) {
+        throw std::invalid_argument("Advice needs a full roll of five dice");
+    }
+    const RollIndex roll = dice.roll_index();
+    const size_t rerolls = state.GetRemainingRerolls();
+
+    const ShortStateKey key = ShortGameState(state).GetKey();
+
+    GetPossibleMoves(state, advice.moves);
+    evaluator_.Evaluate(key, rerolls > 0 ? rerolls - 1 : 0);
+
+    advice.best = 0;
+    for (size_t i = 0; i < advice.moves.size(); ++i) {
+        CompactMove move = advice.moves[i];
+        advice.values[i] = move.IsReroll() ? evaluator_.GetKeepValue(rerolls, move.GetKeepIndex())
+                                           : evaluator_.GetScoreValue(roll, move.GetCategory());
+        if (advice.values[i] > advice.values[advice.best]) {
+            advice.best = i;
+        }
+    }
+    // Corrections cover the rerolls of a turn, the decisions of a third belong to no state
+    if (quantized_ != nullptr && rerolls <= TurnEvaluator::TURN_REROLLS) {
+        const uint8_t code = quantized_->GetCorrection(key, PolicyTable::GetDecision(rerolls, roll));
+        if (code != QuantizedTable::NO_CORRECTION) {
+            const CompactMove best = PolicyTable::DecodeMove(code, roll);
+            for (size_t i = 0; i < advice.moves.size(); ++i) {
+                if (advice.moves[i] == best) {
+                    advice.best = i;
+                }
+            }
+        }
+    }
+}
+
+Advice Advisor::Advise(const GameState &state) {
+    Advice advice;
+    Advise(state, advice);
+    return advice;
+}
+
+CompactMove Advisor::GetBestMove(const GameState &state) {
+    if (policy_ != nullptr) {
+        if (std::optional<CompactMove> move = policy_->FindBestMove(state)) {
+            CountMetric(MetricCounter::PolicyLookups);
+            return *move;
+        }
+    }
+    // No policy, or none for this state: an endgame policy leaves the earlier layers out
+    Advise(state, advice_);
+    return advice_.GetBestMove();
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "policy_table.h"
+#include "quantized_table.h"
+#include "turn_evaluator.h"
+#include "../game_state/game_state.h"
+#include "../move/move_list.h"
+
+#include <array>
+#include <cstddef>
+
+// Every possible move of a decision with its expected value
+struct Advice {
+    MoveList moves;
+    // Expected score of the rest of the game after each move, its own points included
+    std::array<double, MoveList::MAX_MOVES> values{};
+    size_t best{0};  // index of the best move in moves
+
+    CompactMove GetBestMove() const { return moves[best]; }
+    double GetBestValue() const { return values[best]; }
+};
+
+// Answers best-move queries for live games from a table of turn-start values
+// (Solver::GetValues() or a mapped StrategyTable with its layout). Keeps the turn of the last
+// queried state, so later decisions of the same turn only evaluate their own
+// keeps. With a PolicyTable of the same values, GetBestMove is a table lookup
+// wherever the policy has a move. Over a QuantizedTable the values are
+// approximate and the best move follows the corrections of the table: with
+// those of every decision, it is worth the exact best move to within
+// DECISION_TOLERANCE.
+// Not thread-safe, use one advisor per thread; never allocates.
+class Advisor {
+public:
+    explicit Advisor(const double *state_values, TableLayout layout = TableLayout::ShortStateKeyDense,
+                     const PolicyTable *policy = nullptr);
+    // Reads the values from the table, which must outlive the advisor
+    explicit Advisor(const QuantizedTable &table, const PolicyTable *policy = nullptr);
+
+    // The current dice must be a full roll of five dice
+    void Advise(const GameState &state, Advice &advice);
+    Advice Advise(const GameState &state);
+
+    // Best move of Advise, from the policy when it has a move for the decision
+    CompactMove GetBestMove(const GameState &state);
+
+private:
+    TurnEvaluator evaluator_;
+    const QuantizedTable *quantized_{nullptr};
+    const PolicyTable *policy_;
+    Advice advice_;
+};
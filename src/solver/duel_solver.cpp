@@ -0,0 +1,516 @@
+#include "duel_solver.h"
+#include "row_kernels.h"
+#include "table_layout.h"
+#include "threshold_solver.h"
+#include "turn_evaluator.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <stdexcept>
+
+namespace {
+
+// Row entries: offset in the values of the turn, first stored index, number stored
+constexpr size_t ROW_OFFSET_BITS = 40;
+constexpr size_t ROW_INDEX_BITS = 12;
+constexpr uint64_t MAX_ROW_OFFSET = (uint64_t{1} << ROW_OFFSET_BITS) - 1;
+constexpr uint64_t ROW_INDEX_MASK = (uint64_t{1} << ROW_INDEX_BITS) - 1;
+
+// Longest row: leads from -1575 to 1575, both players with an empty sheet
+constexpr size_t MAX_ROW_LENGTH = 2 * ThresholdSolver::MAX_REMAINING_SCORE + 1;
+static_assert(MAX_ROW_LENGTH <= ROW_INDEX_MASK, "Row indices must fit their fields");
+
+constexpr size_t MAX_STRIDE = (MAX_ROW_LENGTH + ROW_ALIGNMENT - 1) / ROW_ALIGNMENT * ROW_ALIGNMENT;
+
+// Flipped next-state rows are cached per (category, variant) as in ThresholdSolver
+constexpr size_t SLOT_VARIANTS = NUM_DICE + 1;
+constexpr size_t NUM_SLOTS = NUM_CATEGORIES * SLOT_VARIANTS;
+constexpr size_t SLOT_SIZE = MAX_STRIDE + MAX_MOVE_POINTS;
+
+constexpr uint64_t PackRow(uint64_t offset, size_t first, size_t size) {
+    return offset | (uint64_t{first} << ROW_OFFSET_BITS) | (uint64_t{size} << (ROW_OFFSET_BITS + ROW_INDEX_BITS));
+}
+
+constexpr size_t RowFirst(uint64_t row) {
+    return static_cast<size_t>((row >> ROW_OFFSET_BITS) & ROW_INDEX_MASK);
+}
+
+constexpr size_t RowSize(uint64_t row) {
+    return static_cast<size_t>(row >> (ROW_OFFSET_BITS + ROW_INDEX_BITS));
+}
+
+// Value of a finished game for the player with the given lead
+double FinalValue(long lead) {
+    return lead > 0 ? 1.0 : lead == 0 ? 0.5 : 0.0;
+}
+
+double LookupWinProbability(const DuelLayerView *layers, size_t num_layers, ShortStateKey mover, ShortStateKey other,
+                            int lead) {
+    if (mover.IsGameOver() && other.IsGameOver()) {
+        return FinalValue(lead);
+    }
+    for (size_t i = 0; i < num_layers; ++i) {
+        const DuelLayerView &layer = layers[i];
+        if (layer.mover_filled != mover.FilledCount() || layer.other_filled != other.FilledCount()) {
+            continue;
+        }
+        const size_t pair = layer.FindPair(mover, other);
+        if (pair != SIZE_MAX) {
+            return layer.GetValue(pair, static_cast<long>(lead) + static_cast<long>(GetMaxRemainingScore(mover)));
+        }
+    }
+    throw std::out_of_range("Position is not in the duel table");
+}
+
+// Row of one turn of the mover against one opponent state, given the rows of the next turn
+class DuelTurnEvaluator {
+public:
+    DuelTurnEvaluator()
+        : kernels_(GetRowKernels()), slots_(NUM_SLOTS * SLOT_SIZE), score_rows_(NUM_ROLLS * MAX_STRIDE),
+          roll_rows_(NUM_ROLLS * MAX_STRIDE), reroll_rows_(NUM_ROLLS * MAX_STRIDE),
+          keep_rows_(NUM_PARTIAL_KEEPS * MAX_STRIDE), result_(MAX_STRIDE) {}
+
+    // Row for the leads [-GetMaxRemainingScore(mover), GetMaxRemainingScore(other)].
+    // next is the following turn, where other is mover number other_index;
+    // nullptr when this turn ends the game.
+    const float *Evaluate(ShortStateKey mover, ShortStateKey other, size_t other_index, const DuelLayerView *next) {
+        const size_t length = GetMaxRemainingScore(mover) + GetMaxRemainingScore(other) + 1;
+        const size_t stride = (length + ROW_ALIGNMENT - 1) / ROW_ALIGNMENT * ROW_ALIGNMENT;
+
+        PrepareScoreMoves(mover, other_index, next, length);
+        kernels_.score_rows(sources_.data(), source_offsets_.data(), score_rows_.data(), length, stride);
+
+        kernels_.reduce_keeps(score_rows_.data(), keep_rows_.data(), length, stride);
+        kernels_.max_rolls(score_rows_.data(), keep_rows_.data(), score_rows_.data(), roll_rows_.data(), length,
+                           stride);
+        kernels_.reduce_keeps(roll_rows_.data(), keep_rows_.data(), length, stride);
+        kernels_.max_rolls(score_rows_.data(), keep_rows_.data(), roll_rows_.data(), reroll_rows_.data(), length,
+                           stride);
+
+        kernels_.turn_start(reroll_rows_.data(), result_.data(), length, stride);
+        return result_.data();
+    }
+
+private:
+    // A score move of p points into next_key is worth 1 - W(other, next_key,
+    // -(lead + p)) to the mover. The slot of next_key holds that value for
+    // lead + p, indexed like the row of the mover, so the move reads it p
+    // entries further on. Past the end of the row the opponent cannot catch up.
+    void PrepareScoreMoves(ShortStateKey mover, size_t other_index, const DuelLayerView *next, size_t length) {
+        slot_decoded_.fill(false);
+        sources_.clear();
+        for (size_t roll = 0; roll < NUM_ROLLS; ++roll) {
+            source_offsets_[roll] = static_cast<uint16_t>(sources_.size());
+            const uint32_t allowed = GetAllowedCategoryMask(mover, static_cast<RollIndex>(roll));
+            for (size_t category = 0; category < NUM_CATEGORIES; ++category) {
+                if (!(allowed & (uint32_t{1} << category))) {
+                    continue;
+                }
+                ScoreOutcome outcome =
+                    GetScoreOutcome(mover, static_cast<RollIndex>(roll), static_cast<Category>(category));
+                const size_t variant = category < NUM_UPPER_CATEGORIES
+                                           ? ROLL_TABLE.counts[roll][category]
+                                           : outcome.next.IsYahtzeeRecorded() != mover.IsYahtzeeRecorded();
+                const size_t slot = category * SLOT_VARIANTS + variant;
+                float *row = slots_.data() + slot * SLOT_SIZE;
+                if (!slot_decoded_[slot]) {
+                    DecodeFlipped(outcome.next, other_index, next, length, row);
+                    slot_decoded_[slot] = true;
+                }
+                sources_.push_back(row + outcome.points);
+            }
+        }
+        source_offsets_[NUM_ROLLS] = static_cast<uint16_t>(sources_.size());
+    }
+
+    // out[j] = 1 - W(other, next_key) at row index length - 1 - j of the opponent
+    static void DecodeFlipped(ShortStateKey next_key, size_t other_index, const DuelLayerView *next, size_t length,
+                              float *out) {
+        const size_t size = length + MAX_MOVE_POINTS;
+        if (next == nullptr) {
+            // Both sheets full: the opponent's row is the single lead 0
+            for (size_t j = 0; j < size; ++j) {
+                out[j] = j + 1 < length ? 0.0f : j + 1 == length ? 0.5f : 1.0f;
+            }
+            return;
+        }
+        const size_t pair = next->FindPair(other_index, next_key);
+        const uint64_t row = next->rows[pair];
+        const uint16_t *values = next->values + (row & MAX_ROW_OFFSET);
+        const long first = static_cast<long>(RowFirst(row));
+        const long last = first + static_cast<long>(RowSize(row));
+        constexpr float scale = 1.0f / static_cast<float>(DuelSolver::QUANTUM);
+        for (size_t j = 0; j < size; ++j) {
+            const long k = static_cast<long>(length) - 1 - static_cast<long>(j);
+            out[j] = k < first ? 1.0f : k >= last ? 0.0f : 1.0f - static_cast<float>(values[k - first]) * scale;
+        }
+    }
+
+    const RowKernels &kernels_;
+    std::vector<float> slots_;
+    std::array<bool, NUM_SLOTS> slot_decoded_{};
+    std::vector<const float *> sources_;
+    std::array<uint16_t, NUM_ROLLS + 1> source_offsets_{};
+    std::vector<float> score_rows_;
+    std::vector<float> roll_rows_;
+    std::vector<float> reroll_rows_;
+    std::vector<float> keep_rows_;
+    std::vector<float> result_;
+};
+
+template<typename T>
+void AppendArray(std::vector<unsigned char> &data, const std::vector<T> &values, uint64_t &offset) {
+    data.resize((data.size() + 7) / 8 * 8, 0);
+    offset = data.size();
+    const unsigned char *bytes = reinterpret_cast<const unsigned char *>(values.data());
+    data.insert(data.end(), bytes, bytes + values.size() * sizeof(T));
+}
+
+}  // namespace
+
+size_t DuelLayerView::FindPair(ShortStateKey mover, ShortStateKey other) const {
+    const uint32_t *m = std::lower_bound(movers, movers + num_movers, mover.Value());
+    if (m == movers + num_movers || *m != mover.Value()) {
+        return SIZE_MAX;
+    }
+    return FindPair(static_cast<size_t>(m - movers), other);
+}
+
+size_t DuelLayerView::FindPair(size_t mover_index, ShortStateKey other) const {
+    const uint32_t *o = std::lower_bound(others, others + num_others, other.Value());
+    if (o == others + num_others || *o != other.Value()) {
+        return SIZE_MAX;
+    }
+    return mover_index * num_others + static_cast<size_t>(o - others);
+}
+
+double DuelLayerView::GetValue(size_t pair, long index) const {
+    const uint64_t row = rows[pair];
+    const long first = static_cast<long>(RowFirst(row));
+    if (index < first) {
+        return 0.0;
+    }
+    if (index >= first + static_cast<long>(RowSize(row))) {
+        return 1.0;
+    }
+    return static_cast<double>(values[(row & MAX_ROW_OFFSET) + static_cast<size_t>(index - first)]) /
+           DuelSolver::QUANTUM;
+}
+
+DuelLayerView DuelSolver::Layer::View() const {
+    DuelLayerView view;
+    view.turn = turn;
+    view.mover_filled = movers.empty() ? 0 : ShortStateKey::FromIndex(movers.front()).FilledCount();
+    view.other_filled = others.empty() ? 0 : ShortStateKey::FromIndex(others.front()).FilledCount();
+    view.movers = movers.data();
+    view.num_movers = movers.size();
+    view.others = others.data();
+    view.num_others = others.size();
+    view.rows = rows.data();
+    view.values = values.data();
+    view.num_values = values.size();
+    return view;
+}
+
+DuelSolver::DuelSolver(ShortStateKey first, ShortStateKey second) : first_(first), second_(second) {
+    if (!IsReachable(first) || !IsReachable(second)) {
+        throw std::invalid_argument("Duel states must be reachable");
+    }
+    if (second.FilledCount() != first.FilledCount() && second.FilledCount() != first.FilledCount() + 1) {
+        throw std::invalid_argument("The player to move must have as many used categories as the other or one less");
+    }
+    const ShortStateKey starts[2] = {first, second};
+    std::vector<ShortStateKey> successors;
+    for (size_t player = 0; player < 2; ++player) {
+        auto &states = player_states_[player];
+        states.push_back({starts[player].Value()});
+        for (size_t filled = starts[player].FilledCount(); filled < NUM_CATEGORIES; ++filled) {
+            std::vector<uint32_t> next;
+            for (uint32_t value : states.back()) {
+                GetSuccessors(ShortStateKey::FromIndex(value), successors);
+                for (ShortStateKey key : successors) {
+                    next.push_back(key.Value());
+                }
+            }
+            std::sort(next.begin(), next.end());
+            next.erase(std::unique(next.begin(), next.end()), next.end());
+            states.push_back(std::move(next));
+        }
+    }
+    num_turns_ = 2 * NUM_CATEGORIES - first.FilledCount() - second.FilledCount();
+}
+
+void DuelSolver::Solve(size_t num_threads, const std::string &checkpoint_path, size_t checkpoint_turns) {
+    if (checkpoint_turns == 0) {
+        throw std::invalid_argument("Checkpoints need at least one turn between them");
+    }
+    TaskScheduler scheduler(num_threads);
+    layers_.clear();
+    layer_stats_.clear();
+    UpdateViews();
+    if (!checkpoint_path.empty()) {
+        LoadCheckpoint(checkpoint_path);
+    }
+    size_t unsaved_turns = 0;
+    while (GetFirstSolvedTurn() > 0) {
+        SolveTurn(GetFirstSolvedTurn() - 1, scheduler);
+        ++unsaved_turns;
+        if (!checkpoint_path.empty() && (unsaved_turns == checkpoint_turns || GetFirstSolvedTurn() == 0)) {
+            WriteTable(checkpoint_path);
+            unsaved_turns = 0;
+        }
+    }
+}
+
+void DuelSolver::SolveTurn(size_t turn, size_t num_threads) {
+    TaskScheduler scheduler(num_threads);
+    SolveTurn(turn, scheduler);
+}
+
+void DuelSolver::SolveTurn(size_t turn, TaskScheduler &scheduler) {
+    if (turn + 1 != GetFirstSolvedTurn()) {
+        throw std::invalid_argument("Duel turns must be solved from the end of the game back");
+    }
+    // The first player moves on even turns
+    const size_t mover_player = turn % 2;
+    Layer layer;
+    layer.turn = static_cast<uint32_t>(turn);
+    layer.movers = player_states_[mover_player][turn / 2];
+    layer.others = player_states_[1 - mover_player][(turn + 1) / 2];
+
+    DuelLayerView next_view;
+    const DuelLayerView *next = nullptr;
+    if (turn + 1 < num_turns_) {
+        next_view = GetLayer(turn + 1).View();
+        next = &next_view;
+    }
+
+    const size_t num_others = layer.others.size();
+    const size_t num_pairs = layer.movers.size() * num_others;
+    const size_t num_workers = scheduler.GetNumThreads();
+    std::vector<std::unique_ptr<DuelTurnEvaluator>> evaluators;
+    for (size_t worker = 0; worker < num_workers; ++worker) {
+        evaluators.push_back(std::make_unique<DuelTurnEvaluator>());
+    }
+    std::vector<std::vector<uint16_t>> worker_data(num_workers);
+    std::vector<uint16_t> pair_workers(num_pairs);
+    layer.rows.resize(num_pairs);
+
+    ParallelForStats stats = scheduler.ParallelFor(num_pairs, CHUNK_PAIRS,
+                                                   [&](size_t begin, size_t end, size_t worker) {
+        std::vector<uint16_t> &data = worker_data[worker];
+        for (size_t pair = begin; pair < end; ++pair) {
+            const ShortStateKey mover = ShortStateKey::FromIndex(layer.movers[pair / num_others]);
+            const ShortStateKey other = ShortStateKey::FromIndex(layer.others[pair % num_others]);
+            const size_t length = GetMaxRemainingScore(mover) + GetMaxRemainingScore(other) + 1;
+            const float *row = evaluators[worker]->Evaluate(mover, other, pair % num_others, next);
+
+            auto quantize = [&](size_t index) {
+                float clamped = std::min(std::max(row[index], 0.0f), 1.0f);
+                return static_cast<uint16_t>(std::lround(clamped * static_cast<float>(QUANTUM)));
+            };
+            size_t first = 0;
+            while (first < length && quantize(first) == 0) {
+                ++first;
+            }
+            size_t last = length;
+            while (last > first && quantize(last - 1) == QUANTUM) {
+                --last;
+            }
+            layer.rows[pair] = PackRow(data.size(), first, last - first);
+            for (size_t index = first; index < last; ++index) {
+                data.push_back(quantize(index));
+            }
+            pair_workers[pair] = static_cast<uint16_t>(worker);
+        }
+    });
+
+    std::vector<uint64_t> worker_base(num_workers);
+    for (size_t worker = 0; worker < num_workers; ++worker) {
+        worker_base[worker] = layer.values.size();
+        layer.values.insert(layer.values.end(), worker_data[worker].begin(), worker_data[worker].end());
+        std::vector<uint16_t>().swap(worker_data[worker]);
+    }
+    if (layer.values.size() > MAX_ROW_OFFSET) {
+        throw std::runtime_error("Duel turn exceeds the row offsets");
+    }
+    for (size_t pair = 0; pair < num_pairs; ++pair) {
+        layer.rows[pair] += worker_base[pair_workers[pair]];
+    }
+
+    LayerStats stat;
+    const DuelLayerView view = layer.View();
+    stat.filled_count = view.mover_filled + view.other_filled;
+    stat.num_states = num_pairs;
+    stat.num_threads = num_workers;
+    stat.seconds = stats.seconds;
+    stat.imbalance = stats.Imbalance();
+    stat.steals = stats.steals;
+    layer_stats_.push_back(stat);
+    layers_.insert(layers_.begin(), std::move(layer));
+    UpdateViews();
+}
+
+bool DuelSolver::LoadCheckpoint(const std::string &path) {
+    if (!std::filesystem::exists(path)) {
+        return false;
+    }
+    DuelTable table(path);
+    const DuelTable::DuelTableInfo &info = table.GetInfo();
+    if (!table.VerifyChecksum()) {
+        throw std::runtime_error(path + " has a corrupt data section");
+    }
+    if (info.first_key != first_.Value() || info.second_key != second_.Value() || info.num_turns != num_turns_) {
+        throw std::runtime_error(path + " holds the table of another position");
+    }
+    for (const DuelLayerView &view : table.GetLayers()) {
+        const size_t mover_player = view.turn % 2;
+        const auto &movers = player_states_[mover_player][view.turn / 2];
+        const auto &others = player_states_[1 - mover_player][(view.turn + 1) / 2];
+        if (!std::equal(movers.begin(), movers.end(), view.movers, view.movers + view.num_movers) ||
+            !std::equal(others.begin(), others.end(), view.others, view.others + view.num_others)) {
+            throw std::runtime_error(path + " holds the table of another position");
+        }
+        Layer layer;
+        layer.turn = view.turn;
+        layer.movers = movers;
+        layer.others = others;
+        layer.rows.assign(view.rows, view.rows + view.num_movers * view.num_others);
+        layer.values.assign(view.values, view.values + view.num_values);
+        layers_.push_back(std::move(layer));
+    }
+    UpdateViews();
+    return true;
+}
+
+void DuelSolver::UpdateViews() {
+    views_.clear();
+    for (const Layer &layer : layers_) {
+        views_.push_back(layer.View());
+    }
+}
+
+double DuelSolver::GetWinProbability(ShortStateKey mover, ShortStateKey other, int lead) const {
+    return LookupWinProbability(views_.data(), views_.size(), mover, other, lead);
+}
+
+double DuelSolver::GetWinProbability(const ShortGameState &mover, const ShortGameState &other, int lead) const {
+    return GetWinProbability(mover.GetKey(), other.GetKey(), lead);
+}
+
+void DuelSolver::WriteTable(const std::string &path) const {
+    DuelTable::DuelTableInfo info{};
+    info.first_key = first_.Value();
+    info.second_key = second_.Value();
+    info.num_turns = static_cast<uint32_t>(num_turns_);
+    info.first_solved_turn = static_cast<uint32_t>(GetFirstSolvedTurn());
+
+    std::vector<DuelTable::DuelLayerInfo> infos(layers_.size());
+    std::vector<unsigned char> data(sizeof(info) + infos.size() * sizeof(DuelTable::DuelLayerInfo));
+    uint64_t num_values = 0;
+    for (size_t i = 0; i < layers_.size(); ++i) {
+        const Layer &layer = layers_[i];
+        const DuelLayerView view = layer.View();
+        DuelTable::DuelLayerInfo &layer_info = infos[i];
+        layer_info.turn = layer.turn;
+        layer_info.mover_filled = view.mover_filled;
+        layer_info.other_filled = view.other_filled;
+        layer_info.num_movers = static_cast<uint32_t>(layer.movers.size());
+        layer_info.num_others = static_cast<uint32_t>(layer.others.size());
+        layer_info.num_values = layer.values.size();
+        AppendArray(data, layer.movers, layer_info.movers_offset);
+        AppendArray(data, layer.others, layer_info.others_offset);
+        AppendArray(data, layer.rows, layer_info.rows_offset);
+        AppendArray(data, layer.values, layer_info.values_offset);
+        num_values += layer.values.size();
+    }
+    std::memcpy(data.data(), &info, sizeof(info));
+    if (!infos.empty()) {
+        std::memcpy(data.data() + sizeof(info), infos.data(), infos.size() * sizeof(DuelTable::DuelLayerInfo));
+    }
+
+    StrategyFileHeader header{};
+    header.rule_variant = static_cast<uint32_t>(RuleVariant::Yahtzee);
+    header.layout = static_cast<uint32_t>(TableLayout::DuelPairRows);
+    header.element_type = static_cast<uint32_t>(ElementType::Fixed16);
+    header.element_size = sizeof(uint16_t);
+    header.num_elements = num_values;
+    WriteStrategyFileData(path, header, data.data(), data.size());
+}
+
+size_t DuelSolver::GetStorageBytes() const {
+    size_t bytes = 0;
+    for (const Layer &layer : layers_) {
+        bytes += (layer.movers.size() + layer.others.size()) * sizeof(uint32_t) +
+                 layer.rows.size() * sizeof(uint64_t) + layer.values.size() * sizeof(uint16_t);
+    }
+    return bytes;
+}
+
+const std::vector<LayerStats> &DuelSolver::GetLayerStats() const {
+    return layer_stats_;
+}
+
+DuelTable::DuelTable(const std::string &path) : file_(path) {
+    const StrategyFileHeader &header = GetHeader();
+    CheckStrategyFileHeader(path, header, file_.GetSize());
+    if (header.layout != static_cast<uint32_t>(TableLayout::DuelPairRows) ||
+        header.element_type != static_cast<uint32_t>(ElementType::Fixed16) ||
+        header.element_size != sizeof(uint16_t) || header.data_size < sizeof(DuelTableInfo)) {
+        throw std::runtime_error(path + " has an unsupported layout");
+    }
+    const unsigned char *data = file_.GetData() + header.data_offset;
+    const uint64_t size = header.data_size;
+    const DuelTableInfo &info = GetInfo();
+    if (info.first_solved_turn > info.num_turns ||
+        sizeof(DuelTableInfo) + (info.num_turns - info.first_solved_turn) * sizeof(DuelLayerInfo) > size) {
+        throw std::runtime_error(path + " is truncated");
+    }
+    auto fits = [&](uint64_t offset, uint64_t count, size_t element_size) {
+        return offset % 8 == 0 && offset <= size && count <= (size - offset) / element_size;
+    };
+    const DuelLayerInfo *infos = reinterpret_cast<const DuelLayerInfo *>(data + sizeof(DuelTableInfo));
+    for (uint32_t i = 0; i < info.num_turns - info.first_solved_turn; ++i) {
+        const DuelLayerInfo &layer_info = infos[i];
+        const uint64_t num_pairs = uint64_t{layer_info.num_movers} * layer_info.num_others;
+        if (!fits(layer_info.movers_offset, layer_info.num_movers, sizeof(uint32_t)) ||
+            !fits(layer_info.others_offset, layer_info.num_others, sizeof(uint32_t)) ||
+            !fits(layer_info.rows_offset, num_pairs, sizeof(uint64_t)) ||
+            !fits(layer_info.values_offset, layer_info.num_values, sizeof(uint16_t))) {
+            throw std::runtime_error(path + " is truncated");
+        }
+        DuelLayerView view;
+        view.turn = layer_info.turn;
+        view.mover_filled = layer_info.mover_filled;
+        view.other_filled = layer_info.other_filled;
+        view.movers = reinterpret_cast<const uint32_t *>(data + layer_info.movers_offset);
+        view.num_movers = layer_info.num_movers;
+        view.others = reinterpret_cast<const uint32_t *>(data + layer_info.others_offset);
+        view.num_others = layer_info.num_others;
+        view.rows = reinterpret_cast<const uint64_t *>(data + layer_info.rows_offset);
+        view.values = reinterpret_cast<const uint16_t *>(data + layer_info.values_offset);
+        view.num_values = layer_info.num_values;
+        layers_.push_back(view);
+    }
+}
+
+const StrategyFileHeader &DuelTable::GetHeader() const {
+    return *reinterpret_cast<const StrategyFileHeader *>(file_.GetData());
+}
+
+const DuelTable::DuelTableInfo &DuelTable::GetInfo() const {
+    return *reinterpret_cast<const DuelTableInfo *>(file_.GetData() + GetHeader().data_offset);
+}
+
+bool DuelTable::VerifyChecksum() const {
+    const StrategyFileHeader &header = GetHeader();
+    return Checksum64(file_.GetData() + header.data_offset, header.data_size) == header.data_checksum;
+}
+
+double DuelTable::GetWinProbability(ShortStateKey mover, ShortStateKey other, int lead) const {
+    return LookupWinProbability(layers_.data(), layers_.size(), mover, other, lead);
+}
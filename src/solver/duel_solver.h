@@ -0,0 +1,196 @@
+#pragma once
+
+#include "../game_state/short_game_state.h"
+#include "../game_state/short_state_key.h"
+#include "solver.h"
+#include "strategy_file.h"
+#include "task_scheduler.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Rows of one turn of a duel, held by a DuelSolver or mapped from a DuelTable.
+//
+// The turn pairs every state the player to move can have (movers) with every
+// state of the opponent (others), both sorted by key value; pair
+// m * num_others + o has a row over the lead of the mover, see DuelSolver.
+// A row entry packs the offset of its values (bits 0-39), the first stored
+// row index (bits 40-51) and the number of stored values (bits 52-63).
+struct DuelLayerView {
+    uint32_t turn{0};
+    uint32_t mover_filled{0};  // used categories of the movers
+    uint32_t other_filled{0};
+    const uint32_t *movers{nullptr};
+    size_t num_movers{0};
+    const uint32_t *others{nullptr};
+    size_t num_others{0};
+    const uint64_t *rows{nullptr};
+    const uint16_t *values{nullptr};
+    size_t num_values{0};
+
+    // Pair of the keys, or SIZE_MAX when the turn does not hold it
+    size_t FindPair(ShortStateKey mover, ShortStateKey other) const;
+    size_t FindPair(size_t mover_index, ShortStateKey other) const;
+
+    // Row of the pair at index lead + GetMaxRemainingScore(mover)
+    double GetValue(size_t pair, long index) const;
+};
+
+// Retrograde solver for the chance of winning a two-player game.
+//
+// Maximising the expected score is not the same as maximising the chance to
+// beat an opponent: a player far behind has to gamble, a player far ahead
+// should play safe. The value of a position is P(win) + P(tie) / 2 for the
+// player about to start a turn, given the turn-start states of both players
+// and the lead: the points of the mover minus the points of the opponent.
+// Both play to maximise their own value, which is one minus the other's.
+//
+// A solve starts from one position and only visits the states both players
+// can reach from it. Turns alternate, so turn t pairs the states of the mover
+// after t / 2 of their turns with those of the opponent after (t + 1) / 2,
+// and is solved from the rows of turn t + 1 alone, as a row over the lead
+// with the same row loops as ThresholdSolver. Every turn is a product of two
+// state sets, so the pairs of a turn are spread over a TaskScheduler in small
+// chunks. Rows keep only the part between certain loss and certain win,
+// quantized to 16 bits.
+//
+// The number of pairs grows with the square of the states per layer: a few
+// thousand per player late in the game, millions per turn in the middle. A
+// solve from the start of a game is out of reach of one machine; the solver
+// is meant for positions from the second half of a game on.
+class DuelSolver {
+public:
+    static constexpr uint32_t QUANTUM = 65535;
+    static constexpr size_t DEFAULT_CHECKPOINT_TURNS = 4;
+
+    // first moves next. second has the same number of used categories (first
+    // started the game) or one more (second started); throws
+    // std::invalid_argument for anything else or unreachable keys.
+    DuelSolver(ShortStateKey first, ShortStateKey second);
+
+    // The layer views point into the layers, which moves keep but copies do not
+    DuelSolver(const DuelSolver &) = delete;
+    DuelSolver &operator=(const DuelSolver &) = delete;
+    DuelSolver(DuelSolver &&) = default;
+    DuelSolver &operator=(DuelSolver &&) = default;
+
+    // Solves every turn from the end of the game back to the start position;
+    // num_threads == 0 uses all hardware threads. With a checkpoint path the
+    // table is written there after every checkpoint_turns turns and at the end,
+    // and a solve finding a table of the same position there resumes after its
+    // last turn. Every write holds the whole table, so writing after each turn
+    // would cost as much IO as the solve itself late in a game.
+    void Solve(size_t num_threads = 0, const std::string &checkpoint_path = "",
+               size_t checkpoint_turns = DEFAULT_CHECKPOINT_TURNS);
+
+    // Solves one turn; every later turn must already be solved
+    void SolveTurn(size_t turn, size_t num_threads = 0);
+
+    ShortStateKey GetFirstKey() const { return first_; }
+    ShortStateKey GetSecondKey() const { return second_; }
+
+    // Turns until both sheets are full
+    size_t GetNumTurns() const { return num_turns_; }
+
+    // Earliest solved turn, GetNumTurns() before any
+    size_t GetFirstSolvedTurn() const { return num_turns_ - layers_.size(); }
+
+    // P(win) + P(tie) / 2 of the mover at the start of their turn, for a
+    // position of a solved turn; throws std::out_of_range for other positions
+    double GetWinProbability(ShortStateKey mover, ShortStateKey other, int lead) const;
+    double GetWinProbability(const ShortGameState &mover, const ShortGameState &other, int lead) const;
+
+    // Writes the solved turns as a table for DuelTable; throws std::runtime_error on IO errors
+    void WriteTable(const std::string &path) const;
+
+    // Bytes held by the rows and their index
+    size_t GetStorageBytes() const;
+
+    // Turns in the order solved; filled_count is the used categories of both
+    // players and num_states the number of pairs
+    const std::vector<LayerStats> &GetLayerStats() const;
+
+private:
+    struct Layer {
+        uint32_t turn{0};
+        std::vector<uint32_t> movers;
+        std::vector<uint32_t> others;
+        std::vector<uint64_t> rows;
+        std::vector<uint16_t> values;
+
+        DuelLayerView View() const;
+    };
+
+    static constexpr size_t CHUNK_PAIRS = 16;
+
+    void SolveTurn(size_t turn, TaskScheduler &scheduler);
+    bool LoadCheckpoint(const std::string &path);
+    void UpdateViews();
+
+    // Layer of a solved turn
+    const Layer &GetLayer(size_t turn) const { return layers_[turn - GetFirstSolvedTurn()]; }
+
+    ShortStateKey first_;
+    ShortStateKey second_;
+    size_t num_turns_{0};
+    // States of each player (0 first, 1 second) after the given number of their turns
+    std::vector<std::vector<uint32_t>> player_states_[2];
+    std::vector<Layer> layers_;  // solved turns from GetFirstSolvedTurn() on
+    std::vector<DuelLayerView> views_;  // of layers_, so that lookups allocate nothing
+    std::vector<LayerStats> layer_stats_;
+};
+
+// Read-only memory mapping of a table written by DuelSolver::WriteTable.
+//
+// The data section of the strategy file holds a DuelTableInfo, one
+// DuelLayerInfo per solved turn and then the key lists, row entries and
+// values of every turn at the offsets of its info, relative to the data
+// section. The header has the DuelPairRows layout and Fixed16 elements.
+class DuelTable {
+public:
+    struct DuelTableInfo {
+        uint32_t first_key;
+        uint32_t second_key;
+        uint32_t num_turns;
+        uint32_t first_solved_turn;
+    };
+
+    struct DuelLayerInfo {
+        uint32_t turn;
+        uint32_t mover_filled;
+        uint32_t other_filled;
+        uint32_t num_movers;
+        uint32_t num_others;
+        uint32_t reserved;
+        uint64_t movers_offset;
+        uint64_t others_offset;
+        uint64_t rows_offset;
+        uint64_t values_offset;
+        uint64_t num_values;
+    };
+
+    DuelTable() = default;
+    explicit DuelTable(const std::string &path);
+
+    bool IsOpen() const { return file_.IsOpen(); }
+    const StrategyFileHeader &GetHeader() const;
+    const DuelTableInfo &GetInfo() const;
+
+    // Reads the whole data section, so it is not done on open
+    bool VerifyChecksum() const;
+
+    // Rows of the solved turns, from GetInfo().first_solved_turn on
+    const std::vector<DuelLayerView> &GetLayers() const { return layers_; }
+
+    // Same as DuelSolver::GetWinProbability
+    double GetWinProbability(ShortStateKey mover, ShortStateKey other, int lead) const;
+
+private:
+    MappedFile file_;
+    std::vector<DuelLayerView> layers_;
+};
+
+static_assert(sizeof(DuelTable::DuelTableInfo) == 16, "Duel table layout must not change");
+static_assert(sizeof(DuelTable::DuelLayerInfo) == 64, "Duel table layout must not change");
@@ -0,0 +1,256 @@
+#include "expectimax.h"
+#include "../metrics/metrics.h"
+#include "../move/move_outcome.h"
+#include "../move/reroll_matrix.h"
+#include "turn_evaluator.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+// Nodes between two looks at the clock
+constexpr size_t DEADLINE_CHECK_NODES = 1024;
+
+// Deeper than the longest game, a depth field of 4 bits holds it
+constexpr size_t MAX_SEARCH_DEPTH = NUM_CATEGORIES;
+
+constexpr uint32_t FULL_MASK = ShortStateKey::FULL_MASK;
+
+// Keep of no dice, the first roll of a turn
+constexpr KeepIndex EMPTY_KEEP = 0;
+
+ShortStateKey TurnStartKey(const GameState &state) {
+    return ShortStateKey(state.GetFilledMask(), static_cast<uint32_t>(state.GetRemainingUpperBonus()),
+                         state.IsYahtzeeRecorded());
+}
+
+size_t OpenCategories(const GameState &state) {
+    size_t open = 0;
+    for (uint32_t mask = FULL_MASK & ~state.GetFilledMask(); mask != 0; mask &= mask - 1) {
+        ++open;
+    }
+    return open;
+}
+
+enum class NodeKind : uint64_t {
+    Decision = 1,
+    Chance = 2,
+};
+
+// Everything the rest of the game depends on: the turn-start key and the
+// points so far. Individual category scores don't matter once filled.
+//
+// [19..0] ShortStateKey, [31..20] total score, [40..32] roll or keep,
+// [42..41] rerolls left, [46..43] turns to search, [48..47] node kind
+uint64_t PackKey(const GameState &state, NodeKind kind, size_t index, size_t rerolls, size_t turns) {
+    return uint64_t{TurnStartKey(state).Value()} | (uint64_t{state.GetTotalScore()} << 20) |
+           (uint64_t{index} << 32) | (uint64_t{rerolls} << 41) | (uint64_t{turns} << 43) |
+           (static_cast<uint64_t>(kind) << 47);
+}
+
+}  // namespace
+
+ExpectedScoreObjective::ExpectedScoreObjective(const double *state_values, TableLayout layout)
+    : state_values_(state_values), layout_(layout) {}
+
+double ExpectedScoreObjective::FinalValue(const GameState &state) const {
+    return static_cast<double>(state.GetTotalScore());
+}
+
+double ExpectedScoreObjective::LeafValue(const GameState &state) const {
+    const size_t offset = ReachableIndex::Offset(TurnStartKey(state), layout_);
+    return static_cast<double>(state.GetTotalScore()) + state_values_[offset];
+}
+
+TargetScoreObjective::TargetScoreObjective(const ThresholdSolver &solver, size_t target)
+    : solver_(solver), target_(target) {}
+
+double TargetScoreObjective::FinalValue(const GameState &state) const {
+    return state.GetTotalScore() >= target_ ? 1.0 : 0.0;
+}
+
+double TargetScoreObjective::LeafValue(const GameState &state) const {
+    const size_t total = state.GetTotalScore();
+    return total >= target_ ? 1.0 : solver_.GetProbability(TurnStartKey(state), target_ - total);
+}
+
+struct ExpectimaxSearch::Context {
+    Clock::time_point deadline;
+    size_t nodes{0};
+    size_t table_hits{0};
+    bool timed_out{false};
+
+    // Counts a node; true once the deadline has passed
+    bool Expired() {
+        if (!timed_out && nodes++ % DEADLINE_CHECK_NODES == 0 && Clock::now() >= deadline) {
+            timed_out = true;
+        }
+        return timed_out;
+    }
+};
+
+ExpectimaxSearch::ExpectimaxSearch(const SearchObjective &objective, size_t log2_table_slots)
+    : objective_(objective), table_(log2_table_slots) {}
+
+void ExpectimaxSearch::ClearTable() {
+    table_.Clear();
+}
+
+SearchResult ExpectimaxSearch::Search(const GameState &state, size_t max_depth) const {
+    return Search(state, max_depth, Clock::time_point::max());
+}
+
+SearchResult ExpectimaxSearch::Search(const GameState &root, size_t max_depth, Clock::time_point deadline) const {
+    const Clock::time_point start = Clock::now();
+    const Dice &dice = root.GetCurrentDice();
+    if (dice.total() != NUM_DICE) {
+        throw std::invalid_argument("Search needs a full roll of five dice");
+    }
+    const RollIndex roll = dice.roll_index();
+    GameState state = root;
+
+    SearchResult result;
+    GetPossibleMoves(state, result.moves);
+    for (size_t i = 0; i < result.moves.size(); ++i) {
+        result.values[i] = StaticMoveValue(state, roll, result.moves[i]);
+    }
+
+    // Past the last turn every depth gives the same values
+    const size_t last_depth = std::min({max_depth, OpenCategories(state), MAX_SEARCH_DEPTH});
+    Context context;
+    context.deadline = deadline;
+    std::array<double, MoveList::MAX_MOVES> values{};
+    for (size_t depth = 1; depth <= last_depth && !context.timed_out; ++depth) {
+        for (size_t i = 0; i < result.moves.size() && !context.timed_out; ++i) {
+            values[i] = MoveValue(state, roll, result.moves[i], depth, context);
+        }
+        if (!context.timed_out) {
+            result.values = values;
+            result.depth = depth;
+        }
+    }
+
+    result.best = 0;
+    for (size_t i = 1; i < result.moves.size(); ++i) {
+        if (result.values[i] > result.values[result.best]) {
+            result.best = i;
+        }
+    }
+    result.timed_out = context.timed_out;
+    result.nodes = context.nodes;
+    result.table_hits = context.table_hits;
+    result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    return result;
+}
+
+double ExpectimaxSearch::TurnStartValue(GameState &state, size_t turns, Context &context) const {
+    if (state.GetFilledMask() == FULL_MASK) {
+        return objective_.FinalValue(state);
+    }
+    if (turns == 0) {
+        return objective_.LeafValue(state);
+    }
+    // The first roll of a turn is a reroll of no kept dice
+    const size_t rerolls = state.GetRemainingRerolls();
+    state.SetRemainingRerolls(TurnEvaluator::TURN_REROLLS);
+    const double value = ChanceValue(state, EMPTY_KEEP, turns, context);
+    state.SetRemainingRerolls(rerolls);
+    return value;
+}
+
+double ExpectimaxSearch::ChanceValue(GameState &state, KeepIndex keep, size_t turns, Context &context) const {
+    const uint64_t key = PackKey(state, NodeKind::Chance, keep, state.GetRemainingRerolls(), turns);
+    double value = 0.0;
+    if (table_.Probe(key, value)) {
+        ++context.table_hits;
+        CountMetric(MetricCounter::TranspositionHits);
+        return value;
+    }
+    CountMetric(MetricCounter::TranspositionMisses);
+    if (context.Expired()) {
+        return 0.0;
+    }
+
+    const RerollMatrix::Row row = REROLL_MATRIX.GetRow(keep);
+    for (size_t i = 0; i < row.size; ++i) {
+        value += row.probabilities[i] * DecisionValue(state, row.rolls[i], turns, context);
+    }
+    if (context.timed_out) {
+        return 0.0;
+    }
+    table_.Store(key, value);
+    return value;
+}
+
+double ExpectimaxSearch::DecisionValue(GameState &state, RollIndex roll, size_t turns, Context &context) const {
+    const uint64_t key = PackKey(state, NodeKind::Decision, roll, state.GetRemainingRerolls(), turns);
+    double value = 0.0;
+    if (table_.Probe(key, value)) {
+        ++context.table_hits;
+        CountMetric(MetricCounter::TranspositionHits);
+        return value;
+    }
+    CountMetric(MetricCounter::TranspositionMisses);
+    if (context.Expired()) {
+        return 0.0;
+    }
+
+    state.SetCurrentDice(Dice::from_roll_index(roll));
+    MoveList moves;
+    GetPossibleMoves(state, moves);
+    value = MoveValue(state, roll, moves[0], turns, context);
+    for (size_t i = 1; i < moves.size(); ++i) {
+        value = std::max(value, MoveValue(state, roll, moves[i], turns, context));
+    }
+    if (context.timed_out) {
+        return 0.0;
+    }
+    table_.Store(key, value);
+    return value;
+}
+
+double ExpectimaxSearch::MoveValue(GameState &state, RollIndex roll, CompactMove move, size_t turns,
+                                   Context &context) const {
+    // Children change the dice, every move starts from the roll again
+    state.SetCurrentDice(Dice::from_roll_index(roll));
+    const UndoToken<GameState> token = MakeMove(state, move);
+    const double value = move.IsReroll() ? ChanceValue(state, move.GetKeepIndex(), turns, context)
+                                         : TurnStartValue(state, turns - 1, context);
+    UnmakeMove(state, token);
+    return value;
+}
+
+double ExpectimaxSearch::StaticScoreValue(GameState &state, RollIndex roll) const {
+    state.SetCurrentDice(Dice::from_roll_index(roll));
+    double best = 0.0;
+    bool found = false;
+    for (uint32_t mask = GetScoreMoveMask(state); mask != 0; mask &= mask - 1) {
+        uint32_t category = 0;
+        while (!((mask >> category) & 1u)) {
+            ++category;
+        }
+        const double value = StaticMoveValue(state, roll, CompactMove::Score(static_cast<Category>(category)));
+        best = found ? std::max(best, value) : value;
+        found = true;
+    }
+    return best;
+}
+
+double ExpectimaxSearch::StaticMoveValue(GameState &state, RollIndex roll, CompactMove move) const {
+    if (move.IsReroll()) {
+        // Every outcome is scored right away
+        const RerollMatrix::Row row = REROLL_MATRIX.GetRow(move.GetKeepIndex());
+        double value = 0.0;
+        for (size_t i = 0; i < row.size; ++i) {
+            value += row.probabilities[i] * StaticScoreValue(state, row.rolls[i]);
+        }
+        state.SetCurrentDice(Dice::from_roll_index(roll));
+        return value;
+    }
+    const UndoToken<GameState> token = MakeMove(state, move);
+    const double value = state.GetFilledMask() == FULL_MASK ? objective_.FinalValue(state)
+                                                            : objective_.LeafValue(state);
+    UnmakeMove(state, token);
+    return value;
+}
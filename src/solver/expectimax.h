@@ -0,0 +1,115 @@
+#pragma once
+
+#include "../game_state/game_state.h"
+#include "../move/move_list.h"
+#include "table_layout.h"
+#include "threshold_solver.h"
+#include "transposition_table.h"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+// What a search maximizes, as a value of the final score sheet, and its
+// estimate at the start of a turn beyond the search horizon
+class SearchObjective {
+public:
+    virtual ~SearchObjective() = default;
+
+    // Value of a finished game
+    virtual double FinalValue(const GameState &state) const = 0;
+
+    // Estimated value at the start of a turn (no dice) with open categories
+    virtual double LeafValue(const GameState &state) const = 0;
+};
+
+// Expected final score, leaves from a table of turn-start values
+// (Solver::GetValues() or a mapped StrategyTable with its layout) that must
+// outlive the objective
+class ExpectedScoreObjective : public SearchObjective {
+public:
+    explicit ExpectedScoreObjective(const double *state_values,
+                                    TableLayout layout = TableLayout::ShortStateKeyDense);
+
+    double FinalValue(const GameState &state) const override;
+    double LeafValue(const GameState &state) const override;
+
+private:
+    const double *state_values_;
+    TableLayout layout_;
+};
+
+// Probability of a final score of at least target, leaves from a solved
+// ThresholdSolver that must outlive the objective
+class TargetScoreObjective : public SearchObjective {
+public:
+    TargetScoreObjective(const ThresholdSolver &solver, size_t target);
+
+    double FinalValue(const GameState &state) const override;
+    double LeafValue(const GameState &state) const override;
+
+private:
+    const ThresholdSolver &solver_;
+    size_t target_;
+};
+
+// Root moves of a search with their values under the objective
+struct SearchResult {
+    MoveList moves;
+    std::array<double, MoveList::MAX_MOVES> values{};
+    size_t best{0};       // index of the best move in moves
+    size_t depth{0};      // turns searched to the end, 0 when only the static evaluation finished
+    bool timed_out{false};
+    size_t nodes{0};
+    size_t table_hits{0};
+    double seconds{0.0};
+
+    CompactMove GetBestMove() const { return moves[best]; }
+    double GetBestValue() const { return values[best]; }
+};
+
+// Depth-limited expectimax over full GameStates.
+//
+// Unlike the solvers it sees the points already on the sheet, so objectives
+// such as reaching a target score are exact inside the horizon. Decision
+// nodes take the best move, chance nodes average over the reroll outcomes of
+// REROLL_MATRIX. The depth counts turns: the turn of the root is always
+// searched to its end and every further turn adds one turn-start layer;
+// beyond the horizon the objective's LeafValue stands in for the rest of the
+// game.
+//
+// Search deepens one turn at a time and keeps the values of the deepest
+// finished depth, so it always answers by the deadline. Before the first
+// depth it runs a static evaluation (rerolls followed by the best immediate
+// score move) that costs one leaf per score move of every reroll outcome. Values are cached in a
+// lock-free transposition table keyed on the parts of the sheet that decide
+// the rest of the game, so Search may run on several threads at once; the
+// table belongs to the objective and must be cleared when it changes.
+class ExpectimaxSearch {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // The objective must outlive the search
+    explicit ExpectimaxSearch(const SearchObjective &objective, size_t log2_table_slots = 20);
+
+    // The current dice must be a full roll of five dice
+    SearchResult Search(const GameState &state, size_t max_depth, Clock::time_point deadline) const;
+    SearchResult Search(const GameState &state, size_t max_depth) const;
+
+    void ClearTable();
+
+private:
+    struct Context;
+
+    double TurnStartValue(GameState &state, size_t turns, Context &context) const;
+    double DecisionValue(GameState &state, RollIndex roll, size_t turns, Context &context) const;
+    double ChanceValue(GameState &state, KeepIndex keep, size_t turns, Context &context) const;
+    double MoveValue(GameState &state, RollIndex roll, CompactMove move, size_t turns, Context &context) const;
+
+    double StaticScoreValue(GameState &state, RollIndex roll) const;
+    double StaticMoveValue(GameState &state, RollIndex roll, CompactMove move) const;
+
+    const SearchObjective &objective_;
+    mutable TranspositionTable table_;
+};
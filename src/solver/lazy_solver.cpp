@@ -0,0 +1,163 @@
+#include "lazy_solver.h"
+#include "turn_evaluator.h"
+#include "../metrics/metrics.h"
+
+#include <utility>
+
+LazySolver::LazySolver(size_t cache_capacity) : cache_(cache_capacity) {
+    warm_thread_ = std::thread([this] { WarmLoop(); });
+}
+
+LazySolver::~LazySolver() {
+    {
+        std::lock_guard<std::mutex> lock(warm_mutex_);
+        stopping_ = true;
+    }
+    warm_wakeup_.notify_all();
+    warm_thread_.join();
+}
+
+double LazySolver::GetStateValue(const ShortGameState &state) {
+    return GetStateValue(state.GetKey());
+}
+
+double LazySolver::GetStateValue(ShortStateKey key) {
+    ScopedMetricTimer timer(MetricHistogram::LazyQueryNanoseconds);
+    if (key.IsGameOver()) {
+        return 0.0;
+    }
+    if (std::optional<double> cached = cache_.Find(key)) {
+        return *cached;
+    }
+    double value = 0.0;
+    Solve(key, value, false);
+    return value;
+}
+
+bool LazySolver::Solve(ShortStateKey key, double &value, bool stoppable) {
+    std::unique_ptr<Scratch> scratch = AcquireScratch();
+    const bool solved = Solve(*scratch, key, value, stoppable);
+    // Only visited states were marked or given a value
+    for (ShortStateKey state : scratch->touched) {
+        scratch->visited[state.Index()] = false;
+        scratch->values[state.Index()] = 0.0;
+    }
+    scratch->touched.clear();
+    for (std::vector<ShortStateKey> &layer : scratch->layers) {
+        layer.clear();
+    }
+    scratch->stack.clear();
+    ReleaseScratch(std::move(scratch));
+    return solved;
+}
+
+bool LazySolver::Solve(Scratch &scratch, ShortStateKey key, double &value, bool stoppable) {
+    // Forward: every state the key needs, cut off at cached ones, whose values go straight into the table
+    std::vector<bool> &visited = scratch.visited;
+    std::vector<double> &values = scratch.values;
+    std::vector<ShortStateKey> &stack = scratch.stack;
+    stack.push_back(key);
+    visited[key.Index()] = true;
+    scratch.touched.push_back(key);
+    while (!stack.empty()) {
+        const ShortStateKey state = stack.back();
+        stack.pop_back();
+        if (state.IsGameOver()) {
+            continue;  // worth 0, like the zeroed table
+        }
+        if (state != key) {
+            if (std::optional<double> cached = cache_.Find(state)) {
+                values[state.Index()] = *cached;
+                continue;
+            }
+        }
+        scratch.layers[state.FilledCount()].push_back(state);
+        GetSuccessors(state, scratch.successors);
+        for (ShortStateKey next : scratch.successors) {
+            if (!visited[next.Index()]) {
+                visited[next.Index()] = true;
+                scratch.touched.push_back(next);
+                stack.push_back(next);
+            }
+        }
+    }
+
+    // Backward: layers from the fullest sheet, as in Solver
+    TurnEvaluator evaluator(values.data());
+    for (size_t filled = NUM_CATEGORIES + 1; filled-- > 0;) {
+        for (ShortStateKey state : scratch.layers[filled]) {
+            if (stoppable && stopping_) {
+                return false;
+            }
+            evaluator.Evaluate(state);
+            values[state.Index()] = evaluator.GetTurnStartValue();
+            cache_.Insert(state, values[state.Index()]);
+            ++evaluated_states_;
+        }
+    }
+    value = values[key.Index()];
+    return true;
+}
+
+std::unique_ptr<LazySolver::Scratch> LazySolver::AcquireScratch() {
+    {
+        std::lock_guard<std::mutex> lock(scratch_mutex_);
+        if (!free_scratch_.empty()) {
+            std::unique_ptr<Scratch> scratch = std::move(free_scratch_.back());
+            free_scratch_.pop_back();
+            return scratch;
+        }
+    }
+    return std::make_unique<Scratch>();
+}
+
+void LazySolver::ReleaseScratch(std::unique_ptr<Scratch> scratch) {
+    std::lock_guard<std::mutex> lock(scratch_mutex_);
+    free_scratch_.push_back(std::move(scratch));
+}
+
+void LazySolver::Warm(ShortStateKey key) {
+    {
+        std::lock_guard<std::mutex> lock(warm_mutex_);
+        warm_queue_.push_back(key);
+    }
+    warm_wakeup_.notify_one();
+}
+
+void LazySolver::WaitForWarming() {
+    std::unique_lock<std::mutex> lock(warm_mutex_);
+    warm_idle_.wait(lock, [this] { return warm_queue_.empty() && !warm_busy_; });
+}
+
+void LazySolver::WarmLoop() {
+    std::unique_lock<std::mutex> lock(warm_mutex_);
+    while (true) {
+        warm_wakeup_.wait(lock, [this] { return stopping_ || !warm_queue_.empty(); });
+        if (stopping_) {
+            return;
+        }
+        const ShortStateKey key = warm_queue_.front();
+        warm_queue_.pop_front();
+        warm_busy_ = true;
+        lock.unlock();
+
+        if (!key.IsGameOver() && !cache_.Find(key)) {
+            double value = 0.0;
+            Solve(key, value, true);
+        }
+
+        lock.lock();
+        warm_busy_ = false;
+        if (warm_queue_.empty()) {
+            warm_idle_.notify_all();
+        }
+    }
+}
+
+CacheStats LazySolver::GetCacheStats() const {
+    return cache_.GetStats();
+}
+
+size_t LazySolver::GetEvaluatedStates() const {
+    return evaluated_states_;
+}
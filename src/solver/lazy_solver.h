@@ -0,0 +1,90 @@
+#pragma once
+
+#include "../game_state/short_game_state.h"
+#include "../game_state/short_state_key.h"
+#include "state_value_cache.h"
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// On-demand alternative to Solver for when the full table is too costly to
+// ship or compute up front.
+//
+// A query solves only the states reachable from the queried one that the
+// cache does not already hold. It expands them forward from the query, where
+// a cached state stops the expansion, and then evaluates them layer by layer
+// from the fullest sheets back, exactly as Solver does. Every solved value
+// goes into a bounded StateValueCache, so later queries of the same game
+// mostly find their state there. The values a solve is working on live in a
+// dense table of NUM_INDICES doubles. The table and the visited marks are
+// kept in a pool of scratch spaces, one per solve running at the same time,
+// so a query allocates nothing once warm. A finished solve clears only the
+// entries it visited.
+//
+// Queries are safe from several threads; threads that miss on overlapping
+// states solve them twice. Warm solves states on a background thread.
+class LazySolver {
+public:
+    static constexpr size_t DEFAULT_CACHE_CAPACITY = size_t{1} << 18;
+
+    explicit LazySolver(size_t cache_capacity = DEFAULT_CACHE_CAPACITY);
+    ~LazySolver();
+
+    LazySolver(const LazySolver &) = delete;
+    LazySolver &operator=(const LazySolver &) = delete;
+
+    // Expected score of the rest of the game from the start of a turn,
+    // equal to Solver::GetStateValue. Dice and rerolls of the state are ignored.
+    double GetStateValue(ShortStateKey key);
+    double GetStateValue(const ShortGameState &state);
+
+    // Queues the state to be solved on the background thread
+    void Warm(ShortStateKey key);
+
+    // Blocks until every queued state is solved
+    void WaitForWarming();
+
+    CacheStats GetCacheStats() const;
+
+    // Turn evaluations done so far, by queries and warming
+    size_t GetEvaluatedStates() const;
+
+private:
+    // Working memory of one solve, all zero and empty between solves
+    struct Scratch {
+        std::vector<bool> visited = std::vector<bool>(ShortStateKey::NUM_INDICES, false);
+        std::vector<double> values = std::vector<double>(ShortStateKey::NUM_INDICES, 0.0);
+        std::vector<ShortStateKey> touched;  // visited states, to clear afterwards
+        std::array<std::vector<ShortStateKey>, NUM_CATEGORIES + 1> layers;
+        std::vector<ShortStateKey> stack;
+        std::vector<ShortStateKey> successors;
+    };
+
+    // Solves the key and what it needs that is not cached; false when stopping
+    bool Solve(ShortStateKey key, double &value, bool stoppable);
+    bool Solve(Scratch &scratch, ShortStateKey key, double &value, bool stoppable);
+    std::unique_ptr<Scratch> AcquireScratch();
+    void ReleaseScratch(std::unique_ptr<Scratch> scratch);
+    void WarmLoop();
+
+    StateValueCache cache_;
+    std::atomic<size_t> evaluated_states_{0};
+
+    std::mutex scratch_mutex_;
+    std::vector<std::unique_ptr<Scratch>> free_scratch_;
+
+    std::mutex warm_mutex_;
+    std::condition_variable warm_wakeup_;
+    std::condition_variable warm_idle_;
+    std::deque<ShortStateKey> warm_queue_;
+    bool warm_busy_{false};
+    std::atomic<bool> stopping_{false};
+    std::thread warm_thread_;
+};
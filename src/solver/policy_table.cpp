@@ -0,0 +1,203 @@
+#include "policy_table.h"
+#include "../game_state/short_game_state.h"
+#include "task_scheduler.h"
+
+#include <array>
+#include <memory>
+#include <stdexcept>
+
+namespace {
+
+// States per scheduler chunk
+constexpr size_t CHUNK_STATES = 16;
+
+size_t GetNumOffsets(TableLayout layout) {
+    if (layout == TableLayout::ShortStateKeyDense) {
+        return ShortStateKey::NUM_INDICES;
+    }
+    if (layout == TableLayout::ShortStateKeyReachable) {
+        return ReachableIndex::NUM_REACHABLE;
+    }
+    throw std::invalid_argument("Unknown table layout");
+}
+
+// Finds the best moves of the turns of one state after another
+class PolicyWorker {
+public:
+    PolicyWorker(const double *state_values, TableLayout layout)
+        : state_values_(state_values), layout_(layout), evaluator_(state_values, layout) {}
+
+    void BuildState(ShortStateKey key, uint8_t *moves) {
+        evaluator_.Evaluate(key);
+        for (size_t rerolls = 1; rerolls <= TurnEvaluator::TURN_REROLLS; ++rerolls) {
+            evaluator_.GetKeepValues(rerolls, keep_values_[rerolls - 1]);
+        }
+        for (size_t roll = 0; roll < NUM_ROLLS; ++roll) {
+            size_t num_scores = 0;
+            const uint32_t allowed = GetAllowedCategoryMask(key, static_cast<RollIndex>(roll));
+            for (uint32_t mask = allowed; mask != 0; mask &= mask - 1) {
+                uint32_t category = 0;
+                while (!((mask >> category) & 1u)) {
+                    ++category;
+                }
+                const ScoreOutcome outcome =
+                    GetScoreOutcome(key, static_cast<RollIndex>(roll), static_cast<Category>(category));
+                score_categories_[num_scores] = static_cast<uint8_t>(category);
+                score_values_[num_scores++] =
+                    outcome.points + state_values_[ReachableIndex::Offset(outcome.next, layout_)];
+            }
+
+            // Keeps first, then score moves, the first of equal moves wins as in Advisor
+            const auto sub_keeps = SUB_KEEP_TABLE.GetRow(static_cast<KeepIndex>(KEEP_OFFSETS[NUM_DICE] + roll));
+            for (size_t rerolls = 0; rerolls <= TurnEvaluator::TURN_REROLLS; ++rerolls) {
+                uint8_t best = PolicyTable::NO_MOVE;
+                double best_value = 0.0;
+                if (rerolls > 0) {
+                    for (size_t i = 0; i < sub_keeps.size(); ++i) {
+                        const double value = keep_values_[rerolls - 1][sub_keeps.begin()[i]];
+                        if (best == PolicyTable::NO_MOVE || value > best_value) {
+                            best = static_cast<uint8_t>(i);
+                            best_value = value;
+                        }
+                    }
+                }
+                for (size_t i = 0; i < num_scores; ++i) {
+                    if (best == PolicyTable::NO_MOVE || score_values_[i] > best_value) {
+                        best = static_cast<uint8_t>(PolicyTable::FIRST_SCORE + score_categories_[i]);
+                        best_value = score_values_[i];
+                    }
+                }
+                moves[PolicyTable::GetDecision(rerolls, static_cast<RollIndex>(roll))] = best;
+            }
+        }
+    }
+
+private:
+    const double *state_values_;
+    TableLayout layout_;
+    TurnEvaluator evaluator_;
+    // Keeps with 1 and 2 rerolls left
+    std::array<std::array<double, NUM_KEEPS>, TurnEvaluator::TURN_REROLLS> keep_values_{};
+    std::array<double, NUM_CATEGORIES> score_values_{};
+    std::array<uint8_t, NUM_CATEGORIES> score_categories_{};
+};
+
+}  // namespace
+
+PolicyTable::PolicyTable(const std::string &path) : file_(path) {
+    const StrategyFileHeader &header = GetHeader();
+    CheckStrategyFileHeader(path, header, file_.GetSize());
+    const auto layout = static_cast<TableLayout>(header.layout);
+    if (!(layout == TableLayout::ShortStateKeyDense || layout == TableLayout::ShortStateKeyReachable) ||
+        header.element_type != static_cast<uint32_t>(ElementType::Policy8) || header.element_size != 1 ||
+        header.num_elements != GetNumOffsets(layout) * DECISIONS_PER_STATE ||
+        header.data_size != header.num_elements) {
+        throw std::runtime_error(path + " is not a policy table");
+    }
+    moves_ = file_.GetData() + header.data_offset;
+    layout_ = layout;
+}
+
+const StrategyFileHeader &PolicyTable::GetHeader() const {
+    return *reinterpret_cast<const StrategyFileHeader *>(file_.GetData());
+}
+
+bool PolicyTable::VerifyChecksum() const {
+    const StrategyFileHeader &header = GetHeader();
+    return Checksum64(file_.GetData() + header.data_offset, header.data_size) == header.data_checksum;
+}
+
+CompactMove PolicyTable::GetBestMove(const GameState &state) const {
+    const Dice &dice = state.GetCurrentDice();
+    if (dice.total() != NUM_DICE) {
+        throw std::invalid_argument("Policy lookups need a full roll of five dice");
+    }
+    return GetBestMove(ShortGameState(state).GetKey(), state.GetRemainingRerolls(), dice.roll_index());
+}
+
+std::optional<CompactMove> PolicyTable::FindBestMove(const GameState &state) const {
+    const Dice &dice = state.GetCurrentDice();
+    if (dice.total() != NUM_DICE) {
+        throw std::invalid_argument("Policy lookups need a full roll of five dice");
+    }
+    const RollIndex roll = dice.roll_index();
+    const uint8_t code = GetMoveCode(ShortGameState(state).GetKey(), state.GetRemainingRerolls(), roll);
+    if (code == NO_MOVE) {
+        return std::nullopt;
+    }
+    return DecodeMove(code, roll);
+}
+
+uint8_t PolicyTable::EncodeMove(CompactMove move, RollIndex roll) {
+    if (!move.IsReroll()) {
+        return static_cast<uint8_t>(FIRST_SCORE + static_cast<size_t>(move.GetCategory()));
+    }
+    const auto sub_keeps = SUB_KEEP_TABLE.GetRow(static_cast<KeepIndex>(KEEP_OFFSETS[NUM_DICE] + roll));
+    for (size_t i = 0; i < sub_keeps.size(); ++i) {
+        if (sub_keeps.begin()[i] == move.GetKeepIndex()) {
+            return static_cast<uint8_t>(i);
+        }
+    }
+    throw std::invalid_argument("Keep is not part of the roll");
+}
+
+CompactMove PolicyTable::DecodeMove(uint8_t code, RollIndex roll) {
+    if (code >= FIRST_SCORE) {
+        if (code >= FIRST_SCORE + NUM_CATEGORIES) {
+            throw std::out_of_range("Decision has no move");
+        }
+        return CompactMove::Score(static_cast<Category>(code - FIRST_SCORE));
+    }
+    const auto sub_keeps = SUB_KEEP_TABLE.GetRow(static_cast<KeepIndex>(KEEP_OFFSETS[NUM_DICE] + roll));
+    if (code >= sub_keeps.size()) {
+        throw std::out_of_range("Decision has no move");
+    }
+    return CompactMove::Reroll(sub_keeps.begin()[code]);
+}
+
+std::vector<uint8_t> BuildPolicy(const double *state_values, TableLayout layout, size_t num_threads,
+                                 size_t min_filled) {
+    const size_t num_offsets = GetNumOffsets(layout);
+    std::vector<ShortStateKey> keys;
+    keys.reserve(num_offsets);
+    for (size_t index = 0; index < ShortStateKey::NUM_INDICES; ++index) {
+        const ShortStateKey key = ShortStateKey::FromIndex(index);
+        if (layout == TableLayout::ShortStateKeyDense || IsReachable(key)) {
+            keys.push_back(key);
+        }
+    }
+
+    std::vector<uint8_t> policy(num_offsets * PolicyTable::DECISIONS_PER_STATE, PolicyTable::NO_MOVE);
+    TaskScheduler scheduler(num_threads);
+    std::vector<std::unique_ptr<PolicyWorker>> workers;
+    for (size_t worker = 0; worker < scheduler.GetNumThreads(); ++worker) {
+        workers.push_back(std::make_unique<PolicyWorker>(state_values, layout));
+    }
+    scheduler.ParallelFor(keys.size(), CHUNK_STATES, [&](size_t begin, size_t end, size_t worker) {
+        for (size_t offset = begin; offset < end; ++offset) {
+            const ShortStateKey key = keys[offset];
+            if (IsReachable(key) && !key.IsGameOver() && key.FilledCount() >= min_filled) {
+                workers[worker]->BuildState(key, policy.data() + offset * PolicyTable::DECISIONS_PER_STATE);
+            }
+        }
+    });
+    return policy;
+}
+
+void WritePolicyFile(const std::string &path, const std::vector<uint8_t> &policy, TableLayout layout,
+                     RuleVariant rule_variant) {
+    if (policy.size() != GetNumOffsets(layout) * PolicyTable::DECISIONS_PER_STATE) {
+        throw std::invalid_argument("Policy must hold every decision of the layout");
+    }
+    StrategyFileHeader header{};
+    header.rule_variant = static_cast<uint32_t>(rule_variant);
+    header.layout = static_cast<uint32_t>(layout);
+    header.element_type = static_cast<uint32_t>(ElementType::Policy8);
+    header.element_size = 1;
+    header.num_elements = policy.size();
+    WriteStrategyFileData(path, header, policy.data(), policy.size());
+}
+
+std::string GetPolicyPath(const std::string &strategy_path) {
+    return strategy_path + ".policy";
+}
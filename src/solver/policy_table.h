@@ -0,0 +1,90 @@
+#pragma once
+
+#include "../game_state/dice_index.h"
+#include "../game_state/game_state.h"
+#include "../game_state/short_state_key.h"
+#include "../move/move_list.h"
+#include "strategy_file.h"
+#include "table_layout.h"
+#include "turn_evaluator.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+// Best move of every decision as one byte: for every state of a layout,
+// every count of rerolls left and every roll.
+//
+// The byte of a reroll is the position of its keep among the sub-keeps of
+// the roll (SUB_KEEP_TABLE), that of a score move FIRST_SCORE plus the
+// category; states that are over or unreachable hold NO_MOVE. Ties go to the
+// first move in GetPossibleMoves order, as with Advisor. Decision d of the
+// state at offset o of the layout is byte o * DECISIONS_PER_STATE + d, d
+// being rerolls * NUM_ROLLS + roll.
+//
+// A policy file is a strategy file with Policy8 elements and the layout of
+// the value table it was built from, written next to it (see GetPolicyPath).
+class PolicyTable {
+public:
+    static constexpr size_t DECISIONS_PER_STATE = (TurnEvaluator::TURN_REROLLS + 1) * NUM_ROLLS;
+    static constexpr uint8_t FIRST_SCORE = SubKeepTable::MAX_SUB_KEEPS;
+    static constexpr uint8_t NO_MOVE = 0xFF;
+
+    static_assert(FIRST_SCORE + NUM_CATEGORIES < NO_MOVE, "Moves must fit a byte");
+
+    PolicyTable() = default;
+    // Throws std::runtime_error when the file is not a policy table
+    explicit PolicyTable(const std::string &path);
+
+    bool IsOpen() const { return file_.IsOpen(); }
+    const StrategyFileHeader &GetHeader() const;
+    bool VerifyChecksum() const;
+    TableLayout GetLayout() const { return layout_; }
+
+    static size_t GetDecision(size_t rerolls, RollIndex roll) { return rerolls * NUM_ROLLS + roll; }
+
+    // Byte of the decision, NO_MOVE when it has no move. The table holds
+    // the rerolls of a turn; more, as GameState allows, have no move either.
+    uint8_t GetMoveCode(ShortStateKey key, size_t rerolls, RollIndex roll) const {
+        if (rerolls > TurnEvaluator::TURN_REROLLS) {
+            return NO_MOVE;
+        }
+        return moves_[ReachableIndex::Offset(key, layout_) * DECISIONS_PER_STATE + GetDecision(rerolls, roll)];
+    }
+
+    // One load and a decode; throws std::out_of_range when the decision has no move
+    CompactMove GetBestMove(ShortStateKey key, size_t rerolls, RollIndex roll) const {
+        return DecodeMove(GetMoveCode(key, rerolls, roll), roll);
+    }
+    // The current dice must be a full roll of five dice
+    CompactMove GetBestMove(const GameState &state) const;
+
+    // The same, or nothing for a decision without a move, such as those of
+    // states below the min_filled of BuildPolicy
+    std::optional<CompactMove> FindBestMove(const GameState &state) const;
+
+    static uint8_t EncodeMove(CompactMove move, RollIndex roll);
+    static CompactMove DecodeMove(uint8_t code, RollIndex roll);
+
+private:
+    MappedFile file_;
+    const uint8_t *moves_{nullptr};
+    TableLayout layout_{TableLayout::ShortStateKeyDense};
+};
+
+// Policy of the values in the layout, DECISIONS_PER_STATE bytes per state.
+// Evaluates a whole turn per state over a TaskScheduler, about the work of a
+// solve; only states with at least min_filled used categories get moves,
+// which keeps endgame policies small.
+std::vector<uint8_t> BuildPolicy(const double *state_values, TableLayout layout = TableLayout::ShortStateKeyDense,
+                                 size_t num_threads = 0, size_t min_filled = 0);
+
+// Writes a policy from BuildPolicy; throws std::runtime_error on IO errors
+void WritePolicyFile(const std::string &path, const std::vector<uint8_t> &policy,
+                     TableLayout layout = TableLayout::ShortStateKeyDense,
+                     RuleVariant rule_variant = RuleVariant::Yahtzee);
+
+// Where the policy of a strategy file lives
+std::string GetPolicyPath(const std::string &strategy_path);
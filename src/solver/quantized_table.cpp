@@ -0,0 +1,620 @@
+#include "quantized_table.h"
+#include "policy_table.h"
+#include "task_scheduler.h"
+#include "turn_evaluator.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+
+namespace {
+
+// Zero bytes after the last DeltaRice block, so the bit reader can always load a whole word
+constexpr size_t BIT_PADDING = sizeof(uint64_t);
+constexpr uint32_t RICE_PARAMETER_BITS = 5;
+
+uint16_t DoubleToHalf(double value) {
+    // Through float, whose rounding to 11 significant bits below is to nearest even
+    const float single = static_cast<float>(value);
+    uint32_t bits;
+    std::memcpy(&bits, &single, sizeof(bits));
+    const uint32_t sign = (bits >> 16) & 0x8000u;
+    const int32_t exponent = static_cast<int32_t>((bits >> 23) & 0xFFu) - 127 + 15;
+    uint32_t mantissa = bits & 0x7FFFFFu;
+    if (exponent >= 31) {
+        return static_cast<uint16_t>(sign | 0x7C00u);
+    }
+    if (exponent <= 0) {
+        if (exponent < -10) {
+            return static_cast<uint16_t>(sign);
+        }
+        // Subnormal: shift the implicit bit in
+        mantissa |= 0x800000u;
+        const uint32_t shift = static_cast<uint32_t>(14 - exponent);
+        uint32_t half = mantissa >> shift;
+        const uint32_t rest = mantissa & ((1u << shift) - 1);
+        const uint32_t halfway = 1u << (shift - 1);
+        if (rest > halfway || (rest == halfway && (half & 1u))) {
+            ++half;
+        }
+        return static_cast<uint16_t>(sign | half);
+    }
+    uint32_t half = (static_cast<uint32_t>(exponent) << 10) | (mantissa >> 13);
+    const uint32_t rest = mantissa & 0x1FFFu;
+    if (rest > 0x1000u || (rest == 0x1000u && (half & 1u))) {
+        ++half;  // may carry into the exponent, up to infinity
+    }
+    return static_cast<uint16_t>(sign | half);
+}
+
+double HalfToDouble(uint16_t half) {
+    const double sign = (half & 0x8000u) ? -1.0 : 1.0;
+    const int exponent = (half >> 10) & 0x1F;
+    const int mantissa = half & 0x3FF;
+    if (exponent == 0) {
+        return sign * std::ldexp(mantissa, -24);
+    }
+    if (exponent == 31) {
+        return mantissa == 0 ? sign * std::numeric_limits<double>::infinity()
+                             : std::numeric_limits<double>::quiet_NaN();
+    }
+    return sign * std::ldexp(mantissa | 0x400, exponent - 25);
+}
+
+class BitWriter {
+public:
+    explicit BitWriter(std::vector<unsigned char> &bytes) : bytes_(bytes) {}
+
+    void Write(uint64_t value, uint32_t bits) {
+        for (uint32_t i = 0; i < bits; ++i) {
+            WriteBit((value >> i) & 1u);
+        }
+    }
+
+    void WriteUnary(uint64_t quotient) {
+        for (uint64_t i = 0; i < quotient; ++i) {
+            WriteBit(1);
+        }
+        WriteBit(0);
+    }
+
+private:
+    void WriteBit(uint64_t bit) {
+        if (used_ == 0) {
+            bytes_.push_back(0);
+        }
+        bytes_.back() = static_cast<unsigned char>(bytes_.back() | (bit << used_));
+        used_ = (used_ + 1) % 8;
+    }
+
+    std::vector<unsigned char> &bytes_;
+    uint32_t used_{0};  // bits of the last byte in use
+};
+
+class BitReader {
+public:
+    explicit BitReader(const unsigned char *data) : data_(data) {}
+
+    // bits <= 32
+    uint32_t Read(uint32_t bits) {
+        uint64_t word;
+        std::memcpy(&word, data_ + position_ / 8, sizeof(word));
+        word >>= position_ % 8;
+        position_ += bits;
+        return static_cast<uint32_t>(word & ((uint64_t{1} << bits) - 1));
+    }
+
+    uint64_t ReadUnary() {
+        uint64_t quotient = 0;
+        while (Read(1) != 0) {
+            ++quotient;
+        }
+        return quotient;
+    }
+
+private:
+    const unsigned char *data_;
+    size_t position_{0};
+};
+
+uint64_t Zigzag(int64_t difference) {
+    return difference >= 0 ? static_cast<uint64_t>(difference) << 1 : (static_cast<uint64_t>(-difference) << 1) - 1;
+}
+
+int64_t Unzigzag(uint64_t code) {
+    return (code & 1u) ? -static_cast<int64_t>((code + 1) >> 1) : static_cast<int64_t>(code >> 1);
+}
+
+std::vector<uint32_t> FixedPointCodes(const double *values, size_t num_values, double step, uint32_t max_code) {
+    std::vector<uint32_t> codes(num_values);
+    for (size_t i = 0; i < num_values; ++i) {
+        const double code = std::round(values[i] / step);
+        if (!(code >= 0.0 && code <= max_code)) {
+            throw std::invalid_argument("Value out of range of the fixed point codes");
+        }
+        codes[i] = static_cast<uint32_t>(code);
+    }
+    return codes;
+}
+
+// Rice parameter with the fewest bits for the zigzag codes
+uint32_t BestRiceParameter(const uint64_t *codes, size_t count) {
+    uint32_t best = 0;
+    uint64_t best_bits = std::numeric_limits<uint64_t>::max();
+    for (uint32_t k = 0; k < (1u << RICE_PARAMETER_BITS); ++k) {
+        uint64_t bits = 0;
+        for (size_t i = 0; i < count; ++i) {
+            bits += (codes[i] >> k) + 1 + k;
+        }
+        if (bits < best_bits) {
+            best_bits = bits;
+            best = k;
+        }
+    }
+    return best;
+}
+
+void EncodeDeltaRice(const std::vector<uint32_t> &codes, std::vector<unsigned char> &data) {
+    const size_t num_blocks = (codes.size() + QuantizedTable::BLOCK_VALUES - 1) / QuantizedTable::BLOCK_VALUES;
+    const size_t offsets_at = data.size();
+    data.resize(offsets_at + (num_blocks + 1) * sizeof(uint32_t));
+    std::vector<unsigned char> blocks;
+    std::vector<uint32_t> offsets(num_blocks + 1, 0);
+    uint64_t differences[QuantizedTable::BLOCK_VALUES];
+    for (size_t block = 0; block < num_blocks; ++block) {
+        const size_t begin = block * QuantizedTable::BLOCK_VALUES;
+        const size_t end = std::min(codes.size(), begin + QuantizedTable::BLOCK_VALUES);
+        for (size_t i = begin + 1; i < end; ++i) {
+            differences[i - begin - 1] = Zigzag(static_cast<int64_t>(codes[i]) - static_cast<int64_t>(codes[i - 1]));
+        }
+        const uint32_t k = BestRiceParameter(differences, end - begin - 1);
+
+        BitWriter writer(blocks);
+        writer.Write(codes[begin], 32);
+        writer.Write(k, RICE_PARAMETER_BITS);
+        for (size_t i = 0; i + 1 < end - begin; ++i) {
+            writer.WriteUnary(differences[i] >> k);
+            writer.Write(differences[i], k);
+        }
+        if (blocks.size() > std::numeric_limits<uint32_t>::max()) {
+            throw std::invalid_argument("Table too large for DeltaRice offsets");
+        }
+        offsets[block + 1] = static_cast<uint32_t>(blocks.size());
+    }
+    std::memcpy(data.data() + offsets_at, offsets.data(), offsets.size() * sizeof(uint32_t));
+    data.insert(data.end(), blocks.begin(), blocks.end());
+    data.insert(data.end(), BIT_PADDING, 0);
+}
+
+// Decodes count values of a DeltaRice block
+void DecodeDeltaRiceBlock(const unsigned char *block, size_t count, double step, double *values) {
+    BitReader reader(block);
+    int64_t code = reader.Read(32);
+    const uint32_t k = reader.Read(RICE_PARAMETER_BITS);
+    values[0] = static_cast<double>(code) * step;
+    for (size_t i = 1; i < count; ++i) {
+        const uint64_t quotient = reader.ReadUnary();
+        code += Unzigzag((quotient << k) | reader.Read(k));
+        values[i] = static_cast<double>(code) * step;
+    }
+}
+
+bool IsQuantizedType(ElementType element_type) {
+    return element_type == ElementType::Fixed16 || element_type == ElementType::Float16 ||
+           element_type == ElementType::DeltaRice;
+}
+
+size_t CorrectionsOffset(size_t codes_end) {
+    return (codes_end + sizeof(uint32_t) - 1) / sizeof(uint32_t) * sizeof(uint32_t);
+}
+
+// Corrections blocked as in QuantizedTableInfo, appended at the next uint32
+void EncodeCorrections(const std::vector<uint64_t> &corrections, std::vector<unsigned char> &data) {
+    const size_t num_blocks = (corrections.size() + QuantizedTable::BLOCK_VALUES - 1) / QuantizedTable::BLOCK_VALUES;
+    // First positions of the blocks, then the byte offsets
+    std::vector<uint32_t> index(2 * num_blocks + 1, 0);
+    std::vector<unsigned char> blocks;
+    uint64_t gaps[QuantizedTable::BLOCK_VALUES];
+    for (size_t block = 0; block < num_blocks; ++block) {
+        const size_t begin = block * QuantizedTable::BLOCK_VALUES;
+        const size_t end = std::min(corrections.size(), begin + QuantizedTable::BLOCK_VALUES);
+        index[block] = static_cast<uint32_t>(corrections[begin] >> 8);
+        for (size_t i = begin; i < end; ++i) {
+            blocks.push_back(static_cast<unsigned char>(corrections[i] & 0xFFu));
+        }
+        for (size_t i = begin + 1; i < end; ++i) {
+            gaps[i - begin - 1] = (corrections[i] >> 8) - (corrections[i - 1] >> 8) - 1;
+        }
+        const uint32_t k = BestRiceParameter(gaps, end - begin - 1);
+
+        BitWriter writer(blocks);
+        writer.Write(k, RICE_PARAMETER_BITS);
+        for (size_t i = 0; i + 1 < end - begin; ++i) {
+            writer.WriteUnary(gaps[i] >> k);
+            writer.Write(gaps[i], k);
+        }
+        if (blocks.size() > std::numeric_limits<uint32_t>::max()) {
+            throw std::invalid_argument("Too many corrections for their offsets");
+        }
+        index[num_blocks + block + 1] = static_cast<uint32_t>(blocks.size());
+    }
+    data.resize(CorrectionsOffset(data.size()), 0);
+    const auto *bytes = reinterpret_cast<const unsigned char *>(index.data());
+    data.insert(data.end(), bytes, bytes + index.size() * sizeof(uint32_t));
+    data.insert(data.end(), blocks.begin(), blocks.end());
+    data.insert(data.end(), BIT_PADDING, 0);
+}
+
+}  // namespace
+
+std::vector<unsigned char> EncodeQuantizedValues(const double *values, size_t num_values, ElementType element_type,
+                                                 double step, const std::vector<uint64_t> &corrections) {
+    if (!IsQuantizedType(element_type)) {
+        throw std::invalid_argument("Not a quantized element type");
+    }
+    if (step < 0.0 || (element_type == ElementType::Float16 && step != 0.0)) {
+        throw std::invalid_argument("Invalid quantization step");
+    }
+    for (size_t i = 1; i < corrections.size(); ++i) {
+        if ((corrections[i] >> 8) <= (corrections[i - 1] >> 8)) {
+            throw std::invalid_argument("Corrections must be sorted by decision");
+        }
+    }
+    if (!corrections.empty() && (corrections.back() >> 8) > std::numeric_limits<uint32_t>::max()) {
+        throw std::invalid_argument("Correction positions must fit 32 bits");
+    }
+    QuantizedTableInfo info{};
+    info.block_values = static_cast<uint32_t>(QuantizedTable::BLOCK_VALUES);
+    info.num_blocks = static_cast<uint32_t>((num_values + QuantizedTable::BLOCK_VALUES - 1) /
+                                            QuantizedTable::BLOCK_VALUES);
+    std::vector<unsigned char> data(sizeof(info));
+
+    if (element_type == ElementType::Float16) {
+        std::vector<uint16_t> halves(num_values);
+        for (size_t i = 0; i < num_values; ++i) {
+            if (!(values[i] >= 0.0 && values[i] <= 65504.0)) {
+                throw std::invalid_argument("Value out of range of float16");
+            }
+            halves[i] = DoubleToHalf(values[i]);
+            info.max_error = std::max(info.max_error, std::abs(HalfToDouble(halves[i]) - values[i]));
+        }
+        const auto *bytes = reinterpret_cast<const unsigned char *>(halves.data());
+        data.insert(data.end(), bytes, bytes + halves.size() * sizeof(uint16_t));
+    } else {
+        if (element_type == ElementType::Fixed16) {
+            const double max_value = num_values == 0 ? 0.0 : *std::max_element(values, values + num_values);
+            info.step = step != 0.0 ? step : (max_value > 0.0 ? max_value / 65535.0 : 1.0);
+        } else {
+            info.step = step != 0.0 ? step : std::ldexp(1.0, -static_cast<int>(QuantizedTable::DELTA_STEP_BITS));
+        }
+        const uint32_t max_code = element_type == ElementType::Fixed16 ? 65535u : std::numeric_limits<uint32_t>::max();
+        const std::vector<uint32_t> codes = FixedPointCodes(values, num_values, info.step, max_code);
+        for (size_t i = 0; i < num_values; ++i) {
+            info.max_error = std::max(info.max_error, std::abs(static_cast<double>(codes[i]) * info.step - values[i]));
+        }
+        if (element_type == ElementType::Fixed16) {
+            std::vector<uint16_t> fixed(codes.begin(), codes.end());
+            const auto *bytes = reinterpret_cast<const unsigned char *>(fixed.data());
+            data.insert(data.end(), bytes, bytes + fixed.size() * sizeof(uint16_t));
+        } else {
+            EncodeDeltaRice(codes, data);
+        }
+    }
+    if (!corrections.empty()) {
+        info.num_corrections = corrections.size();
+        EncodeCorrections(corrections, data);
+    }
+    std::memcpy(data.data(), &info, sizeof(info));
+    return data;
+}
+
+QuantizedTable::QuantizedTable(const std::string &path) : file_(path) {
+    const StrategyFileHeader &header = GetHeader();
+    CheckStrategyFileHeader(path, header, file_.GetSize());
+    const auto layout = static_cast<TableLayout>(header.layout);
+    if (!((layout == TableLayout::ShortStateKeyDense && header.num_elements == ShortStateKey::NUM_INDICES) ||
+          (layout == TableLayout::ShortStateKeyReachable && header.num_elements == ReachableIndex::NUM_REACHABLE)) ||
+        !IsQuantizedType(static_cast<ElementType>(header.element_type))) {
+        throw std::runtime_error(path + " has an unsupported layout");
+    }
+    data_ = file_.GetData() + header.data_offset;
+    size_ = header.data_size;
+    element_type_ = static_cast<ElementType>(header.element_type);
+    layout_ = layout;
+    num_values_ = header.num_elements;
+    Open(path);
+}
+
+QuantizedTable::QuantizedTable(const unsigned char *data, size_t size, ElementType element_type, size_t num_values,
+                               TableLayout layout)
+    : data_(data), size_(size), element_type_(element_type), layout_(layout), num_values_(num_values) {
+    if (!IsQuantizedType(element_type)) {
+        throw std::invalid_argument("Not a quantized element type");
+    }
+    Open("Quantized table");
+}
+
+void QuantizedTable::Open(const std::string &source) {
+    bool valid = size_ >= sizeof(QuantizedTableInfo);
+    if (valid) {
+        info_ = reinterpret_cast<const QuantizedTableInfo *>(data_);
+        // Every correction takes at least its move byte
+        valid = info_->block_values == BLOCK_VALUES && info_->num_blocks == GetNumBlocks() &&
+                info_->num_corrections <= size_;
+    }
+    // Walks the section up to its end: the codes, then the corrections
+    size_t end = sizeof(QuantizedTableInfo) + num_values_ * sizeof(uint16_t);
+    if (valid && element_type_ == ElementType::DeltaRice) {
+        const size_t offsets = (GetNumBlocks() + 1) * sizeof(uint32_t);
+        const uint32_t *block_offsets = reinterpret_cast<const uint32_t *>(data_ + sizeof(QuantizedTableInfo));
+        valid = size_ >= sizeof(QuantizedTableInfo) + offsets;
+        end = valid ? sizeof(QuantizedTableInfo) + offsets + block_offsets[GetNumBlocks()] + BIT_PADDING : 0;
+    }
+    if (valid && info_->num_corrections > 0) {
+        const size_t start = CorrectionsOffset(end);
+        const size_t index = (2 * GetNumCorrectionBlocks() + 1) * sizeof(uint32_t);
+        valid = size_ >= start + index;
+        if (valid) {
+            correction_starts_ = reinterpret_cast<const uint32_t *>(data_ + start);
+            correction_offsets_ = correction_starts_ + GetNumCorrectionBlocks();
+            correction_blocks_ = data_ + start + index;
+            end = start + index + correction_offsets_[GetNumCorrectionBlocks()] + BIT_PADDING;
+        }
+    }
+    valid = valid && end == size_;
+    if (!valid) {
+        correction_starts_ = nullptr;
+        correction_offsets_ = nullptr;
+        correction_blocks_ = nullptr;
+        data_ = nullptr;
+        info_ = nullptr;
+        throw std::runtime_error(source + " has a corrupt data section");
+    }
+}
+
+const StrategyFileHeader &QuantizedTable::GetHeader() const {
+    if (!file_.IsOpen()) {
+        throw std::logic_error("Quantized table is not mapped from a file");
+    }
+    return *reinterpret_cast<const StrategyFileHeader *>(file_.GetData());
+}
+
+bool QuantizedTable::VerifyChecksum() const {
+    const StrategyFileHeader &header = GetHeader();
+    return Checksum64(file_.GetData() + header.data_offset, header.data_size) == header.data_checksum;
+}
+
+double QuantizedTable::GetValue(size_t offset) const {
+    if (offset >= num_values_) {
+        throw std::out_of_range("Offset outside the quantized table");
+    }
+    const unsigned char *payload = data_ + sizeof(QuantizedTableInfo);
+    if (element_type_ == ElementType::DeltaRice) {
+        double values[BLOCK_VALUES];
+        const size_t block = offset / BLOCK_VALUES;
+        const uint32_t *offsets = reinterpret_cast<const uint32_t *>(payload);
+        DecodeDeltaRiceBlock(payload + (GetNumBlocks() + 1) * sizeof(uint32_t) + offsets[block],
+                             offset % BLOCK_VALUES + 1, info_->step, values);
+        return values[offset % BLOCK_VALUES];
+    }
+    const uint16_t code = reinterpret_cast<const uint16_t *>(payload)[offset];
+    return element_type_ == ElementType::Float16 ? HalfToDouble(code) : code * info_->step;
+}
+
+size_t QuantizedTable::DecodeBlock(size_t block, double *values) const {
+    if (block >= GetNumBlocks()) {
+        throw std::out_of_range("Block outside the quantized table");
+    }
+    const size_t begin = block * BLOCK_VALUES;
+    const size_t count = std::min(BLOCK_VALUES, num_values_ - begin);
+    const unsigned char *payload = data_ + sizeof(QuantizedTableInfo);
+    if (element_type_ == ElementType::DeltaRice) {
+        const uint32_t *offsets = reinterpret_cast<const uint32_t *>(payload);
+        DecodeDeltaRiceBlock(payload + (GetNumBlocks() + 1) * sizeof(uint32_t) + offsets[block], count,
+                             info_->step, values);
+        return count;
+    }
+    const uint16_t *codes = reinterpret_cast<const uint16_t *>(payload) + begin;
+    for (size_t i = 0; i < count; ++i) {
+        values[i] = element_type_ == ElementType::Float16 ? HalfToDouble(codes[i]) : codes[i] * info_->step;
+    }
+    return count;
+}
+
+uint8_t QuantizedTable::GetCorrection(ShortStateKey key, size_t decision) const {
+    static_assert(NO_CORRECTION == PolicyTable::NO_MOVE, "Corrections are policy bytes");
+    if (info_->num_corrections == 0) {
+        return NO_CORRECTION;
+    }
+    const uint64_t position = ReachableIndex::Offset(key, layout_) * PolicyTable::DECISIONS_PER_STATE + decision;
+    const uint32_t *starts_end = correction_starts_ + GetNumCorrectionBlocks();
+    const uint32_t *it = std::upper_bound(correction_starts_, starts_end, position);
+    if (it == correction_starts_) {
+        return NO_CORRECTION;
+    }
+    const size_t block = static_cast<size_t>(it - correction_starts_) - 1;
+    const size_t count = std::min<size_t>(BLOCK_VALUES, info_->num_corrections - block * BLOCK_VALUES);
+    const unsigned char *moves = correction_blocks_ + correction_offsets_[block];
+    BitReader reader(moves + count);
+    const uint32_t k = reader.Read(RICE_PARAMETER_BITS);
+    uint64_t current = *(it - 1);
+    for (size_t i = 0; current <= position; ++i) {
+        if (current == position) {
+            return moves[i];
+        }
+        if (i + 1 == count) {
+            break;
+        }
+        const uint64_t quotient = reader.ReadUnary();
+        current += ((quotient << k) | reader.Read(k)) + 1;
+    }
+    return NO_CORRECTION;
+}
+
+void QuantizedTable::Decode(std::vector<double> &values) const {
+    values.resize(num_values_);
+    for (size_t block = 0; block < GetNumBlocks(); ++block) {
+        DecodeBlock(block, values.data() + block * BLOCK_VALUES);
+    }
+}
+
+namespace {
+
+// Evaluators of both tables and the report of the states of one worker
+struct CompareWorker {
+    static constexpr size_t MAX_MOVES = NUM_CATEGORIES + (size_t{1} << NUM_DICE);  // scores and sub-keeps
+
+    CompareWorker(const double *exact, const double *approx, TableLayout layout)
+        : exact(exact), approx(approx), layout(layout), exact_evaluator(exact, layout),
+          approx_evaluator(approx, layout) {
+        report.min_decision_gap = std::numeric_limits<double>::infinity();
+    }
+
+    void CompareState(ShortStateKey key) {
+        exact_evaluator.Evaluate(key);
+        approx_evaluator.Evaluate(key);
+        for (size_t rerolls = 1; rerolls <= TurnEvaluator::TURN_REROLLS; ++rerolls) {
+            exact_evaluator.GetKeepValues(rerolls, exact_keeps[rerolls - 1]);
+            approx_evaluator.GetKeepValues(rerolls, approx_keeps[rerolls - 1]);
+        }
+        const uint64_t first_position = ReachableIndex::Offset(key, layout) * PolicyTable::DECISIONS_PER_STATE;
+        for (size_t roll = 0; roll < NUM_ROLLS; ++roll) {
+            // Score moves are the same with any rerolls left and come after the keeps, as in GetPossibleMoves
+            size_t num_scores = 0;
+            const uint32_t allowed = GetAllowedCategoryMask(key, static_cast<RollIndex>(roll));
+            for (uint32_t mask = allowed; mask != 0; mask &= mask - 1) {
+                uint32_t category = 0;
+                while (!((mask >> category) & 1u)) {
+                    ++category;
+                }
+                const ScoreOutcome outcome =
+                    GetScoreOutcome(key, static_cast<RollIndex>(roll), static_cast<Category>(category));
+                const size_t offset = ReachableIndex::Offset(outcome.next, layout);
+                score_categories[num_scores] = static_cast<uint8_t>(category);
+                exact_scores[num_scores] = outcome.points + exact[offset];
+                approx_scores[num_scores++] = outcome.points + approx[offset];
+            }
+            const auto sub_keeps = SUB_KEEP_TABLE.GetRow(static_cast<KeepIndex>(KEEP_OFFSETS[NUM_DICE] + roll));
+            for (size_t rerolls = 0; rerolls <= TurnEvaluator::TURN_REROLLS; ++rerolls) {
+                size_t num_moves = 0;
+                if (rerolls > 0) {
+                    for (KeepIndex keep : sub_keeps) {
+                        codes[num_moves] = static_cast<uint8_t>(num_moves);
+                        exact_values[num_moves] = exact_keeps[rerolls - 1][keep];
+                        approx_values[num_moves++] = approx_keeps[rerolls - 1][keep];
+                    }
+                }
+                for (size_t i = 0; i < num_scores; ++i) {
+                    codes[num_moves] = static_cast<uint8_t>(PolicyTable::FIRST_SCORE + score_categories[i]);
+                    exact_values[num_moves] = exact_scores[i];
+                    approx_values[num_moves++] = approx_scores[i];
+                }
+                CompareDecision(num_moves, first_position + PolicyTable::GetDecision(rerolls, roll));
+            }
+        }
+    }
+
+    void CompareDecision(size_t num_moves, uint64_t position) {
+        size_t best = 0;
+        size_t chosen = 0;
+        for (size_t i = 1; i < num_moves; ++i) {
+            if (exact_values[i] > exact_values[best]) {
+                best = i;
+            }
+            if (approx_values[i] > approx_values[chosen]) {
+                chosen = i;
+            }
+        }
+        const double best_value = exact_values[best];
+        for (size_t i = 0; i < num_moves; ++i) {
+            if (best_value - exact_values[i] > DECISION_TOLERANCE) {
+                report.min_decision_gap = std::min(report.min_decision_gap, best_value - exact_values[i]);
+            }
+        }
+        ++report.decisions;
+        const double loss = best_value - exact_values[chosen];
+        if (loss > DECISION_TOLERANCE) {
+            ++report.changed_decisions;
+            report.max_decision_loss = std::max(report.max_decision_loss, loss);
+            corrections.push_back(position << 8 | codes[best]);
+        }
+    }
+
+    const double *exact;
+    const double *approx;
+    TableLayout layout;
+    TurnEvaluator exact_evaluator;
+    TurnEvaluator approx_evaluator;
+    QuantizationReport report;
+    std::vector<uint64_t> corrections;
+    // Keeps with 1 and 2 rerolls left
+    std::array<std::array<double, NUM_KEEPS>, TurnEvaluator::TURN_REROLLS> exact_keeps{};
+    std::array<std::array<double, NUM_KEEPS>, TurnEvaluator::TURN_REROLLS> approx_keeps{};
+    std::array<uint8_t, NUM_CATEGORIES> score_categories{};
+    std::array<double, NUM_CATEGORIES> exact_scores{};
+    std::array<double, NUM_CATEGORIES> approx_scores{};
+    // Moves of one decision and their PolicyTable bytes
+    std::array<uint8_t, MAX_MOVES> codes{};
+    std::array<double, MAX_MOVES> exact_values{};
+    std::array<double, MAX_MOVES> approx_values{};
+};
+
+// States per scheduler chunk
+constexpr size_t CHUNK_STATES = 16;
+
+}  // namespace
+
+QuantizationReport CompareDecisions(const double *exact, const double *approx, size_t num_values,
+                                    TableLayout layout, size_t num_threads, size_t state_stride,
+                                    std::vector<uint64_t> *corrections) {
+    const size_t expected = layout == TableLayout::ShortStateKeyReachable ? ReachableIndex::NUM_REACHABLE
+                                                                          : ShortStateKey::NUM_INDICES;
+    if (num_values != expected || state_stride == 0 ||
+        (layout != TableLayout::ShortStateKeyDense && layout != TableLayout::ShortStateKeyReachable)) {
+        throw std::invalid_argument("Tables to compare must hold one value per state of the layout");
+    }
+
+    std::vector<ShortStateKey> keys;
+    size_t reachable = 0;
+    for (size_t index = 0; index < ShortStateKey::NUM_INDICES; ++index) {
+        const ShortStateKey key = ShortStateKey::FromIndex(index);
+        if (IsReachable(key) && !key.IsGameOver() && reachable++ % state_stride == 0) {
+            keys.push_back(key);
+        }
+    }
+
+    TaskScheduler scheduler(num_threads);
+    std::vector<std::unique_ptr<CompareWorker>> workers;
+    for (size_t worker = 0; worker < scheduler.GetNumThreads(); ++worker) {
+        workers.push_back(std::make_unique<CompareWorker>(exact, approx, layout));
+    }
+    scheduler.ParallelFor(keys.size(), CHUNK_STATES, [&](size_t begin, size_t end, size_t worker) {
+        for (size_t i = begin; i < end; ++i) {
+            workers[worker]->CompareState(keys[i]);
+        }
+    });
+
+    QuantizationReport report;
+    report.min_decision_gap = std::numeric_limits<double>::infinity();
+    for (size_t i = 0; i < num_values; ++i) {
+        report.max_ev_error = std::max(report.max_ev_error, std::abs(approx[i] - exact[i]));
+    }
+    for (const auto &worker : workers) {
+        report.decisions += worker->report.decisions;
+        report.changed_decisions += worker->report.changed_decisions;
+        report.max_decision_loss = std::max(report.max_decision_loss, worker->report.max_decision_loss);
+        report.min_decision_gap = std::min(report.min_decision_gap, worker->report.min_decision_gap);
+    }
+    if (corrections != nullptr) {
+        corrections->clear();
+        for (const auto &worker : workers) {
+            corrections->insert(corrections->end(), worker->corrections.begin(), worker->corrections.end());
+        }
+        std::sort(corrections->begin(), corrections->end());
+    }
+    return report;
+}
@@ -0,0 +1,139 @@
+#pragma once
+
+#include "../game_state/short_state_key.h"
+#include "strategy_file.h"
+#include "table_layout.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Start of the data section of a quantized strategy table, followed by the
+// encoded values.
+//
+// Fixed16 stores round(value / step) as uint16, step being the largest value
+// over 65535. Float16 stores IEEE 754 half floats. DeltaRice stores
+// round(value / step) in blocks of BLOCK_VALUES: an array of num_blocks + 1
+// byte offsets of the blocks, then every block as its first code in 32 bits,
+// a 5-bit Rice parameter k and the differences to the previous code, zigzag
+// mapped, as a unary quotient and k remainder bits, least significant bit
+// first. Any block decodes on its own.
+//
+// Corrections, if any, follow the codes at the next multiple of 4 bytes from
+// the start of the section: the decisions whose best move under the decoded
+// values loses more than DECISION_TOLERANCE, in increasing order of p, the
+// position of the decision in a PolicyTable of the layout, each with the
+// PolicyTable byte of the exact best move. They are blocked like DeltaRice
+// values: the first p of every block as uint32, num_correction_blocks + 1
+// byte offsets of the blocks, then every block as its move bytes, a 5-bit
+// Rice parameter k and the gaps p - previous p - 1 Rice coded.
+struct QuantizedTableInfo {
+    double step;       // of the fixed point codes, 0 for Float16
+    double max_error;  // largest |decoded - exact| over the table
+    uint32_t block_values;
+    uint32_t num_blocks;
+    uint64_t num_corrections;
+};
+
+static_assert(sizeof(QuantizedTableInfo) == 32, "Info layout must not change");
+
+// Data section of a table of the element type (Fixed16, Float16 or DeltaRice)
+// for the values, all non-negative and in layout order. step == 0 picks the
+// default of the type; Float16 has none. corrections come from
+// CompareDecisions over the decoded values, (p << 8) | code each. Throws
+// std::invalid_argument for other types, values the codes cannot hold and
+// corrections that are unsorted or past 32-bit positions.
+std::vector<unsigned char> EncodeQuantizedValues(const double *values, size_t num_values, ElementType element_type,
+                                                 double step = 0.0, const std::vector<uint64_t> &corrections = {});
+
+// Read-only view of a quantized strategy table, memory-mapped from a file
+// written by WriteStrategyFile or over the data section of one in memory.
+//
+// Fixed16 and Float16 decode a value in place, DeltaRice decodes the start of
+// its block, at most BLOCK_VALUES - 1 codes; a caller reading many values in
+// layout order is better served by DecodeBlock. A TurnEvaluator or an Advisor
+// can read the values straight from the table, and the Advisor follows its
+// corrections.
+class QuantizedTable {
+public:
+    static constexpr size_t BLOCK_VALUES = 64;
+    static constexpr uint32_t DELTA_STEP_BITS = 12;  // default DeltaRice step: 2^-12
+    static constexpr uint8_t NO_CORRECTION = 0xFF;   // PolicyTable::NO_MOVE
+
+    QuantizedTable() = default;
+    // Throws std::runtime_error when the file is not a quantized table
+    explicit QuantizedTable(const std::string &path);
+    // Data as returned by EncodeQuantizedValues, which must outlive the view
+    QuantizedTable(const unsigned char *data, size_t size, ElementType element_type, size_t num_values,
+                   TableLayout layout = TableLayout::ShortStateKeyDense);
+
+    bool IsOpen() const { return data_ != nullptr; }
+    // Only tables mapped from files have a header
+    const StrategyFileHeader &GetHeader() const;
+    const QuantizedTableInfo &GetInfo() const { return *info_; }
+    bool VerifyChecksum() const;
+
+    ElementType GetElementType() const { return element_type_; }
+    TableLayout GetLayout() const { return layout_; }
+    size_t GetNumValues() const { return num_values_; }
+    size_t GetNumBlocks() const { return (num_values_ + BLOCK_VALUES - 1) / BLOCK_VALUES; }
+    // Bytes of the data section
+    size_t GetDataSize() const { return size_; }
+
+    double GetStateValue(ShortStateKey key) const { return GetValue(ReachableIndex::Offset(key, layout_)); }
+    double GetValue(size_t offset) const;
+
+    // Values of the block in layout order, BLOCK_VALUES of them but in the
+    // last block; returns their count
+    size_t DecodeBlock(size_t block, double *values) const;
+    void Decode(std::vector<double> &values) const;
+
+    size_t GetNumCorrections() const { return info_->num_corrections; }
+    size_t GetNumCorrectionBlocks() const { return (GetNumCorrections() + BLOCK_VALUES - 1) / BLOCK_VALUES; }
+    // PolicyTable byte of the exact best move of the decision, as numbered by
+    // PolicyTable::GetDecision, when the decoded values pick a worse one;
+    // NO_CORRECTION otherwise. Decodes at most a block of corrections.
+    uint8_t GetCorrection(ShortStateKey key, size_t decision) const;
+
+private:
+    void Open(const std::string &source);
+
+    MappedFile file_;
+    const unsigned char *data_{nullptr};
+    size_t size_{0};
+    const QuantizedTableInfo *info_{nullptr};
+    const uint32_t *correction_starts_{nullptr};
+    const uint32_t *correction_offsets_{nullptr};
+    const unsigned char *correction_blocks_{nullptr};
+    ElementType element_type_{ElementType::Fixed16};
+    TableLayout layout_{TableLayout::ShortStateKeyDense};
+    size_t num_values_{0};
+};
+
+// Moves whose values differ by less count as equally good
+constexpr double DECISION_TOLERANCE = 1e-9;
+
+// How far the best moves of a table move away from those of the exact one
+struct QuantizationReport {
+    double max_ev_error{0.0};       // largest |approx - exact| over the turn-start values
+    uint64_t decisions{0};          // (state, rerolls left, roll) of the compared states
+    uint64_t changed_decisions{0};  // the best move of approx is worse than that of exact
+    double max_decision_loss{0.0};  // exact value lost by the worst changed decision
+    // Smallest gap in exact value between the best and a worse move of a
+    // decision: no decision changes while every move value is off by less
+    // than half of it, and move values are off by at most max_ev_error
+    double min_decision_gap{0.0};
+};
+
+// Compares the best moves of every decision of the reachable states that are
+// not over, or of every state_stride-th of them, under two tables of the same
+// layout. With corrections, also lists the changed decisions with their
+// exact best move, the first in GetPossibleMoves order as with Advisor, in
+// the format of QuantizedTableInfo. Moves closer than DECISION_TOLERANCE are
+// left alone: about a million decisions have such near ties, and storing
+// them would make every encoding larger than the exact table. Throws
+// std::invalid_argument when the tables do not fit the layout.
+QuantizationReport CompareDecisions(const double *exact, const double *approx, size_t num_values,
+                                    TableLayout layout = TableLayout::ShortStateKeyDense, size_t num_threads = 0,
+                                    size_t state_stride = 1, std::vector<uint64_t> *corrections = nullptr);
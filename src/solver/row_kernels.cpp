@@ -0,0 +1,154 @@
+#include "row_kernels.h"
+#include "turn_kernels.h"
+#include "../move/reroll_matrix.h"
+
+#if defined(__GNUC__)
+#define ROW_KERNEL_INLINE inline __attribute__((always_inline))
+#else
+#define ROW_KERNEL_INLINE inline
+#endif
+
+namespace {
+
+// Row loops, inlined into a copy per target
+
+// rows[roll] = max over the score moves of the roll of their shifted next-state rows
+ROW_KERNEL_INLINE void ScoreRowsImpl(const float *const *sources, const uint16_t *source_offsets, float *rows,
+                                     size_t length, size_t stride) {
+    for (size_t roll = 0; roll < NUM_ROLLS; ++roll) {
+        float *__restrict out = rows + roll * stride;
+        const float *first = sources[source_offsets[roll]];
+        for (size_t t = 0; t < length; ++t) {
+            out[t] = first[t];
+        }
+        for (size_t source = source_offsets[roll] + 1; source < source_offsets[roll + 1]; ++source) {
+            const float *__restrict in = sources[source];
+            for (size_t t = 0; t < length; ++t) {
+                out[t] = in[t] > out[t] ? in[t] : out[t];
+            }
+        }
+    }
+}
+
+// keeps[keep] = sum over rolls of P(keep -> roll) * previous[roll], for keeps that reroll dice
+ROW_KERNEL_INLINE void ReduceKeepsImpl(const float *previous, float *keeps, size_t length, size_t stride) {
+    const uint16_t *row_offsets = REROLL_MATRIX.RowOffsets();
+    const RollIndex *rolls = REROLL_MATRIX.Rolls();
+    const double *probabilities = REROLL_MATRIX.Probabilities();
+    for (size_t keep = 0; keep < NUM_PARTIAL_KEEPS; ++keep) {
+        float *__restrict out = keeps + keep * stride;
+        size_t entry = row_offsets[keep];
+        const float first_probability = static_cast<float>(probabilities[entry]);
+        const float *__restrict first = previous + rolls[entry] * stride;
+        for (size_t t = 0; t < length; ++t) {
+            out[t] = first_probability * first[t];
+        }
+        for (++entry; entry < row_offsets[keep + 1]; ++entry) {
+            const float probability = static_cast<float>(probabilities[entry]);
+            const float *__restrict in = previous + rolls[entry] * stride;
+            for (size_t t = 0; t < length; ++t) {
+                out[t] += probability * in[t];
+            }
+        }
+    }
+}
+
+// rows[roll] = max of scoring now and every keep of the roll; keeping all
+// five dice is worth the previous level of the roll itself
+ROW_KERNEL_INLINE void MaxRollsImpl(const float *score_rows, const float *keeps, const float *previous, float *rows,
+                                    size_t length, size_t stride) {
+    for (size_t roll = 0; roll < NUM_ROLLS; ++roll) {
+        float *__restrict out = rows + roll * stride;
+        const float *__restrict score = score_rows + roll * stride;
+        for (size_t t = 0; t < length; ++t) {
+            out[t] = score[t];
+        }
+        for (KeepIndex keep : SUB_KEEP_TABLE.GetRow(static_cast<KeepIndex>(NUM_PARTIAL_KEEPS + roll))) {
+            const float *__restrict in = keep >= NUM_PARTIAL_KEEPS ? previous + (keep - NUM_PARTIAL_KEEPS) * stride
+                                                                   : keeps + keep * stride;
+            for (size_t t = 0; t < length; ++t) {
+                out[t] = in[t] > out[t] ? in[t] : out[t];
+            }
+        }
+    }
+}
+
+// out = sum over rolls of P(roll) * rows[roll]
+ROW_KERNEL_INLINE void TurnStartImpl(const float *rows, float *out, size_t length, size_t stride) {
+    float *__restrict result = out;
+    for (size_t t = 0; t < length; ++t) {
+        result[t] = 0.0f;
+    }
+    for (size_t roll = 0; roll < NUM_ROLLS; ++roll) {
+        const float probability = static_cast<float>(ROLL_TABLE.probability[roll]);
+        const float *__restrict in = rows + roll * stride;
+        for (size_t t = 0; t < length; ++t) {
+            result[t] += probability * in[t];
+        }
+    }
+}
+
+
+#define DEFINE_ROW_KERNELS(SUFFIX, ATTRIBUTES)                                                                   \
+    ATTRIBUTES void ScoreRows##SUFFIX(const float *const *sources, const uint16_t *source_offsets, float *rows, \
+                                      size_t length, size_t stride) {                                          \
+        ScoreRowsImpl(sources, source_offsets, rows, length, stride);                                          \
+    }                                                                                                          \
+    ATTRIBUTES void ReduceKeeps##SUFFIX(const float *previous, float *keeps, size_t length, size_t stride) {   \
+        ReduceKeepsImpl(previous, keeps, length, stride);                                                      \
+    }                                                                                                          \
+    ATTRIBUTES void MaxRolls##SUFFIX(const float *score_rows, const float *keeps, const float *previous,       \
+                                     float *rows, size_t length, size_t stride) {                              \
+        MaxRollsImpl(score_rows, keeps, previous, rows, length, stride);                                       \
+    }                                                                                                          \
+    ATTRIBUTES void TurnStart##SUFFIX(const float *rows, float *out, size_t length, size_t stride) {           \
+        TurnStartImpl(rows, out, length, stride);                                                              \
+    }                                                                                                          \
+    constexpr RowKernels ROW_KERNELS_##SUFFIX{ScoreRows##SUFFIX, ReduceKeeps##SUFFIX, MaxRolls##SUFFIX,        \
+                                              TurnStart##SUFFIX};
+
+DEFINE_ROW_KERNELS(Scalar, )
+#ifdef YAHTZEE_X86_KERNELS
+DEFINE_ROW_KERNELS(Avx2, __attribute__((target("avx2"))))
+DEFINE_ROW_KERNELS(Avx512, __attribute__((target("avx512f"))))
+#endif
+
+#undef DEFINE_ROW_KERNELS
+
+}  // namespace
+
+const RowKernels &GetRowKernels() {
+#ifdef YAHTZEE_X86_KERNELS
+    switch (DetectKernelIsa()) {
+        case KernelIsa::Avx512: return ROW_KERNELS_Avx512;
+        case KernelIsa::Avx2: return ROW_KERNELS_Avx2;
+        default: break;
+    }
+#endif
+    return ROW_KERNELS_Scalar;
+}
+
+
+uint32_t GetMaxRemainingScore(ShortStateKey key) {
+    const uint32_t open = ~key.UsedMask() & ShortStateKey::FULL_MASK;
+    uint32_t total = 0;
+    uint32_t upper = 0;
+    for (size_t category = 0; category < NUM_CATEGORIES; ++category) {
+        if (open & (uint32_t{1} << category)) {
+            total += MAX_CATEGORY_POINTS[category];
+            upper += category < NUM_UPPER_CATEGORIES ? MAX_CATEGORY_POINTS[category] : 0;
+        }
+    }
+    const uint32_t remaining_upper = key.RemainingUpperBonus();
+    if (remaining_upper > 0 && upper >= remaining_upper) {
+        total += UPPER_BONUS;
+    }
+    // Every turn after a scored yahtzee can earn the yahtzee bonus
+    const uint32_t open_count = static_cast<uint32_t>(NUM_CATEGORIES - key.FilledCount());
+    if (key.IsYahtzeeRecorded()) {
+        total += open_count * YAHTZEE_BONUS;
+    } else if (!key.IsCategoryUsed(Category::Yahtzee)) {
+        total += (open_count - 1) * YAHTZEE_BONUS;
+    }
+    return total;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "../game_state/category.h"
+#include "../game_state/dice_index.h"
+#include "../game_state/short_state_key.h"
+#include "../move/score_table.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Loops of the solvers that keep a row of probabilities per state
+// (ThresholdSolver, DuelSolver), selected at runtime by CPU features.
+//
+// A row runs over a score offset: the threshold still to reach, or the lead
+// over the opponent. Every loop is elementwise along the row, so every
+// instruction set gives the same results. Rows of a level are stride floats
+// apart, the stride a multiple of ROW_ALIGNMENT.
+
+namespace row_kernels_detail {
+
+constexpr std::array<uint32_t, NUM_CATEGORIES> BuildMaxCategoryPoints() {
+    std::array<uint32_t, NUM_CATEGORIES> points{};
+    for (size_t roll = 0; roll < NUM_ROLLS; ++roll) {
+        for (size_t category = 0; category < NUM_CATEGORIES; ++category) {
+            points[category] = std::max<uint32_t>({points[category], SCORE_TABLE[roll][category],
+                                                   JOKER_SCORE_TABLE[roll][category]});
+        }
+    }
+    return points;
+}
+
+}  // namespace row_kernels_detail
+
+// Most points each category can score, jokers included
+inline constexpr std::array<uint32_t, NUM_CATEGORIES> MAX_CATEGORY_POINTS =
+    row_kernels_detail::BuildMaxCategoryPoints();
+
+// Most points of one score move: a joker in the sixes with the upper and the yahtzee bonus
+constexpr size_t MAX_MOVE_POINTS = MAX_CATEGORY_POINTS[NUM_UPPER_CATEGORIES - 1] + UPPER_BONUS + YAHTZEE_BONUS;
+static_assert(MAX_MOVE_POINTS >= YAHTZEE_SCORE, "Padding must cover every score move");
+
+// Keeps that reroll at least one die
+constexpr size_t NUM_PARTIAL_KEEPS = KEEP_OFFSETS[NUM_DICE];
+constexpr size_t ROW_ALIGNMENT = 8;
+
+// Most points the rest of the game can still score from the turn-start state
+uint32_t GetMaxRemainingScore(ShortStateKey key);
+
+struct RowKernels {
+    // rows[roll] = max over the sources of the roll, sources[source_offsets[roll]]
+    // up to sources[source_offsets[roll + 1]]
+    void (*score_rows)(const float *const *sources, const uint16_t *source_offsets, float *rows, size_t length,
+                       size_t stride);
+    // keeps[keep] = sum over rolls of P(keep -> roll) * previous[roll], for keeps that reroll dice
+    void (*reduce_keeps)(const float *previous, float *keeps, size_t length, size_t stride);
+    // rows[roll] = max of score_rows[roll] and every keep of the roll; keeping
+    // all five dice is worth previous[roll]
+    void (*max_rolls)(const float *score_rows, const float *keeps, const float *previous, float *rows,
+                      size_t length, size_t stride);
+    // out = sum over rolls of P(roll) * rows[roll]
+    void (*turn_start)(const float *rows, float *out, size_t length, size_t stride);
+};
+
+// Kernels for the best instruction set the CPU supports
+const RowKernels &GetRowKernels();
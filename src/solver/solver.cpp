@@ -0,0 +1,107 @@
+#include "solver.h"
+#include "table_layout.h"
+#include "turn_evaluator.h"
+#include "../metrics/metrics.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+template<typename Rules>
+std::vector<typename Rules::StateKey> GetLayerStates(size_t filled_count) {
+    using StateKey = typename Rules::StateKey;
+    if (filled_count > StateKey(StateKey::FULL_MASK, 0, false).FilledCount()) {
+        throw std::out_of_range("Layer cannot exceed the number of categories");
+    }
+    std::vector<StateKey> states;
+    for (uint32_t mask = 0; mask <= StateKey::FULL_MASK; ++mask) {
+        if (StateKey(mask, 0, false).FilledCount() != filled_count) {
+            continue;
+        }
+        for (bool yahtzee_recorded : {false, true}) {
+            if (yahtzee_recorded && !StateKey::HAS_YAHTZEE_FLAG) {
+                continue;
+            }
+            for (uint32_t remaining = 0; remaining <= StateKey::UPPER_THRESHOLD; ++remaining) {
+                StateKey key(mask, remaining, yahtzee_recorded);
+                if (IsReachable<Rules>(key)) {
+                    states.push_back(key);
+                }
+            }
+        }
+    }
+    return states;
+}
+
+template<typename Rules>
+BasicSolver<Rules>::BasicSolver() : values_(StateKey::NUM_INDICES, 0.0) {}
+
+template<typename Rules>
+void BasicSolver<Rules>::Solve(size_t num_threads) {
+    TaskScheduler scheduler(num_threads);
+    layer_stats_.clear();
+    for (size_t filled = Rules::NUM_CATEGORIES + 1; filled-- > 0;) {
+        SolveLayer(filled, scheduler);
+    }
+}
+
+template<typename Rules>
+void BasicSolver<Rules>::SolveLayer(size_t filled_count, size_t num_threads) {
+    TaskScheduler scheduler(num_threads);
+    SolveLayer(filled_count, scheduler);
+}
+
+template<typename Rules>
+void BasicSolver<Rules>::SolveLayer(size_t filled_count, TaskScheduler &scheduler) {
+    const std::vector<StateKey> states = GetLayerStates<Rules>(filled_count);
+    std::vector<BasicTurnEvaluator<Rules>> evaluators(scheduler.GetNumThreads(),
+                                                      BasicTurnEvaluator<Rules>(values_.data()));
+    ParallelForStats stats = scheduler.ParallelFor(states.size(), CHUNK_STATES,
+                                                   [&](size_t begin, size_t end, size_t worker) {
+        BasicTurnEvaluator<Rules> &evaluator = evaluators[worker];
+        for (size_t state = begin; state < end; ++state) {
+            evaluator.Evaluate(states[state]);
+            values_[states[state].Index()] = evaluator.GetTurnStartValue();
+        }
+    });
+
+    LayerStats layer;
+    layer.filled_count = filled_count;
+    layer.num_states = states.size();
+    layer.num_threads = scheduler.GetNumThreads();
+    layer.seconds = stats.seconds;
+    layer.imbalance = stats.Imbalance();
+    layer.steals = stats.steals;
+    layer_stats_.push_back(layer);
+
+    const auto nanoseconds = static_cast<uint64_t>(stats.seconds * 1e9);
+    CountMetric(MetricCounter::SolvedStates, states.size());
+    CountMetric(MetricCounter::SolveNanoseconds, nanoseconds);
+    RecordMetric(MetricHistogram::SolveLayerNanoseconds, nanoseconds);
+}
+
+template<typename Rules>
+double BasicSolver<Rules>::GetStateValue(StateKey key) const {
+    return values_[key.Index()];
+}
+
+template<typename Rules>
+const std::vector<double> &BasicSolver<Rules>::GetValues() const {
+    return values_;
+}
+
+template<typename Rules>
+const std::vector<LayerStats> &BasicSolver<Rules>::GetLayerStats() const {
+    return layer_stats_;
+}
+
+template std::vector<ShortStateKey> GetLayerStates<YahtzeeRules>(size_t filled_count);
+template std::vector<ShortStateKey> GetLayerStates<FreeJokerYahtzeeRules>(size_t filled_count);
+template std::vector<YatzyRules::StateKey> GetLayerStates<YatzyRules>(size_t filled_count);
+template std::vector<MaxiYatzyNoSavedRerollsRules::StateKey>
+GetLayerStates<MaxiYatzyNoSavedRerollsRules>(size_t filled_count);
+
+template class BasicSolver<YahtzeeRules>;
+template class BasicSolver<FreeJokerYahtzeeRules>;
+template class BasicSolver<YatzyRules>;
+template class BasicSolver<MaxiYatzyNoSavedRerollsRules>;
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "../game_state/rules.h"
+#include "../game_state/short_game_state.h"
+#include "../game_state/short_state_key.h"
+#include "task_scheduler.h"
+
+#include <cstddef>
+#include <vector>
+
+// Timing of one solved layer
+struct LayerStats {
+    size_t filled_count{0};
+    size_t num_states{0};
+    size_t num_threads{0};
+    double seconds{0.0};
+    double imbalance{1.0};  // busiest worker over the mean, see ParallelForStats
+    size_t steals{0};
+};
+
+// Reachable turn-start states of the rules (see IsReachable) with exactly filled_count
+// used categories, in index order of (used mask, yahtzee flag) and then upper remainder
+template<typename Rules = YahtzeeRules>
+std::vector<typename Rules::StateKey> GetLayerStates(size_t filled_count);
+
+// Retrograde solver for the optimal expected score of the rest of the game.
+//
+// A value is stored for every ShortGameState at the start of a turn (before the
+// first roll): the set of used categories, the points still missing for the
+// upper bonus and whether a Yahtzee has been scored. States are solved in
+// layers by the number of used categories, from the full sheet backwards,
+// skipping the upper remainders no game can reach with the used categories. The
+// states of a layer are independent but differ a lot in cost, so they run as
+// small chunks on a work-stealing TaskScheduler. Values are indexed by
+// ShortStateKey::Index(), unreachable keys keep the value 0.
+//
+// BasicSolver solves any rule set of rules.h the same way, its states being
+// the StateKey of the rules and its turns those of the dice of the rules;
+// Solver is the one of the Yahtzee rules. Maxi Yatzy without saved rerolls
+// has a table of 2^27 values, 1 GiB, and about a hundred times the states of
+// Yahtzee.
+template<typename Rules>
+class BasicSolver {
+public:
+    using StateKey = typename Rules::StateKey;
+
+    BasicSolver();
+    ~BasicSolver() = default;
+
+    // Solve every layer; num_threads == 0 uses all hardware threads
+    void Solve(size_t num_threads = 0);
+
+    // Solve the states with exactly filled_count used categories.
+    // All layers with more used categories must already be solved.
+    void SolveLayer(size_t filled_count, size_t num_threads = 0);
+
+    // Expected score of the rest of the game from the start of a turn.
+    // Dice and rerolls of the state are ignored.
+    template<typename GameStateType>
+    double GetStateValue(const GameStateType &state) const {
+        return GetStateValue(state.GetKey());
+    }
+    double GetStateValue(StateKey key) const;
+
+    // Whole table in StateKey index order, as written to strategy files
+    const std::vector<double> &GetValues() const;
+
+    // Layers in the order solved; Solve starts a new list
+    const std::vector<LayerStats> &GetLayerStats() const;
+
+private:
+    // States per scheduler chunk
+    static constexpr size_t CHUNK_STATES = 16;
+
+    void SolveLayer(size_t filled_count, TaskScheduler &scheduler);
+
+    std::vector<double> values_;
+    std::vector<LayerStats> layer_stats_;
+};
+
+using Solver = BasicSolver<YahtzeeRules>;
@@ -0,0 +1,87 @@
+#include "state_value_cache.h"
+#include "../metrics/metrics.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+double CacheStats::HitRate() const {
+    const size_t lookups = hits + misses;
+    return lookups == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(lookups);
+}
+
+StateValueCache::StateValueCache(size_t capacity, size_t num_shards) : capacity_(capacity) {
+    if (capacity == 0 || num_shards == 0) {
+        throw std::invalid_argument("Cache needs at least one entry and one shard");
+    }
+    num_shards = std::min(num_shards, capacity);
+    for (size_t i = 0; i < num_shards; ++i) {
+        shards_.push_back(std::make_unique<Shard>());
+        shards_.back()->capacity = capacity / num_shards + (i < capacity % num_shards ? 1 : 0);
+    }
+}
+
+StateValueCache::Shard &StateValueCache::GetShard(ShortStateKey key) {
+    // Neighbouring keys differ in the upper remainder, multiplying spreads them
+    const uint64_t hash = uint64_t{key.Value()} * 0x9E3779B97F4A7C15ull;
+    return *shards_[(hash >> 32) % shards_.size()];
+}
+
+std::optional<double> StateValueCache::Find(ShortStateKey key) {
+    Shard &shard = GetShard(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto found = shard.index.find(key.Value());
+    if (found == shard.index.end()) {
+        ++shard.stats.misses;
+        CountMetric(MetricCounter::StateCacheMisses);
+        return std::nullopt;
+    }
+    ++shard.stats.hits;
+    CountMetric(MetricCounter::StateCacheHits);
+    shard.entries.splice(shard.entries.begin(), shard.entries, found->second);
+    return found->second->second;
+}
+
+void StateValueCache::Insert(ShortStateKey key, double value) {
+    Shard &shard = GetShard(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto found = shard.index.find(key.Value());
+    if (found != shard.index.end()) {
+        found->second->second = value;
+        shard.entries.splice(shard.entries.begin(), shard.entries, found->second);
+        return;
+    }
+    if (shard.entries.size() >= shard.capacity) {
+        shard.index.erase(shard.entries.back().first);
+        shard.entries.pop_back();
+        ++shard.stats.evictions;
+    }
+    shard.entries.emplace_front(key.Value(), value);
+    shard.index.emplace(key.Value(), shard.entries.begin());
+    ++shard.stats.insertions;
+}
+
+void StateValueCache::Clear() {
+    for (auto &shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        shard->entries.clear();
+        shard->index.clear();
+        shard->stats = CacheStats{};
+    }
+}
+
+size_t StateValueCache::GetCapacity() const {
+    return capacity_;
+}
+
+CacheStats StateValueCache::GetStats() const {
+    CacheStats total;
+    for (const auto &shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        total.hits += shard->stats.hits;
+        total.misses += shard->stats.misses;
+        total.insertions += shard->stats.insertions;
+        total.evictions += shard->stats.evictions;
+        total.size += shard->entries.size();
+    }
+    return total;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "../game_state/short_state_key.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Counters of a StateValueCache since construction or the last Clear
+struct CacheStats {
+    size_t hits{0};
+    size_t misses{0};
+    size_t insertions{0};
+    size_t evictions{0};
+    size_t size{0};
+
+    // Hits over lookups, 0 before the first lookup
+    double HitRate() const;
+};
+
+// Bounded map from turn-start states to values, safe for concurrent use.
+//
+// Keys are spread over shards, each with its own lock and its own least
+// recently used list, so threads working on different states rarely wait for
+// each other. A full shard evicts its least recently used entry.
+class StateValueCache {
+public:
+    // capacity is the number of values held over all shards
+    explicit StateValueCache(size_t capacity, size_t num_shards = 16);
+
+    std::optional<double> Find(ShortStateKey key);
+    void Insert(ShortStateKey key, double value);
+    void Clear();
+
+    size_t GetCapacity() const;
+    CacheStats GetStats() const;
+
+private:
+    using EntryList = std::list<std::pair<uint32_t, double>>;
+
+    struct Shard {
+        std::mutex mutex;
+        size_t capacity{0};
+        EntryList entries;  // most recently used first
+        std::unordered_map<uint32_t, EntryList::iterator> index;
+        CacheStats stats;
+    };
+
+    Shard &GetShard(ShortStateKey key);
+
+    size_t capacity_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+};
@@ -0,0 +1,261 @@
+#include "strategy_file.h"
+#include "quantized_table.h"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr uint64_t DATA_ALIGNMENT = 4096;
+
+uint64_t HeaderChecksum(StrategyFileHeader header) {
+    header.header_checksum = 0;
+    return Checksum64(&header, sizeof(header));
+}
+
+}  // namespace
+
+uint64_t Checksum64(const void *data, size_t size) {
+    const unsigned char *bytes = static_cast<const unsigned char *>(data);
+    uint64_t hash = 0x9E3779B97F4A7C15ull ^ size;
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+        uint64_t word;
+        std::memcpy(&word, bytes + i, sizeof(word));
+        hash = (hash ^ word) * 0xBF58476D1CE4E5B9ull;
+        hash ^= hash >> 31;
+    }
+    for (; i < size; ++i) {
+        hash = (hash ^ bytes[i]) * 0x94D049BB133111EBull;
+        hash ^= hash >> 29;
+    }
+    return hash;
+}
+
+void WriteStrategyFile(const std::string &path, const double *values, size_t num_values,
+                       RuleVariant rule_variant, TableLayout layout, ElementType element_type,
+                       const std::vector<uint64_t> &corrections) {
+    if (num_values != ShortStateKey::NUM_INDICES) {
+        throw std::invalid_argument("Strategy table must hold one value per state index");
+    }
+    std::vector<double> reachable;
+    if (layout == TableLayout::ShortStateKeyReachable) {
+        reachable.reserve(ReachableIndex::NUM_REACHABLE);
+        for (size_t i = 0; i < num_values; ++i) {
+            if (IsReachable(ShortStateKey::FromIndex(i))) {
+                reachable.push_back(values[i]);
+            }
+        }
+        values = reachable.data();
+        num_values = reachable.size();
+    } else if (layout != TableLayout::ShortStateKeyDense) {
+        throw std::invalid_argument("Unknown table layout");
+    }
+
+    StrategyFileHeader header{};
+    header.rule_variant = static_cast<uint32_t>(rule_variant);
+    header.layout = static_cast<uint32_t>(layout);
+    header.element_type = static_cast<uint32_t>(element_type);
+    header.num_elements = num_values;
+    if (element_type == ElementType::Float64) {
+        if (!corrections.empty()) {
+            throw std::invalid_argument("Only quantized tables have corrections");
+        }
+        header.element_size = sizeof(double);
+        WriteStrategyFileData(path, header, values, num_values * sizeof(double));
+        return;
+    }
+    // Variable-size codes have no element size
+    header.element_size = element_type == ElementType::DeltaRice ? 0 : sizeof(uint16_t);
+    const std::vector<unsigned char> data = EncodeQuantizedValues(values, num_values, element_type, 0.0, corrections);
+    WriteStrategyFileData(path, header, data.data(), data.size());
+}
+
+void WriteStrategyFileData(const std::string &path, StrategyFileHeader header, const void *data, size_t size) {
+    header.magic = StrategyFileHeader::MAGIC;
+    header.version = StrategyFileHeader::VERSION;
+    header.header_size = sizeof(StrategyFileHeader);
+    header.data_offset = DATA_ALIGNMENT;
+    header.data_size = size;
+    header.data_checksum = Checksum64(data, size);
+    header.header_checksum = HeaderChecksum(header);
+
+    const std::string temporary = path + ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            throw std::runtime_error("Cannot open " + temporary + " for writing");
+        }
+        std::vector<char> page(DATA_ALIGNMENT, 0);
+        std::memcpy(page.data(), &header, sizeof(header));
+        out.write(page.data(), static_cast<std::streamsize>(page.size()));
+        out.write(static_cast<const char *>(data), static_cast<std::streamsize>(size));
+        out.close();
+        if (!out) {
+            throw std::runtime_error("Failed to write " + temporary);
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(temporary, path, error);
+    if (error) {
+        std::remove(temporary.c_str());
+        throw std::runtime_error("Cannot rename " + temporary + " to " + path);
+    }
+}
+
+void CheckStrategyFileHeader(const std::string &path, const StrategyFileHeader &header, size_t file_size) {
+    const char *error = nullptr;
+    if (file_size < sizeof(StrategyFileHeader)) {
+        error = " is too small for a strategy table";
+    } else if (header.magic != StrategyFileHeader::MAGIC) {
+        error = " is not a strategy table";
+    } else if (header.version != StrategyFileHeader::VERSION || header.header_size != sizeof(StrategyFileHeader)) {
+        error = " has an unsupported version";
+    } else if (header.header_checksum != HeaderChecksum(header)) {
+        error = " has a corrupt header";
+    } else if (header.data_offset % alignof(double) != 0 || header.data_offset > file_size ||
+               header.data_size > file_size - header.data_offset) {
+        error = " is truncated";
+    }
+    if (error != nullptr) {
+        throw std::runtime_error(path + error);
+    }
+}
+
+MappedFile::MappedFile(const std::string &path) {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("Cannot open " + path);
+    }
+    file_handle_ = file;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        Close();
+        throw std::runtime_error("Cannot stat " + path);
+    }
+    size_ = static_cast<size_t>(size.QuadPart);
+    if (size_ == 0) {
+        Close();
+        throw std::runtime_error(path + " is empty");
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr) {
+        Close();
+        throw std::runtime_error("Cannot map " + path);
+    }
+    mapping_handle_ = mapping;
+    data_ = static_cast<const unsigned char *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (data_ == nullptr) {
+        Close();
+        throw std::runtime_error("Cannot map " + path);
+    }
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open " + path);
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Cannot stat " + path);
+    }
+    size_ = static_cast<size_t>(st.st_size);
+    if (size_ == 0) {
+        ::close(fd);
+        throw std::runtime_error(path + " is empty");
+    }
+    void *mapping = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        throw std::runtime_error("Cannot map " + path);
+    }
+    data_ = static_cast<const unsigned char *>(mapping);
+#endif
+}
+
+MappedFile::~MappedFile() {
+    Close();
+}
+
+MappedFile::MappedFile(MappedFile &&other) noexcept {
+    *this = std::move(other);
+}
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept {
+    if (this != &other) {
+        Close();
+        std::swap(data_, other.data_);
+        std::swap(size_, other.size_);
+#ifdef _WIN32
+        std::swap(file_handle_, other.file_handle_);
+        std::swap(mapping_handle_, other.mapping_handle_);
+#endif
+    }
+    return *this;
+}
+
+void MappedFile::Close() {
+#ifdef _WIN32
+    if (data_ != nullptr) {
+        UnmapViewOfFile(data_);
+    }
+    if (mapping_handle_ != nullptr) {
+        CloseHandle(mapping_handle_);
+    }
+    if (file_handle_ != nullptr) {
+        CloseHandle(file_handle_);
+    }
+    mapping_handle_ = nullptr;
+    file_handle_ = nullptr;
+#else
+    if (data_ != nullptr) {
+        ::munmap(const_cast<unsigned char *>(data_), size_);
+    }
+#endif
+    data_ = nullptr;
+    size_ = 0;
+}
+
+StrategyTable::StrategyTable(const std::string &path) : file_(path) {
+    const StrategyFileHeader &header = GetHeader();
+    CheckStrategyFileHeader(path, header, file_.GetSize());
+    if (!((header.layout == static_cast<uint32_t>(TableLayout::ShortStateKeyDense) &&
+           header.num_elements == ShortStateKey::NUM_INDICES) ||
+          (header.layout == static_cast<uint32_t>(TableLayout::ShortStateKeyReachable) &&
+           header.num_elements == ReachableIndex::NUM_REACHABLE)) ||
+        header.element_type != static_cast<uint32_t>(ElementType::Float64) ||
+        header.element_size != sizeof(double) || header.data_size != header.num_elements * header.element_size) {
+        throw std::runtime_error(path + " has an unsupported layout");
+    }
+    values_ = reinterpret_cast<const double *>(file_.GetData() + header.data_offset);
+    layout_ = static_cast<TableLayout>(header.layout);
+}
+
+bool StrategyTable::IsOpen() const {
+    return file_.IsOpen();
+}
+
+const StrategyFileHeader &StrategyTable::GetHeader() const {
+    return *reinterpret_cast<const StrategyFileHeader *>(file_.GetData());
+}
+
+bool StrategyTable::VerifyChecksum() const {
+    const StrategyFileHeader &header = GetHeader();
+    return Checksum64(file_.GetData() + header.data_offset, header.data_size) == header.data_checksum;
+}
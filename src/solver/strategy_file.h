@@ -0,0 +1,124 @@
+#pragma once
+
+#include "../game_state/rules.h"
+#include "../game_state/short_state_key.h"
+#include "table_layout.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Binary strategy table file.
+//
+// A fixed header followed, at a page-aligned offset, by the expected score of
+// the rest of the game from the start of a turn for every state. The dense
+// layout has one element per ShortStateKey index, so key.Index() is the
+// offset; the reachable layout leaves out the keys no game can reach and
+// needs about half the space, ReachableIndex translates keys to offsets.
+// All integers are little-endian.
+
+enum class ElementType : uint32_t {
+    Float64 = 1,
+    Fixed16 = 2,    // uint16 fixed point: value / 65535 in duel tables, times the step in quantized ones
+    Float16 = 3,    // IEEE 754 half precision
+    DeltaRice = 4,  // Rice coded differences of fixed point values, see QuantizedTableInfo
+    Policy8 = 5,    // best move codes of a PolicyTable
+};
+
+struct StrategyFileHeader {
+    static constexpr uint64_t MAGIC = 0x31424154545A4859ull;  // "YHZTTAB1"
+    // 2: score moves of a joker earn the yahtzee bonus, version 1 values lack it
+    static constexpr uint32_t VERSION = 2;
+
+    uint64_t magic;
+    uint32_t version;
+    uint32_t header_size;
+    uint32_t rule_variant;
+    uint32_t layout;
+    uint32_t element_type;
+    uint32_t element_size;
+    uint64_t num_elements;
+    uint64_t data_offset;
+    uint64_t data_size;
+    uint64_t data_checksum;     // Checksum64 of the data section
+    uint64_t header_checksum;   // Checksum64 of the header with this field zeroed
+};
+
+static_assert(sizeof(StrategyFileHeader) == 72, "Header layout must not change");
+
+// 64-bit checksum of a byte range (word-wise multiply-xorshift mix)
+uint64_t Checksum64(const void *data, size_t size);
+
+// Writes a dense table of NUM_INDICES values in the given layout and element
+// type, the quantized types with the default step and the corrections of
+// their decisions, if any (see QuantizedTable); throws std::runtime_error on
+// IO errors
+void WriteStrategyFile(const std::string &path, const double *values, size_t num_values,
+                       RuleVariant rule_variant = RuleVariant::Yahtzee,
+                       TableLayout layout = TableLayout::ShortStateKeyDense,
+                       ElementType element_type = ElementType::Float64,
+                       const std::vector<uint64_t> &corrections = {});
+
+// Writes the header page and the data section of any table of the family.
+// Fills in magic, version, offsets, sizes and checksums of the header, the
+// caller sets rule variant, layout, element type and count. Writes to a
+// temporary file renamed over path, so a crash never leaves a torn table.
+void WriteStrategyFileData(const std::string &path, StrategyFileHeader header, const void *data, size_t size);
+
+// Checks what every table of the family shares: magic, version, header
+// checksum and that the data section lies inside a file of file_size bytes.
+// Throws std::runtime_error naming the path.
+void CheckStrategyFileHeader(const std::string &path, const StrategyFileHeader &header, size_t file_size);
+
+// Read-only memory mapping of a whole file
+class MappedFile {
+public:
+    MappedFile() = default;
+    explicit MappedFile(const std::string &path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+    MappedFile(MappedFile &&other) noexcept;
+    MappedFile &operator=(MappedFile &&other) noexcept;
+
+    bool IsOpen() const { return data_ != nullptr; }
+    const unsigned char *GetData() const { return data_; }
+    size_t GetSize() const { return size_; }
+
+private:
+    void Close();
+
+    const unsigned char *data_{nullptr};
+    size_t size_{0};
+#ifdef _WIN32
+    void *file_handle_{nullptr};
+    void *mapping_handle_{nullptr};
+#endif
+};
+
+// Read-only memory mapping of a strategy file. Opening only reads and checks
+// the header, pages of the table are faulted in on first access.
+class StrategyTable {
+public:
+    StrategyTable() = default;
+    explicit StrategyTable(const std::string &path);
+
+    bool IsOpen() const;
+    const StrategyFileHeader &GetHeader() const;
+
+    // Reads the whole data section, so it is not done on open
+    bool VerifyChecksum() const;
+
+    double GetStateValue(ShortStateKey key) const { return values_[ReachableIndex::Offset(key, layout_)]; }
+
+    // Values in the order of GetLayout()
+    const double *GetValues() const { return values_; }
+    TableLayout GetLayout() const { return layout_; }
+
+private:
+    MappedFile file_;
+    const double *values_{nullptr};
+    TableLayout layout_{TableLayout::ShortStateKeyDense};
+};
@@ -0,0 +1,203 @@
+#pragma once
+
+#include "../game_state/category.h"
+#include "../game_state/dice_index.h"
+#include "../game_state/rules.h"
+#include "../game_state/short_state_key.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+// Order of the values of a turn-start table, in memory and in strategy files
+enum class TableLayout : uint32_t {
+    ShortStateKeyDense = 1,      // element i belongs to ShortStateKey::FromIndex(i)
+    ShortStateKeyReachable = 2,  // only reachable keys, in index order, see ReachableIndex
+    DuelPairRows = 3,            // rows per pair of states of two players, see DuelTable
+};
+
+// Reachability of the upper remainder of a ShortStateKey.
+//
+// The upper total is a sum of face * count over the filled upper categories,
+// so most remainders cannot occur with few of them filled: with only Ones
+// filled the remainder is 58 to 63. UPPER_REMAINDERS[m] has bit r set when
+// remainder r can occur once exactly the upper categories of m (bit i is face
+// i + 1) are filled. The yahtzee flag can only be set once the yahtzee box is
+// used. About half of the 2^20 key values are reachable.
+//
+// UPPER_REMAINDER_SETS holds the same sets for any dice shape and threshold
+// below 128, bit r in word r / 64; IsReachable<Rules> uses them for the keys
+// of every rule set.
+namespace table_layout_detail {
+
+constexpr size_t NUM_UPPER_MASKS = size_t{1} << NUM_UPPER_CATEGORIES;
+constexpr size_t NUM_MASKS = size_t{1} << NUM_CATEGORIES;
+constexpr uint32_t YAHTZEE_BIT = uint32_t{1} << static_cast<uint32_t>(Category::Yahtzee);
+
+template<typename Shape>
+using RemainderSets = std::array<std::array<uint64_t, 2>, size_t{1} << Shape::NUM_FACES>;
+
+// One upper category per face
+template<typename Shape, size_t UpperThreshold>
+constexpr RemainderSets<Shape> BuildUpperRemainderSets() {
+    static_assert(UpperThreshold < 128, "Remainders must fit two words");
+    RemainderSets<Shape> sets{};
+    for (size_t mask = 0; mask < sets.size(); ++mask) {
+        // An upper total of t (capped at the threshold) is possible
+        std::array<bool, UpperThreshold + 1> totals{};
+        totals[0] = true;
+        for (size_t face = 1; face <= Shape::NUM_FACES; ++face) {
+            if (!((mask >> (face - 1)) & 1u)) {
+                continue;
+            }
+            std::array<bool, UpperThreshold + 1> next{};
+            for (size_t total = 0; total <= UpperThreshold; ++total) {
+                if (totals[total]) {
+                    for (size_t count = 0; count <= Shape::NUM_DICE; ++count) {
+                        const size_t sum = total + face * count;
+                        next[sum < UpperThreshold ? sum : UpperThreshold] = true;
+                    }
+                }
+            }
+            totals = next;
+        }
+        for (size_t total = 0; total <= UpperThreshold; ++total) {
+            if (totals[total]) {
+                const size_t remainder = UpperThreshold - total;
+                sets[mask][remainder / 64] |= uint64_t{1} << (remainder % 64);
+            }
+        }
+    }
+    return sets;
+}
+
+template<typename Shape, size_t UpperThreshold>
+inline constexpr RemainderSets<Shape> UPPER_REMAINDER_SETS = BuildUpperRemainderSets<Shape, UpperThreshold>();
+
+// Every remainder of the Yahtzee threshold fits the first word
+constexpr std::array<uint64_t, NUM_UPPER_MASKS> BuildUpperRemainders() {
+    std::array<uint64_t, NUM_UPPER_MASKS> remainders{};
+    for (size_t mask = 0; mask < NUM_UPPER_MASKS; ++mask) {
+        remainders[mask] = UPPER_REMAINDER_SETS<FiveDice, UPPER_BONUS_THRESHOLD>[mask][0];
+    }
+    return remainders;
+}
+
+constexpr size_t PopCount(uint64_t bits) {
+    bits = bits - ((bits >> 1) & 0x5555555555555555ull);
+    bits = (bits & 0x3333333333333333ull) + ((bits >> 2) & 0x3333333333333333ull);
+    bits = (bits + (bits >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+    return static_cast<size_t>((bits * 0x0101010101010101ull) >> 56);
+}
+
+// The low 7 bits of a key: (remainder << 1) | yahtzee, as a 128-bit set per
+// (upper mask, yahtzee box used)
+using KeyBlock = std::array<uint64_t, 2>;
+using KeyBlocks = std::array<std::array<KeyBlock, 2>, NUM_UPPER_MASKS>;
+
+constexpr KeyBlocks BuildKeyBlocks(const std::array<uint64_t, NUM_UPPER_MASKS> &remainders) {
+    KeyBlocks blocks{};
+    for (size_t mask = 0; mask < NUM_UPPER_MASKS; ++mask) {
+        for (size_t yahtzee_used = 0; yahtzee_used < 2; ++yahtzee_used) {
+            for (size_t remainder = 0; remainder <= UPPER_BONUS_THRESHOLD; ++remainder) {
+                if (!((remainders[mask] >> remainder) & 1u)) {
+                    continue;
+                }
+                for (size_t flag = 0; flag <= yahtzee_used; ++flag) {
+                    const size_t low = (remainder << 1) | flag;
+                    blocks[mask][yahtzee_used][low / 64] |= uint64_t{1} << (low % 64);
+                }
+            }
+        }
+    }
+    return blocks;
+}
+
+inline constexpr std::array<uint64_t, NUM_UPPER_MASKS> UPPER_REMAINDERS = BuildUpperRemainders();
+inline constexpr KeyBlocks KEY_BLOCKS = BuildKeyBlocks(UPPER_REMAINDERS);
+
+constexpr const KeyBlock &GetKeyBlock(uint32_t mask) {
+    return KEY_BLOCKS[mask & (NUM_UPPER_MASKS - 1)][(mask & YAHTZEE_BIT) ? 1 : 0];
+}
+
+constexpr std::array<uint32_t, NUM_MASKS + 1> BuildMaskOffsets() {
+    std::array<uint32_t, NUM_MASKS + 1> offsets{};
+    for (size_t mask = 0; mask < NUM_MASKS; ++mask) {
+        const KeyBlock &block = GetKeyBlock(static_cast<uint32_t>(mask));
+        offsets[mask + 1] = static_cast<uint32_t>(offsets[mask] + PopCount(block[0]) + PopCount(block[1]));
+    }
+    return offsets;
+}
+
+inline constexpr std::array<uint32_t, NUM_MASKS + 1> MASK_OFFSETS = BuildMaskOffsets();
+
+}  // namespace table_layout_detail
+
+using table_layout_detail::UPPER_REMAINDERS;
+
+// Keys of every rule set with six upper categories, five dice and an upper
+// threshold of 63; the yahtzee box is bit Category::Yahtzee in keys with a flag
+template<size_t NumCategories, bool HasYahtzeeFlag>
+constexpr bool IsReachable(BasicStateKey<NumCategories, UPPER_BONUS_THRESHOLD, HasYahtzeeFlag> key) {
+    using namespace table_layout_detail;
+    const uint32_t mask = key.UsedMask();
+    if (key.IsYahtzeeRecorded() && !(mask & YAHTZEE_BIT)) {
+        return false;
+    }
+    return (UPPER_REMAINDERS[mask & (NUM_UPPER_MASKS - 1)] >> key.RemainingUpperBonus()) & 1u;
+}
+
+// Keys of any rule set (see rules.h), from the remainders its dice can leave
+template<typename Rules>
+constexpr bool IsReachable(typename Rules::StateKey key) {
+    using Shape = typename Rules::Shape;
+    static_assert(Rules::NUM_UPPER_CATEGORIES == Shape::NUM_FACES, "One upper category per face");
+    if constexpr (Rules::HAS_JOKER) {
+        if (key.IsYahtzeeRecorded() && !key.IsCategoryUsed(Rules::YAHTZEE_CATEGORY)) {
+            return false;
+        }
+    }
+    const auto &sets = table_layout_detail::UPPER_REMAINDER_SETS<Shape, Rules::UPPER_BONUS_THRESHOLD>;
+    const uint32_t remainder = key.RemainingUpperBonus();
+    return (sets[key.UsedMask() & (sets.size() - 1)][remainder / 64] >> (remainder % 64)) & 1u;
+}
+
+// Dense numbering of the reachable keys in key order: the position of a key
+// is the number of reachable keys of all smaller masks (a table of 8192
+// offsets) plus a population count of the reachable low bits below it in its
+// own mask.
+class ReachableIndex {
+public:
+    static constexpr size_t NUM_REACHABLE = table_layout_detail::MASK_OFFSETS[table_layout_detail::NUM_MASKS];
+
+    static constexpr size_t Index(ShortStateKey key) {
+        using namespace table_layout_detail;
+        const KeyBlock &block = GetKeyBlock(key.UsedMask());
+        const size_t low = key.Value() & 127u;
+        const size_t below = low < 64 ? PopCount(block[0] & ((uint64_t{1} << low) - 1))
+                                      : PopCount(block[0]) + PopCount(block[1] & ((uint64_t{1} << (low - 64)) - 1));
+        return MASK_OFFSETS[key.UsedMask()] + below;
+    }
+
+    // Position of the key in a table of the given layout
+    static constexpr size_t Offset(ShortStateKey key, TableLayout layout) {
+        return layout == TableLayout::ShortStateKeyReachable ? Index(key) : key.Index();
+    }
+};
+
+// Position of a key of any rule set in a table of the given layout; keys
+// other than ShortStateKey only have the dense layout
+template<typename StateKey>
+constexpr size_t GetLayoutOffset(StateKey key, TableLayout layout) {
+    if constexpr (std::is_same_v<StateKey, ShortStateKey>) {
+        return ReachableIndex::Offset(key, layout);
+    } else {
+        return key.Index();
+    }
+}
+
+static_assert(ReachableIndex::NUM_REACHABLE == 536448, "Reachable key count changed");
+static_assert(IsReachable(ShortStateKey()), "The start of the game is reachable");
+static_assert(IsReachable<MaxiYatzyNoSavedRerollsRules>(MaxiYatzyNoSavedRerollsRules::StateKey()),
+              "The start of the game is reachable");
@@ -0,0 +1,192 @@
+#include "task_scheduler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+namespace {
+
+uint64_t PackRange(uint64_t begin, uint64_t end) {
+    return end << 32 | begin;
+}
+
+size_t RangeBegin(uint64_t range) {
+    return static_cast<size_t>(range & 0xFFFFFFFFu);
+}
+
+size_t RangeEnd(uint64_t range) {
+    return static_cast<size_t>(range >> 32);
+}
+
+double SecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+}  // namespace
+
+double ParallelForStats::Imbalance() const {
+    if (busy_seconds.empty()) {
+        return 1.0;
+    }
+    double total = std::accumulate(busy_seconds.begin(), busy_seconds.end(), 0.0);
+    double busiest = *std::max_element(busy_seconds.begin(), busy_seconds.end());
+    if (total <= 0.0) {
+        return 1.0;
+    }
+    return busiest * static_cast<double>(busy_seconds.size()) / total;
+}
+
+TaskScheduler::TaskScheduler(size_t num_threads) : num_threads_(num_threads) {
+    if (num_threads_ == 0) {
+        num_threads_ = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+    queues_ = std::make_unique<WorkerQueue[]>(num_threads_);
+    for (size_t worker = 1; worker < num_threads_; ++worker) {
+        threads_.emplace_back(&TaskScheduler::WorkerLoop, this, worker);
+    }
+}
+
+TaskScheduler::~TaskScheduler() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    start_cv_.notify_all();
+    for (auto &thread : threads_) {
+        thread.join();
+    }
+}
+
+ParallelForStats TaskScheduler::ParallelFor(size_t num_items, size_t chunk_size, const Task &task) {
+    if (chunk_size == 0) {
+        throw std::invalid_argument("Chunk size must be positive");
+    }
+    const size_t num_chunks = (num_items + chunk_size - 1) / chunk_size;
+    if (num_chunks > std::numeric_limits<uint32_t>::max()) {
+        throw std::invalid_argument("Too many chunks");
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    stats_ = ParallelForStats{};
+    stats_.busy_seconds.assign(num_threads_, 0.0);
+    stats_.chunks.assign(num_threads_, 0);
+    steals_.assign(num_threads_, 0);
+    task_ = &task;
+    num_items_ = num_items;
+    chunk_size_ = chunk_size;
+    failed_ = false;
+    error_ = nullptr;
+    remaining_chunks_ = num_chunks;
+
+    // Contiguous initial ranges keep neighbouring items on one worker
+    for (size_t worker = 0; worker < num_threads_; ++worker) {
+        queues_[worker].range = PackRange(num_chunks * worker / num_threads_, num_chunks * (worker + 1) / num_threads_);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++generation_;
+        running_workers_ = threads_.size();
+    }
+    start_cv_.notify_all();
+
+    RunChunks(0);
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_cv_.wait(lock, [this] { return running_workers_ == 0; });
+    }
+
+    task_ = nullptr;
+    stats_.steals = std::accumulate(steals_.begin(), steals_.end(), size_t{0});
+    stats_.seconds = SecondsSince(start);
+    if (error_) {
+        std::rethrow_exception(error_);
+    }
+    return stats_;
+}
+
+void TaskScheduler::WorkerLoop(size_t worker) {
+    uint64_t seen_generation = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            start_cv_.wait(lock, [&] { return stopping_ || generation_ != seen_generation; });
+            if (stopping_) {
+                return;
+            }
+            seen_generation = generation_;
+        }
+        RunChunks(worker);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            --running_workers_;
+        }
+        done_cv_.notify_one();
+    }
+}
+
+void TaskScheduler::RunChunks(size_t worker) {
+    while (remaining_chunks_.load(std::memory_order_acquire) > 0) {
+        size_t chunk;
+        if (!TakeChunk(worker, chunk) && !StealChunk(worker, chunk)) {
+            // The last chunks are running elsewhere
+            std::this_thread::yield();
+            continue;
+        }
+        if (!failed_.load(std::memory_order_relaxed)) {
+            const size_t begin = chunk * chunk_size_;
+            const size_t end = std::min(begin + chunk_size_, num_items_);
+            auto start = std::chrono::steady_clock::now();
+            try {
+                (*task_)(begin, end, worker);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (!error_) {
+                    error_ = std::current_exception();
+                }
+                failed_ = true;
+            }
+            stats_.busy_seconds[worker] += SecondsSince(start);
+            ++stats_.chunks[worker];
+        }
+        remaining_chunks_.fetch_sub(1, std::memory_order_release);
+    }
+}
+
+bool TaskScheduler::TakeChunk(size_t worker, size_t &chunk) {
+    std::atomic<uint64_t> &range = queues_[worker].range;
+    uint64_t current = range.load(std::memory_order_acquire);
+    while (RangeBegin(current) < RangeEnd(current)) {
+        if (range.compare_exchange_weak(current, PackRange(RangeBegin(current) + 1, RangeEnd(current)),
+                                        std::memory_order_acq_rel)) {
+            chunk = RangeBegin(current);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Takes the back half of the first non-empty range after the worker's own,
+// runs its first chunk now and keeps the rest as the new own range. Chunks
+// are never returned to a range, so a range word never repeats a value and
+// the compare-and-swap cannot mistake a refilled range for an old one.
+bool TaskScheduler::StealChunk(size_t worker, size_t &chunk) {
+    for (size_t offset = 1; offset < num_threads_; ++offset) {
+        std::atomic<uint64_t> &range = queues_[(worker + offset) % num_threads_].range;
+        uint64_t current = range.load(std::memory_order_acquire);
+        while (RangeBegin(current) < RangeEnd(current)) {
+            const size_t begin = RangeBegin(current);
+            const size_t end = RangeEnd(current);
+            const size_t stolen = (end - begin + 1) / 2;
+            if (range.compare_exchange_weak(current, PackRange(begin, end - stolen), std::memory_order_acq_rel)) {
+                chunk = end - stolen;
+                queues_[worker].range.store(PackRange(chunk + 1, end), std::memory_order_release);
+                ++steals_[worker];
+                return true;
+            }
+        }
+    }
+    return false;
+}
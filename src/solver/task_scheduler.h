@@ -0,0 +1,84 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Timing of one ParallelFor call
+struct ParallelForStats {
+    double seconds{0.0};               // wall time, start to barrier
+    std::vector<double> busy_seconds;  // per worker, time spent inside the task
+    std::vector<size_t> chunks;        // per worker, chunks executed
+    size_t steals{0};                  // successful steals over all workers
+
+    // Busiest worker over the mean of all workers, 1 when perfectly even
+    double Imbalance() const;
+};
+
+// Persistent pool of workers that runs chunked loops with work stealing.
+//
+// ParallelFor splits the items into chunks and hands every worker a
+// contiguous range of them. A worker takes chunks from the front of its own
+// range; when it runs dry it steals the back half of another worker's range.
+// Ranges live in one atomic word per worker, so taking and stealing are a
+// single compare-and-swap. The calling thread is worker 0 and ParallelFor
+// returns only after every chunk has run, so consecutive calls are separated
+// by a barrier.
+class TaskScheduler {
+public:
+    // Runs task(begin, end, worker) for the items [begin, end) of a chunk
+    using Task = std::function<void(size_t begin, size_t end, size_t worker)>;
+
+    // num_threads == 0 uses all hardware threads
+    explicit TaskScheduler(size_t num_threads = 0);
+    ~TaskScheduler();
+
+    TaskScheduler(const TaskScheduler &) = delete;
+    TaskScheduler &operator=(const TaskScheduler &) = delete;
+
+    size_t GetNumThreads() const { return num_threads_; }
+
+    // Runs the task over [0, num_items) in chunks of chunk_size items.
+    // The first exception thrown by the task is rethrown after the barrier,
+    // the remaining chunks are skipped.
+    ParallelForStats ParallelFor(size_t num_items, size_t chunk_size, const Task &task);
+
+private:
+    // Chunk range [begin, end) packed as end << 32 | begin
+    struct alignas(64) WorkerQueue {
+        std::atomic<uint64_t> range{0};
+    };
+
+    void WorkerLoop(size_t worker);
+    void RunChunks(size_t worker);
+    bool TakeChunk(size_t worker, size_t &chunk);
+    bool StealChunk(size_t worker, size_t &chunk);
+
+    size_t num_threads_;
+    std::vector<std::thread> threads_;
+    std::unique_ptr<WorkerQueue[]> queues_;
+
+    std::mutex mutex_;
+    std::condition_variable start_cv_;
+    std::condition_variable done_cv_;
+    uint64_t generation_{0};
+    size_t running_workers_{0};
+    bool stopping_{false};
+
+    // State of the current ParallelFor
+    const Task *task_{nullptr};
+    size_t num_items_{0};
+    size_t chunk_size_{1};
+    std::atomic<size_t> remaining_chunks_{0};
+    std::atomic<bool> failed_{false};
+    std::exception_ptr error_;
+    ParallelForStats stats_;
+    std::vector<size_t> steals_;  // per worker, summed into stats_ after the barrier
+};
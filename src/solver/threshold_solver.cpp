@@ -0,0 +1,237 @@
+#include "threshold_solver.h"
+#include "row_kernels.h"
+#include "turn_evaluator.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+
+namespace {
+
+constexpr uint32_t SumPoints(size_t begin, size_t end) {
+    uint32_t sum = 0;
+    for (size_t category = begin; category < end; ++category) {
+        sum += MAX_CATEGORY_POINTS[category];
+    }
+    return sum;
+}
+
+static_assert(SumPoints(0, NUM_CATEGORIES) + UPPER_BONUS + (NUM_CATEGORIES - 1) * YAHTZEE_BONUS ==
+                  ThresholdSolver::MAX_REMAINING_SCORE,
+              "MAX_REMAINING_SCORE must match the score tables");
+
+constexpr size_t MAX_STRIDE = (ThresholdSolver::MAX_REMAINING_SCORE + ROW_ALIGNMENT) / ROW_ALIGNMENT * ROW_ALIGNMENT;
+
+// Next-state rows are cached per (category, variant): the count of the face
+// for upper categories, whether a yahtzee gets recorded for the rest
+constexpr size_t SLOT_VARIANTS = NUM_DICE + 1;
+constexpr size_t NUM_SLOTS = NUM_CATEGORIES * SLOT_VARIANTS;
+constexpr size_t SLOT_SIZE = MAX_MOVE_POINTS + MAX_STRIDE;
+
+// Thresholds of the state that can still be reached, the length of its row
+size_t RowLength(ShortStateKey key) {
+    return GetMaxRemainingScore(key) + 1;
+}
+
+// Rows of one turn of a state, given the rows of the layers below
+class ThresholdTurnEvaluator {
+public:
+    explicit ThresholdTurnEvaluator(const ThresholdSolver &solver)
+        : solver_(solver), kernels_(GetRowKernels()), slots_(NUM_SLOTS * SLOT_SIZE),
+          score_rows_(NUM_ROLLS * MAX_STRIDE), roll_rows_(NUM_ROLLS * MAX_STRIDE),
+          reroll_rows_(NUM_ROLLS * MAX_STRIDE), keep_rows_(NUM_PARTIAL_KEEPS * MAX_STRIDE),
+          result_(MAX_STRIDE) {}
+
+    // Row of the state for the thresholds [0, RowLength(key))
+    const float *Evaluate(ShortStateKey key) {
+        const size_t length = RowLength(key);
+        if (key.IsGameOver()) {
+            result_[0] = 1.0f;
+            return result_.data();
+        }
+        const size_t stride = (length + ROW_ALIGNMENT - 1) / ROW_ALIGNMENT * ROW_ALIGNMENT;
+
+        PrepareScoreMoves(key, length);
+        kernels_.score_rows(sources_.data(), source_offsets_.data(), score_rows_.data(), length, stride);
+
+        // Levels with one and two rerolls left
+        kernels_.reduce_keeps(score_rows_.data(), keep_rows_.data(), length, stride);
+        kernels_.max_rolls(score_rows_.data(), keep_rows_.data(), score_rows_.data(), roll_rows_.data(), length,
+                           stride);
+        kernels_.reduce_keeps(roll_rows_.data(), keep_rows_.data(), length, stride);
+        kernels_.max_rolls(score_rows_.data(), keep_rows_.data(), roll_rows_.data(), reroll_rows_.data(), length,
+                           stride);
+
+        kernels_.turn_start(reroll_rows_.data(), result_.data(), length, stride);
+        return result_.data();
+    }
+
+private:
+    // Collects the shifted next-state row of every allowed score move. A row
+    // read at t - points falls into the padding of ones when t < points.
+    void PrepareScoreMoves(ShortStateKey key, size_t length) {
+        slot_decoded_.fill(false);
+        sources_.clear();
+        for (size_t roll = 0; roll < NUM_ROLLS; ++roll) {
+            source_offsets_[roll] = static_cast<uint16_t>(sources_.size());
+            const uint32_t allowed = GetAllowedCategoryMask(key, static_cast<RollIndex>(roll));
+            for (size_t category = 0; category < NUM_CATEGORIES; ++category) {
+                if (!(allowed & (uint32_t{1} << category))) {
+                    continue;
+                }
+                ScoreOutcome outcome = GetScoreOutcome(key, static_cast<RollIndex>(roll), static_cast<Category>(category));
+                const size_t variant = category < NUM_UPPER_CATEGORIES
+                                           ? ROLL_TABLE.counts[roll][category]
+                                           : outcome.next.IsYahtzeeRecorded() != key.IsYahtzeeRecorded();
+                const size_t slot = category * SLOT_VARIANTS + variant;
+                float *row = slots_.data() + slot * SLOT_SIZE + MAX_MOVE_POINTS;
+                if (!slot_decoded_[slot]) {
+                    std::fill(row - MAX_MOVE_POINTS, row, 1.0f);
+                    solver_.DecodeRow(outcome.next, row, length);
+                    slot_decoded_[slot] = true;
+                }
+                sources_.push_back(row - outcome.points);
+            }
+        }
+        source_offsets_[NUM_ROLLS] = static_cast<uint16_t>(sources_.size());
+    }
+
+    const ThresholdSolver &solver_;
+    const RowKernels &kernels_;
+    std::vector<float> slots_;
+    std::array<bool, NUM_SLOTS> slot_decoded_{};
+    std::vector<const float *> sources_;
+    std::array<uint16_t, NUM_ROLLS + 1> source_offsets_{};
+    std::vector<float> score_rows_;
+    std::vector<float> roll_rows_;
+    std::vector<float> reroll_rows_;
+    std::vector<float> keep_rows_;
+    std::vector<float> result_;
+};
+
+}  // namespace
+
+ThresholdSolver::ThresholdSolver() : rows_(ShortStateKey::NUM_INDICES) {}
+
+void ThresholdSolver::Solve(size_t num_threads) {
+    TaskScheduler scheduler(num_threads);
+    layer_stats_.clear();
+    data_.clear();
+    for (size_t filled = NUM_CATEGORIES + 1; filled-- > 0;) {
+        SolveLayer(filled, scheduler);
+    }
+}
+
+void ThresholdSolver::SolveLayer(size_t filled_count, size_t num_threads) {
+    TaskScheduler scheduler(num_threads);
+    SolveLayer(filled_count, scheduler);
+}
+
+void ThresholdSolver::SolveLayer(size_t filled_count, TaskScheduler &scheduler) {
+    const std::vector<ShortStateKey> states = GetLayerStates(filled_count);
+    const size_t num_workers = scheduler.GetNumThreads();
+
+    // Workers append quantized rows to their own buffers, merged after the barrier
+    std::vector<std::unique_ptr<ThresholdTurnEvaluator>> evaluators;
+    for (size_t worker = 0; worker < num_workers; ++worker) {
+        evaluators.push_back(std::make_unique<ThresholdTurnEvaluator>(*this));
+    }
+    std::vector<std::vector<uint16_t>> worker_data(num_workers);
+    std::vector<uint16_t> state_workers(states.size());
+
+    ParallelForStats stats = scheduler.ParallelFor(states.size(), CHUNK_STATES,
+                                                   [&](size_t begin, size_t end, size_t worker) {
+        std::vector<uint16_t> &data = worker_data[worker];
+        for (size_t state = begin; state < end; ++state) {
+            const ShortStateKey key = states[state];
+            const size_t length = RowLength(key);
+            const float *row = evaluators[worker]->Evaluate(key);
+
+            RowEntry entry;
+            size_t first = 0;
+            auto quantize = [&](size_t t) {
+                float clamped = std::min(std::max(row[t], 0.0f), 1.0f);
+                return static_cast<uint16_t>(std::lround(clamped * static_cast<float>(QUANTUM)));
+            };
+            while (first < length && quantize(first) == QUANTUM) {
+                ++first;
+            }
+            size_t last = length;
+            while (last > first && quantize(last - 1) == 0) {
+                --last;
+            }
+            entry.offset = static_cast<uint32_t>(data.size());
+            entry.first = static_cast<uint16_t>(first);
+            entry.size = static_cast<uint16_t>(last - first);
+            for (size_t t = first; t < last; ++t) {
+                data.push_back(quantize(t));
+            }
+            rows_[key.Index()] = entry;
+            state_workers[state] = static_cast<uint16_t>(worker);
+        }
+    });
+
+    std::vector<size_t> worker_base(num_workers);
+    for (size_t worker = 0; worker < num_workers; ++worker) {
+        worker_base[worker] = data_.size();
+        data_.insert(data_.end(), worker_data[worker].begin(), worker_data[worker].end());
+    }
+    if (data_.size() > UINT32_MAX) {
+        throw std::runtime_error("Threshold table exceeds 32-bit offsets");
+    }
+    for (size_t state = 0; state < states.size(); ++state) {
+        rows_[states[state].Index()].offset += static_cast<uint32_t>(worker_base[state_workers[state]]);
+    }
+
+    LayerStats layer;
+    layer.filled_count = filled_count;
+    layer.num_states = states.size();
+    layer.num_threads = num_workers;
+    layer.seconds = stats.seconds;
+    layer.imbalance = stats.Imbalance();
+    layer.steals = stats.steals;
+    layer_stats_.push_back(layer);
+}
+
+double ThresholdSolver::GetProbability(ShortStateKey key, size_t points) const {
+    const RowEntry &entry = rows_[key.Index()];
+    if (points < entry.first) {
+        return 1.0;
+    }
+    if (points >= size_t{entry.first} + entry.size) {
+        return 0.0;
+    }
+    return static_cast<double>(data_[entry.offset + points - entry.first]) / QUANTUM;
+}
+
+std::vector<double> ThresholdSolver::GetProbabilities(ShortStateKey key, const std::vector<size_t> &thresholds) const {
+    std::vector<double> probabilities;
+    probabilities.reserve(thresholds.size());
+    for (size_t points : thresholds) {
+        probabilities.push_back(GetProbability(key, points));
+    }
+    return probabilities;
+}
+
+void ThresholdSolver::DecodeRow(ShortStateKey key, float *out, size_t length) const {
+    const RowEntry &entry = rows_[key.Index()];
+    const size_t first = std::min<size_t>(entry.first, length);
+    const size_t last = std::min<size_t>(size_t{entry.first} + entry.size, length);
+    const uint16_t *data = data_.data() + entry.offset;
+    constexpr float scale = 1.0f / static_cast<float>(QUANTUM);
+    std::fill(out, out + first, 1.0f);
+    for (size_t t = first; t < last; ++t) {
+        out[t] = static_cast<float>(data[t - entry.first]) * scale;
+    }
+    std::fill(out + last, out + length, 0.0f);
+}
+
+size_t ThresholdSolver::GetStorageBytes() const {
+    return rows_.size() * sizeof(RowEntry) + data_.size() * sizeof(uint16_t);
+}
+
+const std::vector<LayerStats> &ThresholdSolver::GetLayerStats() const {
+    return layer_stats_;
+}
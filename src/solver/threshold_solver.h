@@ -0,0 +1,72 @@
+#pragma once
+
+#include "../game_state/short_state_key.h"
+#include "solver.h"
+#include "task_scheduler.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Retrograde solver for the chance of reaching a target score.
+//
+// For every ShortGameState at the start of a turn and every number of points
+// t it stores the highest probability, over all strategies, of scoring at
+// least t more points in the rest of the game. The best strategy depends on
+// t, so every t is an independent maximisation; the solver runs them side by
+// side as rows over t, which makes the inner loops contiguous and
+// vectorizable. A player with s points so far beats a target T with
+// probability GetProbability(key, T - s).
+//
+// Rows are stored compressed: the leading run of certain thresholds and the
+// trailing run of impossible ones are cut off and the rest is quantized to
+// 16-bit fixed point, so a value is exact to 1 / 131070 per layer below it.
+class ThresholdSolver {
+public:
+    // Most points the rest of a game can score, a yahtzee bonus in every turn
+    // after the first included; the longest row is one more
+    static constexpr size_t MAX_REMAINING_SCORE = 1575;
+    static constexpr uint32_t QUANTUM = 65535;
+
+    ThresholdSolver();
+    ~ThresholdSolver() = default;
+
+    // Solve every layer; num_threads == 0 uses all hardware threads
+    void Solve(size_t num_threads = 0);
+
+    // Solve the states with exactly filled_count used categories.
+    // All layers with more used categories must already be solved.
+    void SolveLayer(size_t filled_count, size_t num_threads = 0);
+
+    // Highest probability of scoring at least `points` more from the start of a turn
+    double GetProbability(ShortStateKey key, size_t points) const;
+
+    // GetProbability for every threshold in order
+    std::vector<double> GetProbabilities(ShortStateKey key, const std::vector<size_t> &thresholds) const;
+
+    // Probabilities for the thresholds [0, length) into out
+    void DecodeRow(ShortStateKey key, float *out, size_t length) const;
+
+    // Bytes held by the compressed rows and their index
+    size_t GetStorageBytes() const;
+
+    // Layers in the order solved; Solve starts a new list
+    const std::vector<LayerStats> &GetLayerStats() const;
+
+private:
+    // Row of a state: quantized values for thresholds [first, first + size),
+    // below first the probability is 1, from first + size on it is 0
+    struct RowEntry {
+        uint32_t offset{0};
+        uint16_t first{0};
+        uint16_t size{0};
+    };
+
+    static constexpr size_t CHUNK_STATES = 4;
+
+    void SolveLayer(size_t filled_count, TaskScheduler &scheduler);
+
+    std::vector<RowEntry> rows_;
+    std::vector<uint16_t> data_;
+    std::vector<LayerStats> layer_stats_;
+};
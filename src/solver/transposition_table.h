@@ -0,0 +1,75 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+
+// Fixed-size lock-free cache of search values keyed by 64-bit packed keys.
+//
+// Every slot holds two atomic words, the value bits and the key xor the
+// value bits. A reader accepts a slot only when the two words agree with its
+// key, so a slot torn by concurrent writers reads as a miss instead of a
+// wrong value. Writers always replace the slot. Key 0 marks an empty slot
+// and must not be used.
+class TranspositionTable {
+public:
+    // 2^log2_slots slots of 16 bytes
+    explicit TranspositionTable(size_t log2_slots)
+        : mask_((uint64_t{1} << CheckSize(log2_slots)) - 1), slots_(new Slot[size_t{1} << log2_slots]) {}
+
+    bool Probe(uint64_t key, double &value) const {
+        const Slot &slot = slots_[Index(key)];
+        const uint64_t data = slot.data.load(std::memory_order_relaxed);
+        const uint64_t check = slot.check.load(std::memory_order_relaxed);
+        if ((check ^ data) != key) {
+            return false;
+        }
+        std::memcpy(&value, &data, sizeof(value));
+        return true;
+    }
+
+    void Store(uint64_t key, double value) {
+        uint64_t data;
+        std::memcpy(&data, &value, sizeof(data));
+        Slot &slot = slots_[Index(key)];
+        slot.check.store(key ^ data, std::memory_order_relaxed);
+        slot.data.store(data, std::memory_order_relaxed);
+    }
+
+    // Not safe while other threads probe or store
+    void Clear() {
+        for (size_t i = 0; i <= mask_; ++i) {
+            slots_[i].check.store(0, std::memory_order_relaxed);
+            slots_[i].data.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    size_t GetNumSlots() const { return static_cast<size_t>(mask_) + 1; }
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> check{0};
+        std::atomic<uint64_t> data{0};
+    };
+
+    static size_t CheckSize(size_t log2_slots) {
+        if (log2_slots == 0 || log2_slots > 40) {
+            throw std::invalid_argument("Transposition table size out of range");
+        }
+        return log2_slots;
+    }
+
+    // Packed keys have structure in their low bits, so the slot comes from a mixed key
+    size_t Index(uint64_t key) const {
+        key ^= key >> 33;
+        key *= 0xFF51AFD7ED558CCDull;
+        key ^= key >> 33;
+        return static_cast<size_t>(key & mask_);
+    }
+
+    uint64_t mask_;
+    std::unique_ptr<Slot[]> slots_;
+};
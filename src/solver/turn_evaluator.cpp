@@ -0,0 +1,179 @@
+#include "turn_evaluator.h"
+#include "../metrics/metrics.h"
+#include "../move/score_table.h"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+
+template<typename Rules>
+BasicScoreOutcome<typename Rules::StateKey> GetScoreOutcome(typename Rules::StateKey key, RuleRollIndex<Rules> roll,
+                                                            typename Rules::CategoryType category) {
+    const uint32_t remaining_upper = key.RemainingUpperBonus();
+    const size_t index = static_cast<size_t>(category);
+
+    uint32_t points = RULE_SCORE_TABLE<Rules>[roll][index];
+    uint32_t bonus = 0;
+    bool next_yahtzee = false;
+    if constexpr (Rules::HAS_JOKER) {
+        // A yahtzee rolled with the yahtzee box holding one is a joker and earns the bonus in any box
+        const bool yahtzee_recorded = key.IsYahtzeeRecorded();
+        if (yahtzee_recorded && SHAPE_ROLL_TABLE<typename Rules::Shape>.is_yahtzee[roll]) {
+            points = RULE_JOKER_SCORE_TABLE<Rules>[roll][index];
+            bonus = Rules::YAHTZEE_BONUS;
+        }
+        next_yahtzee = yahtzee_recorded || (category == Rules::YAHTZEE_CATEGORY && points == Rules::YAHTZEE_SCORE);
+    }
+    uint32_t next_remaining = remaining_upper;
+    if (index < Rules::NUM_UPPER_CATEGORIES) {
+        next_remaining = points >= remaining_upper ? 0 : remaining_upper - points;
+        if (remaining_upper > 0 && next_remaining == 0) {
+            bonus += Rules::UPPER_BONUS;
+        }
+    }
+    const uint32_t next_mask = key.UsedMask() | (uint32_t{1} << index);
+    return {points + bonus, typename Rules::StateKey(next_mask, next_remaining, next_yahtzee)};
+}
+
+template<typename Rules>
+uint32_t GetAllowedCategoryMask(typename Rules::StateKey key, RuleRollIndex<Rules> roll) {
+    const uint32_t open_mask = ~key.UsedMask() & Rules::StateKey::FULL_MASK;
+    if constexpr (Rules::HAS_JOKER) {
+        const auto &rolls = SHAPE_ROLL_TABLE<typename Rules::Shape>;
+        if (key.IsYahtzeeRecorded() && rolls.is_yahtzee[roll]) {
+            return Rules::AllowedCategories(open_mask, rolls.yahtzee_face[roll]);
+        }
+    }
+    return Rules::AllowedCategories(open_mask, 0);
+}
+
+template<typename Rules>
+void GetSuccessors(typename Rules::StateKey key, std::vector<typename Rules::StateKey> &successors) {
+    using StateKey = typename Rules::StateKey;
+    using RollIndex = RuleRollIndex<Rules>;
+    successors.clear();
+    for (size_t roll = 0; roll < Rules::Shape::NUM_ROLLS; ++roll) {
+        const uint32_t allowed = GetAllowedCategoryMask<Rules>(key, static_cast<RollIndex>(roll));
+        for (uint32_t mask = allowed; mask != 0; mask &= mask - 1) {
+            uint32_t category = 0;
+            while (!((mask >> category) & 1u)) {
+                ++category;
+            }
+            successors.push_back(GetScoreOutcome<Rules>(key, static_cast<RollIndex>(roll),
+                                                        static_cast<typename Rules::CategoryType>(category))
+                                     .next);
+        }
+    }
+    std::sort(successors.begin(), successors.end(), [](StateKey a, StateKey b) { return a.Value() < b.Value(); });
+    successors.erase(std::unique(successors.begin(), successors.end()), successors.end());
+}
+
+template<typename Rules>
+BasicTurnEvaluator<Rules>::BasicTurnEvaluator(const double *state_values, TableLayout layout)
+    : state_values_(state_values), layout_(layout), kernels_(&GetTurnKernels<double, Shape>()) {
+    if (!std::is_same_v<StateKey, ShortStateKey> && layout != TableLayout::ShortStateKeyDense) {
+        throw std::invalid_argument("Only the dense layout holds the states of this rule set");
+    }
+}
+
+template<typename Rules>
+BasicTurnEvaluator<Rules>::BasicTurnEvaluator(const QuantizedTable &table)
+    : state_values_(nullptr), quantized_(&table), layout_(table.GetLayout()),
+      kernels_(&GetTurnKernels<double, Shape>()) {
+    if (!std::is_same_v<StateKey, ShortStateKey>) {
+        throw std::invalid_argument("Quantized tables only hold the states of the Yahtzee rules");
+    }
+}
+
+template<typename Rules>
+void BasicTurnEvaluator<Rules>::Evaluate(StateKey key, size_t rerolls) {
+    if (rerolls > MAX_REROLLS) {
+        throw std::out_of_range("Rerolls cannot exceed 3");
+    }
+    if (key != key_) {
+        key_ = key;
+        evaluated_levels_ = 0;
+    }
+    if (evaluated_levels_ == 0) {
+        CountMetric(MetricCounter::TurnEvaluations);
+        EvaluateScoreLevel();
+        evaluated_levels_ = 1;
+    }
+    for (; evaluated_levels_ <= rerolls; ++evaluated_levels_) {
+        EvaluateRerollLevel(evaluated_levels_);
+    }
+}
+
+template<typename Rules>
+double BasicTurnEvaluator<Rules>::GetScoreValue(RollIndex roll, CategoryType category) const {
+    const BasicScoreOutcome<StateKey> outcome = GetScoreOutcome<Rules>(key_, roll, category);
+    const size_t offset = GetLayoutOffset(outcome.next, layout_);
+    return static_cast<double>(outcome.points) +
+           (quantized_ == nullptr ? state_values_[offset] : quantized_->GetValue(offset));
+}
+
+template<typename Rules>
+double BasicTurnEvaluator<Rules>::GetKeepValue(size_t rerolls, KeepIndex keep) const {
+    return ReduceKeep<double, Shape>(keep, roll_values_[rerolls - 1].data());
+}
+
+template<typename Rules>
+void BasicTurnEvaluator<Rules>::GetKeepValues(size_t rerolls, std::array<double, Shape::NUM_KEEPS> &values) const {
+    kernels_->reduce_keeps(roll_values_[rerolls - 1].data(), values.data());
+}
+
+template<typename Rules>
+double BasicTurnEvaluator<Rules>::GetTurnStartValue() const {
+    if (key_.IsGameOver()) {
+        return 0.0;
+    }
+    double expected = 0.0;
+    for (size_t roll = 0; roll < Shape::NUM_ROLLS; ++roll) {
+        expected += SHAPE_ROLL_TABLE<Shape>.probability[roll] * roll_values_[TURN_REROLLS][roll];
+    }
+    return expected;
+}
+
+// Best score move for every final roll
+template<typename Rules>
+void BasicTurnEvaluator<Rules>::EvaluateScoreLevel() {
+    auto &values = roll_values_[0];
+    if (key_.IsGameOver()) {
+        values.fill(0.0);
+        return;
+    }
+    for (size_t roll = 0; roll < Shape::NUM_ROLLS; ++roll) {
+        const uint32_t allowed = GetAllowedCategoryMask<Rules>(key_, static_cast<RollIndex>(roll));
+        double best = -std::numeric_limits<double>::infinity();
+        for (uint32_t category = 0; category < Rules::NUM_CATEGORIES; ++category) {
+            if (allowed & (uint32_t{1} << category)) {
+                best = std::max(best,
+                                GetScoreValue(static_cast<RollIndex>(roll), static_cast<CategoryType>(category)));
+            }
+        }
+        values[roll] = best;
+    }
+}
+
+// Rerolls: the value of a roll is the best of scoring now and every keep
+template<typename Rules>
+void BasicTurnEvaluator<Rules>::EvaluateRerollLevel(size_t rerolls) {
+    kernels_->reduce_keeps(roll_values_[rerolls - 1].data(), keep_values_.data());
+    kernels_->max_rolls(roll_values_[0].data(), keep_values_.data(), roll_values_[rerolls].data());
+}
+
+// One set of kernels per rule set
+#define INSTANTIATE_TURN_EVALUATOR(Rules)                                                                              \
+    template BasicScoreOutcome<Rules::StateKey> GetScoreOutcome<Rules>(Rules::StateKey, RuleRollIndex<Rules>,          \
+                                                                       Rules::CategoryType);                           \
+    template uint32_t GetAllowedCategoryMask<Rules>(Rules::StateKey, RuleRollIndex<Rules>);                            \
+    template void GetSuccessors<Rules>(Rules::StateKey, std::vector<Rules::StateKey> &);                               \
+    template class BasicTurnEvaluator<Rules>;
+
+INSTANTIATE_TURN_EVALUATOR(YahtzeeRules)
+INSTANTIATE_TURN_EVALUATOR(FreeJokerYahtzeeRules)
+INSTANTIATE_TURN_EVALUATOR(YatzyRules)
+INSTANTIATE_TURN_EVALUATOR(MaxiYatzyNoSavedRerollsRules)
+
+#undef INSTANTIATE_TURN_EVALUATOR
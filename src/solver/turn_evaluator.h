@@ -0,0 +1,104 @@
+#pragma once
+
+#include "../game_state/category.h"
+#include "../game_state/dice_index.h"
+#include "../game_state/rules.h"
+#include "../game_state/short_state_key.h"
+#include "quantized_table.h"
+#include "table_layout.h"
+#include "turn_kernels.h"
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+// Points of a score move, upper bonus included, and the turn-start state it leads to
+template<typename StateKey>
+struct BasicScoreOutcome {
+    uint32_t points;
+    StateKey next;
+};
+
+using ScoreOutcome = BasicScoreOutcome<ShortStateKey>;
+
+// The functions below and BasicTurnEvaluator take the rule set as a template
+// parameter (see rules.h) and are instantiated for every rule set there. Rolls
+// and keeps are those of the dice of the rules, Rules::Shape.
+
+template<typename Rules>
+using RuleRollIndex = typename Rules::Shape::RollIndex;
+
+// Score move of a final roll in a turn-start state, following the rules of ApplyMove
+template<typename Rules = YahtzeeRules>
+BasicScoreOutcome<typename Rules::StateKey> GetScoreOutcome(typename Rules::StateKey key, RuleRollIndex<Rules> roll,
+                                                            typename Rules::CategoryType category);
+
+// Categories the roll may be scored in: the open ones, narrowed by the joker rules
+template<typename Rules = YahtzeeRules>
+uint32_t GetAllowedCategoryMask(typename Rules::StateKey key, RuleRollIndex<Rules> roll);
+
+// Distinct turn-start states one turn of key can lead to, in key order
+template<typename Rules = YahtzeeRules>
+void GetSuccessors(typename Rules::StateKey key, std::vector<typename Rules::StateKey> &successors);
+
+// Values inside one turn of a state, given the values of the turn-start states.
+//
+// Level r holds, for every roll, the best expected rest-of-game score when
+// that roll is showing with r rerolls left: the best of every allowed score
+// move and every keep. Level 0 only has score moves. The values of the
+// turn-start states, in the order of the layout, must outlive the evaluator;
+// they can also be read straight from a QuantizedTable of the Yahtzee rules.
+// Rule sets other than the Yahtzee ones only have the dense layout. Every
+// dice shape runs the same vector kernels over its own tables.
+template<typename Rules>
+class BasicTurnEvaluator {
+public:
+    using StateKey = typename Rules::StateKey;
+    using CategoryType = typename Rules::CategoryType;
+    using Shape = typename Rules::Shape;
+    using RollIndex = typename Shape::RollIndex;
+    using KeepIndex = typename Shape::KeepIndex;
+
+    static constexpr size_t MAX_REROLLS = 3;
+    static constexpr size_t TURN_REROLLS = 2;  // rerolls after the first roll of a turn
+
+    explicit BasicTurnEvaluator(const double *state_values, TableLayout layout = TableLayout::ShortStateKeyDense);
+    // Decodes every value it reads; the table must outlive the evaluator
+    explicit BasicTurnEvaluator(const QuantizedTable &table);
+
+    // Computes levels 0..rerolls for the state; cheap when already done for it
+    void Evaluate(StateKey key, size_t rerolls = TURN_REROLLS);
+
+    StateKey GetKey() const { return key_; }
+
+    // Best value of the roll with the given rerolls left, the level must be evaluated
+    double GetRollValue(size_t rerolls, RollIndex roll) const { return roll_values_[rerolls][roll]; }
+
+    // Points of the score move plus the value of the next turn-start state
+    double GetScoreValue(RollIndex roll, CategoryType category) const;
+
+    // Expected value of rerolling everything but the keep, with rerolls left
+    // before the reroll; level rerolls - 1 must be evaluated
+    double GetKeepValue(size_t rerolls, KeepIndex keep) const;
+
+    // Every keep value at once, through the vector kernels; level rerolls - 1 must be evaluated
+    void GetKeepValues(size_t rerolls, std::array<double, Shape::NUM_KEEPS> &values) const;
+
+    // Expected value before the first roll, levels up to TURN_REROLLS must be evaluated
+    double GetTurnStartValue() const;
+
+private:
+    void EvaluateScoreLevel();
+    void EvaluateRerollLevel(size_t rerolls);
+
+    const double *state_values_;
+    const QuantizedTable *quantized_{nullptr};  // read instead of state_values_ when set
+    TableLayout layout_;
+    const TurnKernels<double> *kernels_;
+    StateKey key_{};
+    size_t evaluated_levels_{0};  // number of valid levels for key_
+    std::array<std::array<double, Shape::NUM_ROLLS>, MAX_REROLLS + 1> roll_values_{};
+    std::array<double, Shape::NUM_KEEPS> keep_values_{};
+};
+
+using TurnEvaluator = BasicTurnEvaluator<YahtzeeRules>;
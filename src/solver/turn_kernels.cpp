@@ -0,0 +1,319 @@
+#include "turn_kernels.h"
+#include "../move/reroll_matrix.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#ifdef YAHTZEE_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// Rows are padded to whole vectors of LANES entries
+constexpr size_t LANES = 8;
+
+// Keeps of all dice reroll nothing, their value is the roll's own
+template<typename Shape>
+constexpr size_t NUM_PARTIAL_KEEPS = SHAPE_KEEP_OFFSETS<Shape>[Shape::NUM_DICE];
+
+size_t PadToLanes(size_t size) {
+    return (size + LANES - 1) / LANES * LANES;
+}
+
+// SHAPE_REROLL_MATRIX and SHAPE_SUB_KEEP_TABLE with every row padded to a multiple
+// of LANES: zero-probability entries for sums, a repeated keep for maxima
+template<typename Shape>
+struct PaddedTables {
+    std::vector<uint32_t> keep_offsets;
+    std::vector<int32_t> keep_rolls;
+    std::vector<double> keep_probabilities;
+    std::vector<float> keep_probabilities_float;
+
+    std::vector<uint32_t> roll_offsets;
+    std::vector<int32_t> roll_keeps;
+
+    PaddedTables() {
+        using KeepIndex = typename Shape::KeepIndex;
+        for (size_t keep = 0; keep < NUM_PARTIAL_KEEPS<Shape>; ++keep) {
+            keep_offsets.push_back(static_cast<uint32_t>(keep_rolls.size()));
+            const auto row = SHAPE_REROLL_MATRIX<Shape>.GetRow(static_cast<KeepIndex>(keep));
+            for (size_t i = 0; i < PadToLanes(row.size); ++i) {
+                keep_rolls.push_back(i < row.size ? row.rolls[i] : 0);
+                keep_probabilities.push_back(i < row.size ? row.probabilities[i] : 0.0);
+                keep_probabilities_float.push_back(static_cast<float>(keep_probabilities.back()));
+            }
+        }
+        keep_offsets.push_back(static_cast<uint32_t>(keep_rolls.size()));
+
+        for (size_t roll = 0; roll < Shape::NUM_ROLLS; ++roll) {
+            roll_offsets.push_back(static_cast<uint32_t>(roll_keeps.size()));
+            auto row = SHAPE_SUB_KEEP_TABLE<Shape>.GetRow(static_cast<KeepIndex>(NUM_PARTIAL_KEEPS<Shape> + roll));
+            for (size_t i = 0; i < PadToLanes(row.size()); ++i) {
+                roll_keeps.push_back(row.begin()[std::min(i, row.size() - 1)]);
+            }
+        }
+        roll_offsets.push_back(static_cast<uint32_t>(roll_keeps.size()));
+    }
+
+    template<typename T>
+    const T *Probabilities() const {
+        if constexpr (std::is_same_v<T, float>) {
+            return keep_probabilities_float.data();
+        } else {
+            return keep_probabilities.data();
+        }
+    }
+};
+
+template<typename Shape>
+const PaddedTables<Shape> &GetPaddedTables() {
+    static const PaddedTables<Shape> tables;
+    return tables;
+}
+
+template<typename Shape, typename T>
+void CopyFullKeeps(const T *roll_values, T *keep_values) {
+    std::copy(roll_values, roll_values + Shape::NUM_ROLLS, keep_values + NUM_PARTIAL_KEEPS<Shape>);
+}
+
+// Reference order: lane j sums entries j, j + 8, ...; lanes fold as
+// (a0 + a4) + (a2 + a6) and (a1 + a5) + (a3 + a7), then the two halves
+template<typename Shape, typename T>
+T ReducePaddedRow(const PaddedTables<Shape> &tables, size_t keep, const T *roll_values) {
+    const int32_t *rolls = tables.keep_rolls.data();
+    const T *probabilities = tables.template Probabilities<T>();
+    T lanes[LANES] = {};
+    for (size_t entry = tables.keep_offsets[keep]; entry < tables.keep_offsets[keep + 1]; entry += LANES) {
+        for (size_t j = 0; j < LANES; ++j) {
+            T product = probabilities[entry + j] * roll_values[rolls[entry + j]];
+            lanes[j] = lanes[j] + product;
+        }
+    }
+    T s0 = lanes[0] + lanes[4];
+    T s1 = lanes[1] + lanes[5];
+    T s2 = lanes[2] + lanes[6];
+    T s3 = lanes[3] + lanes[7];
+    T t0 = s0 + s2;
+    T t1 = s1 + s3;
+    return t0 + t1;
+}
+
+template<typename Shape, typename T>
+void ReduceKeepsScalar(const T *roll_values, T *keep_values) {
+    const PaddedTables<Shape> &tables = GetPaddedTables<Shape>();
+    for (size_t keep = 0; keep < NUM_PARTIAL_KEEPS<Shape>; ++keep) {
+        keep_values[keep] = ReducePaddedRow(tables, keep, roll_values);
+    }
+    CopyFullKeeps<Shape>(roll_values, keep_values);
+}
+
+template<typename Shape, typename T>
+void MaxRollsScalar(const T *score_values, const T *keep_values, T *roll_values) {
+    const PaddedTables<Shape> &tables = GetPaddedTables<Shape>();
+    for (size_t roll = 0; roll < Shape::NUM_ROLLS; ++roll) {
+        T best = score_values[roll];
+        for (size_t entry = tables.roll_offsets[roll]; entry < tables.roll_offsets[roll + 1]; ++entry) {
+            best = std::max(best, keep_values[tables.roll_keeps[entry]]);
+        }
+        roll_values[roll] = best;
+    }
+}
+
+#ifdef YAHTZEE_X86_KERNELS
+
+__attribute__((target("avx2"))) double FoldAvx2(__m256d s) {
+    __m128d t = _mm_add_pd(_mm256_castpd256_pd128(s), _mm256_extractf128_pd(s, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(t, _mm_unpackhi_pd(t, t)));
+}
+
+template<typename Shape>
+__attribute__((target("avx2"))) void ReduceKeepsAvx2Double(const double *roll_values, double *keep_values) {
+    const PaddedTables<Shape> &tables = GetPaddedTables<Shape>();
+    const int32_t *rolls = tables.keep_rolls.data();
+    const double *probabilities = tables.keep_probabilities.data();
+    for (size_t keep = 0; keep < NUM_PARTIAL_KEEPS<Shape>; ++keep) {
+        __m256d low = _mm256_setzero_pd();
+        __m256d high = _mm256_setzero_pd();
+        for (size_t entry = tables.keep_offsets[keep]; entry < tables.keep_offsets[keep + 1]; entry += LANES) {
+            __m128i low_rolls = _mm_loadu_si128(reinterpret_cast<const __m128i *>(rolls + entry));
+            __m128i high_rolls = _mm_loadu_si128(reinterpret_cast<const __m128i *>(rolls + entry + 4));
+            low = _mm256_add_pd(low, _mm256_mul_pd(_mm256_loadu_pd(probabilities + entry),
+                                                   _mm256_i32gather_pd(roll_values, low_rolls, 8)));
+            high = _mm256_add_pd(high, _mm256_mul_pd(_mm256_loadu_pd(probabilities + entry + 4),
+                                                     _mm256_i32gather_pd(roll_values, high_rolls, 8)));
+        }
+        keep_values[keep] = FoldAvx2(_mm256_add_pd(low, high));
+    }
+    CopyFullKeeps<Shape>(roll_values, keep_values);
+}
+
+template<typename Shape>
+__attribute__((target("avx2"))) void ReduceKeepsAvx2Float(const float *roll_values, float *keep_values) {
+    const PaddedTables<Shape> &tables = GetPaddedTables<Shape>();
+    const int32_t *rolls = tables.keep_rolls.data();
+    const float *probabilities = tables.keep_probabilities_float.data();
+    for (size_t keep = 0; keep < NUM_PARTIAL_KEEPS<Shape>; ++keep) {
+        __m256 lanes = _mm256_setzero_ps();
+        for (size_t entry = tables.keep_offsets[keep]; entry < tables.keep_offsets[keep + 1]; entry += LANES) {
+            __m256i entry_rolls = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(rolls + entry));
+            lanes = _mm256_add_ps(lanes, _mm256_mul_ps(_mm256_loadu_ps(probabilities + entry),
+                                                       _mm256_i32gather_ps(roll_values, entry_rolls, 4)));
+        }
+        __m128 s = _mm_add_ps(_mm256_castps256_ps128(lanes), _mm256_extractf128_ps(lanes, 1));
+        __m128 t = _mm_add_ps(s, _mm_movehl_ps(s, s));
+        keep_values[keep] = _mm_cvtss_f32(_mm_add_ss(t, _mm_shuffle_ps(t, t, 1)));
+    }
+    CopyFullKeeps<Shape>(roll_values, keep_values);
+}
+
+template<typename Shape>
+__attribute__((target("avx2"))) void MaxRollsAvx2Double(const double *score_values, const double *keep_values,
+                                                        double *roll_values) {
+    const PaddedTables<Shape> &tables = GetPaddedTables<Shape>();
+    const int32_t *keeps = tables.roll_keeps.data();
+    for (size_t roll = 0; roll < Shape::NUM_ROLLS; ++roll) {
+        __m256d best = _mm256_set1_pd(score_values[roll]);
+        for (size_t entry = tables.roll_offsets[roll]; entry < tables.roll_offsets[roll + 1]; entry += LANES) {
+            __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i *>(keeps + entry));
+            __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i *>(keeps + entry + 4));
+            best = _mm256_max_pd(best, _mm256_i32gather_pd(keep_values, low, 8));
+            best = _mm256_max_pd(best, _mm256_i32gather_pd(keep_values, high, 8));
+        }
+        __m128d half = _mm_max_pd(_mm256_castpd256_pd128(best), _mm256_extractf128_pd(best, 1));
+        roll_values[roll] = _mm_cvtsd_f64(_mm_max_sd(half, _mm_unpackhi_pd(half, half)));
+    }
+}
+
+template<typename Shape>
+__attribute__((target("avx2"))) void MaxRollsAvx2Float(const float *score_values, const float *keep_values,
+                                                       float *roll_values) {
+    const PaddedTables<Shape> &tables = GetPaddedTables<Shape>();
+    const int32_t *keeps = tables.roll_keeps.data();
+    for (size_t roll = 0; roll < Shape::NUM_ROLLS; ++roll) {
+        __m256 best = _mm256_set1_ps(score_values[roll]);
+        for (size_t entry = tables.roll_offsets[roll]; entry < tables.roll_offsets[roll + 1]; entry += LANES) {
+            __m256i entry_keeps = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(keeps + entry));
+            best = _mm256_max_ps(best, _mm256_i32gather_ps(keep_values, entry_keeps, 4));
+        }
+        __m128 half = _mm_max_ps(_mm256_castps256_ps128(best), _mm256_extractf128_ps(best, 1));
+        half = _mm_max_ps(half, _mm_movehl_ps(half, half));
+        roll_values[roll] = _mm_cvtss_f32(_mm_max_ss(half, _mm_shuffle_ps(half, half, 1)));
+    }
+}
+
+template<typename Shape>
+__attribute__((target("avx512f"))) void ReduceKeepsAvx512Double(const double *roll_values, double *keep_values) {
+    const PaddedTables<Shape> &tables = GetPaddedTables<Shape>();
+    const int32_t *rolls = tables.keep_rolls.data();
+    const double *probabilities = tables.keep_probabilities.data();
+    for (size_t keep = 0; keep < NUM_PARTIAL_KEEPS<Shape>; ++keep) {
+        __m512d lanes = _mm512_setzero_pd();
+        for (size_t entry = tables.keep_offsets[keep]; entry < tables.keep_offsets[keep + 1]; entry += LANES) {
+            __m256i entry_rolls = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(rolls + entry));
+            lanes = _mm512_add_pd(lanes, _mm512_mul_pd(_mm512_loadu_pd(probabilities + entry),
+                                                       _mm512_i32gather_pd(entry_rolls, roll_values, 8)));
+        }
+        __m256d s = _mm256_add_pd(_mm512_castpd512_pd256(lanes), _mm512_extractf64x4_pd(lanes, 1));
+        __m128d t = _mm_add_pd(_mm256_castpd256_pd128(s), _mm256_extractf128_pd(s, 1));
+        keep_values[keep] = _mm_cvtsd_f64(_mm_add_sd(t, _mm_unpackhi_pd(t, t)));
+    }
+    CopyFullKeeps<Shape>(roll_values, keep_values);
+}
+
+template<typename Shape>
+__attribute__((target("avx512f"))) void MaxRollsAvx512Double(const double *score_values, const double *keep_values,
+                                                            double *roll_values) {
+    const PaddedTables<Shape> &tables = GetPaddedTables<Shape>();
+    const int32_t *keeps = tables.roll_keeps.data();
+    for (size_t roll = 0; roll < Shape::NUM_ROLLS; ++roll) {
+        __m512d best = _mm512_set1_pd(score_values[roll]);
+        for (size_t entry = tables.roll_offsets[roll]; entry < tables.roll_offsets[roll + 1]; entry += LANES) {
+            __m256i entry_keeps = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(keeps + entry));
+            best = _mm512_max_pd(best, _mm512_i32gather_pd(entry_keeps, keep_values, 8));
+        }
+        roll_values[roll] = _mm512_reduce_max_pd(best);
+    }
+}
+
+#endif  // YAHTZEE_X86_KERNELS
+
+template<typename T, typename Shape>
+constexpr TurnKernels<T> SCALAR_KERNELS{ReduceKeepsScalar<Shape, T>, MaxRollsScalar<Shape, T>, KernelIsa::Scalar};
+
+}  // namespace
+
+KernelIsa DetectKernelIsa() {
+#ifdef YAHTZEE_X86_KERNELS
+    static const KernelIsa isa = [] {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) {
+            return KernelIsa::Avx512;
+        }
+        if (__builtin_cpu_supports("avx2")) {
+            return KernelIsa::Avx2;
+        }
+        return KernelIsa::Scalar;
+    }();
+    return isa;
+#else
+    return KernelIsa::Scalar;
+#endif
+}
+
+const char *KernelIsaToString(KernelIsa isa) {
+    switch (isa) {
+        case KernelIsa::Scalar: return "scalar";
+        case KernelIsa::Avx2: return "avx2";
+        case KernelIsa::Avx512: return "avx512";
+        default: return "unknown";
+    }
+}
+
+template<typename T, typename Shape>
+const TurnKernels<T> &GetTurnKernels(KernelIsa isa) {
+    isa = std::min(isa, DetectKernelIsa());
+#ifdef YAHTZEE_X86_KERNELS
+    if constexpr (std::is_same_v<T, double>) {
+        static constexpr TurnKernels<double> avx2{ReduceKeepsAvx2Double<Shape>, MaxRollsAvx2Double<Shape>,
+                                                  KernelIsa::Avx2};
+        static constexpr TurnKernels<double> avx512{ReduceKeepsAvx512Double<Shape>, MaxRollsAvx512Double<Shape>,
+                                                    KernelIsa::Avx512};
+        if (isa == KernelIsa::Avx512) {
+            return avx512;
+        }
+        if (isa == KernelIsa::Avx2) {
+            return avx2;
+        }
+    } else {
+        // Eight float lanes already cover a padded row chunk; 16-wide AVX-512
+        // would have to change the summation order, so it uses the AVX2 kernels
+        static constexpr TurnKernels<float> avx2{ReduceKeepsAvx2Float<Shape>, MaxRollsAvx2Float<Shape>,
+                                                 KernelIsa::Avx2};
+        if (isa >= KernelIsa::Avx2) {
+            return avx2;
+        }
+    }
+#endif
+    return SCALAR_KERNELS<T, Shape>;
+}
+
+template<typename T, typename Shape>
+T ReduceKeep(typename Shape::KeepIndex keep, const T *roll_values) {
+    if (keep >= NUM_PARTIAL_KEEPS<Shape>) {
+        return roll_values[keep - NUM_PARTIAL_KEEPS<Shape>];
+    }
+    return ReducePaddedRow(GetPaddedTables<Shape>(), keep, roll_values);
+}
+
+template const TurnKernels<float> &GetTurnKernels<float, FiveDice>(KernelIsa isa);
+template const TurnKernels<double> &GetTurnKernels<double, FiveDice>(KernelIsa isa);
+template const TurnKernels<float> &GetTurnKernels<float, SixDice>(KernelIsa isa);
+template const TurnKernels<double> &GetTurnKernels<double, SixDice>(KernelIsa isa);
+
+template float ReduceKeep<float, FiveDice>(KeepIndex keep, const float *roll_values);
+template double ReduceKeep<double, FiveDice>(KeepIndex keep, const double *roll_values);
+template float ReduceKeep<float, SixDice>(SixDice::KeepIndex keep, const float *roll_values);
+template double ReduceKeep<double, SixDice>(SixDice::KeepIndex keep, const double *roll_values);
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "../game_state/dice_index.h"
+
+#include <cstddef>
+
+// x86 kernels need GCC-style target attributes and CPU detection
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define YAHTZEE_X86_KERNELS 1
+#endif
+
+// Kernels of the per-turn reduction, selected at runtime by CPU features.
+//
+// ReduceKeeps is the weighted sum over roll outcomes for every keep, MaxRolls
+// the max over the keeps of every roll. Every kernel sums a row in the same
+// order (eight interleaved partial sums folded as a fixed tree) and the
+// scalar kernel is written to match, so all of them give bit-identical
+// results. Vector kernels never use FMA for the same reason.
+//
+// The kernels of every DiceShape share this code and layout, only the tables
+// they stream differ; the plain calls are the FiveDice ones.
+
+enum class KernelIsa {
+    Scalar,
+    Avx2,
+    Avx512,
+};
+
+template<typename T>
+struct TurnKernels {
+    // keep_values[k] = sum over rolls of P(k -> roll) * roll_values[roll], for all keeps of the shape
+    void (*reduce_keeps)(const T *roll_values, T *keep_values);
+    // roll_values[r] = max(score_values[r], keep_values[k] for every keep k of roll r)
+    void (*max_rolls)(const T *score_values, const T *keep_values, T *roll_values);
+    KernelIsa isa;
+};
+
+// Best instruction set the CPU supports
+KernelIsa DetectKernelIsa();
+
+const char *KernelIsaToString(KernelIsa isa);
+
+// Kernels for the instruction set, or the best supported one below it
+template<typename T, typename Shape = FiveDice>
+const TurnKernels<T> &GetTurnKernels(KernelIsa isa = DetectKernelIsa());
+
+// One row of reduce_keeps, summed in the same order as the kernels
+template<typename T, typename Shape = FiveDice>
+T ReduceKeep(typename Shape::KeepIndex keep, const T *roll_values);
@@ -0,0 +1,41 @@
+#include <gtest/gtest.h>
+#include "move/move_list.h"
+#include "game_state/game_state.h"
+#include "game_state/short_game_state.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Counts heap allocations of this test binary only, which is why it is not part of runTests
+static std::atomic<size_t> allocation_count{0};
+
+void* operator new(size_t size) {
+    ++allocation_count;
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+TEST(MoveListTest, NoAllocations) {
+    GameState state;
+    state.SetCurrentDice(Dice({1, 2, 3, 4, 5}));
+    ShortGameState short_state(state);
+    MoveList list;
+
+    size_t before = allocation_count.load();
+    GetPossibleMoves(state, list);
+    EXPECT_EQ(list.size(), 32 + 13);
+    GetPossibleMoves(short_state, list);
+    EXPECT_EQ(list.size(), 32 + 13);
+    EXPECT_EQ(allocation_count.load(), before);
+}
@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+#include "solver/advisor.h"
+#include "solver/solver.h"
+#include "test_util.h"
+
+TEST(AdvisorTest, RerollsLowDiceForChance) {
+    Advisor advisor(EndgameSolver().GetValues().data());
+    GameState state = StateWithOpen({Category::Chance});
+    state.SetCurrentDice(Dice({1, 1, 1, 1, 1}));
+
+    Advice advice = advisor.Advise(state);
+    // 6 distinct keeps + Chance
+    EXPECT_EQ(advice.moves.size(), 7);
+    ASSERT_TRUE(advice.GetBestMove().IsReroll());
+    EXPECT_EQ(advice.GetBestMove().GetKeepIndex(), Dice().keep_index());
+    // Two rolls left for each die: 4.25 expected pips
+    EXPECT_NEAR(advice.GetBestValue(), 5 * 4.25, 1e-9);
+
+    for (size_t i = 0; i < advice.moves.size(); ++i) {
+        if (!advice.moves[i].IsReroll()) {
+            EXPECT_DOUBLE_EQ(advice.values[i], 5.0);
+        }
+    }
+}
+
+TEST(AdvisorTest, ScoresWithNoRerollsLeft) {
+    Advisor advisor(EndgameSolver().GetValues().data());
+    GameState state = StateWithOpen({Category::Chance});
+    state.SetCurrentDice(Dice({6, 6, 5, 5, 4}));
+    state.SetRemainingRerolls(0);
+
+    Advice advice = advisor.Advise(state);
+    ASSERT_EQ(advice.moves.size(), 1);
+    EXPECT_EQ(advice.GetBestMove().GetCategory(), Category::Chance);
+    EXPECT_DOUBLE_EQ(advice.GetBestValue(), 26.0);
+}
+
+TEST(AdvisorTest, KeepsHighDice) {
+    Advisor advisor(EndgameSolver().GetValues().data());
+    GameState state = StateWithOpen({Category::Chance});
+    state.SetCurrentDice(Dice({6, 5, 4, 2, 1}));
+    state.SetRemainingRerolls(1);
+
+    // With one reroll left a die is kept on 4 or more
+    Advice advice = advisor.Advise(state);
+    ASSERT_TRUE(advice.GetBestMove().IsReroll());
+    EXPECT_EQ(advice.GetBestMove().GetKeepIndex(), Dice({4, 5, 6}).keep_index());
+    EXPECT_NEAR(advice.GetBestValue(), 15 + 2 * 3.5, 1e-9);
+}
+
+TEST(AdvisorTest, BestValuesAverageToStateValue) {
+    const Solver& solver = EndgameSolver();
+    Advisor advisor(solver.GetValues().data());
+
+    GameState state = StateWithOpen({Category::Chance});
+    GameState two_open;
+    for (size_t i = 0; i < NUM_CATEGORIES; ++i) {
+        Category category = static_cast<Category>(i);
+        if (category != Category::FullHouse && category != Category::Sixes) {
+            two_open.AddScoreToCategory(category, 0);
+        }
+    }
+
+    for (const GameState& base : {state, two_open}) {
+        double expected = 0.0;
+        for (size_t roll = 0; roll < NUM_ROLLS; ++roll) {
+            GameState query = base;
+            query.SetCurrentDice(Dice::from_roll_index(static_cast<RollIndex>(roll)));
+            expected += ROLL_TABLE.probability[roll] * advisor.Advise(query).GetBestValue();
+        }
+        EXPECT_NEAR(expected, solver.GetStateValue(ShortGameState(base)), 1e-9);
+    }
+}
+
+TEST(AdvisorTest, NeedsFullRoll) {
+    Advisor advisor(EndgameSolver().GetValues().data());
+    GameState state = StateWithOpen({Category::Chance});
+    EXPECT_THROW(advisor.Advise(state), std::invalid_argument);
+}
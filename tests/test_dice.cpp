@@ -83,6 +83,12 @@ TEST(DiceTest, CountsArray) {
     EXPECT_EQ(counts[3], 0); // 4's
     EXPECT_EQ(counts[4], 0); // 5's
     EXPECT_EQ(counts[5], 0); // 6's
+
+    // A copy of size_t counts; the stored bytes are the same numbers
+    std::array<size_t, NUM_FACES> copy = dice.counts();
+    for (size_t i = 0; i < NUM_FACES; ++i) {
+        EXPECT_EQ(copy[i], dice.raw_counts()[i]);
+    }
 }
 
 TEST(DiceTest, SumCalculation) {
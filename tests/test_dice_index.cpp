@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+#include "game_state/dice_index.h"
+#include "game_state/dice.h"
+
+#include <set>
+
+TEST(DiceIndexTest, RollsAreDistinctFiveDiceMultisets) {
+    std::set<DiceCounts> seen;
+    for (size_t roll = 0; roll < NUM_ROLLS; ++roll) {
+        const DiceCounts &counts = ROLL_TABLE.counts[roll];
+        size_t total = 0;
+        for (uint8_t count : counts) {
+            total += count;
+        }
+        EXPECT_EQ(total, 5);
+        seen.insert(counts);
+        EXPECT_EQ(ToRollIndex(counts), roll);
+    }
+    EXPECT_EQ(seen.size(), NUM_ROLLS);
+}
+
+TEST(DiceIndexTest, KeepsAreOrderedBySize) {
+    std::set<DiceCounts> seen;
+    for (size_t keep = 0; keep < NUM_KEEPS; ++keep) {
+        const DiceCounts &counts = KEEP_TABLE.counts[keep];
+        EXPECT_EQ(ToKeepIndex(counts), keep);
+        EXPECT_GE(keep, KEEP_OFFSETS[KEEP_TABLE.size[keep]]);
+        EXPECT_LT(keep, KEEP_OFFSETS[KEEP_TABLE.size[keep] + 1]);
+        seen.insert(counts);
+    }
+    EXPECT_EQ(seen.size(), NUM_KEEPS);
+
+    // Five-dice keeps line up with rolls
+    for (size_t roll = 0; roll < NUM_ROLLS; ++roll) {
+        EXPECT_EQ(KEEP_TABLE.counts[KEEP_OFFSETS[NUM_DICE] + roll], ROLL_TABLE.counts[roll]);
+    }
+}
+
+TEST(DiceIndexTest, ProbabilitiesSumToOne) {
+    double total = 0.0;
+    size_t permutations = 0;
+    for (size_t roll = 0; roll < NUM_ROLLS; ++roll) {
+        total += ROLL_TABLE.probability[roll];
+        permutations += ROLL_TABLE.permutations[roll];
+    }
+    EXPECT_NEAR(total, 1.0, 1e-12);
+    EXPECT_EQ(permutations, 7776);
+
+    for (size_t n = 0; n <= NUM_DICE; ++n) {
+        double keep_total = 0.0;
+        for (size_t keep = KEEP_OFFSETS[n]; keep < KEEP_OFFSETS[n + 1]; ++keep) {
+            keep_total += KEEP_TABLE.probability[keep];
+        }
+        EXPECT_NEAR(keep_total, 1.0, 1e-12);
+    }
+}
+
+TEST(DiceIndexTest, RollProperties) {
+    RollIndex yahtzee = Dice({4, 4, 4, 4, 4}).roll_index();
+    EXPECT_TRUE(ROLL_TABLE.is_yahtzee[yahtzee]);
+    EXPECT_EQ(ROLL_TABLE.yahtzee_face[yahtzee], 4);
+    EXPECT_EQ(ROLL_TABLE.sum[yahtzee], 20);
+    EXPECT_EQ(ROLL_TABLE.permutations[yahtzee], 1);
+    EXPECT_FALSE(ROLL_TABLE.is_full_house[yahtzee]);
+
+    RollIndex full_house = Dice({2, 2, 5, 5, 5}).roll_index();
+    EXPECT_TRUE(ROLL_TABLE.is_full_house[full_house]);
+    EXPECT_EQ(ROLL_TABLE.max_count[full_house], 3);
+    EXPECT_EQ(ROLL_TABLE.permutations[full_house], 10);
+
+    RollIndex small = Dice({1, 3, 4, 5, 6}).roll_index();
+    EXPECT_TRUE(ROLL_TABLE.is_small_straight[small]);
+    EXPECT_FALSE(ROLL_TABLE.is_large_straight[small]);
+
+    RollIndex large = Dice({2, 3, 4, 5, 6}).roll_index();
+    EXPECT_TRUE(ROLL_TABLE.is_small_straight[large]);
+    EXPECT_TRUE(ROLL_TABLE.is_large_straight[large]);
+    EXPECT_EQ(ROLL_TABLE.permutations[large], 120);
+}
+
+TEST(DiceIndexTest, DiceRoundTrip) {
+    for (size_t roll = 0; roll < NUM_ROLLS; ++roll) {
+        Dice dice = Dice::from_roll_index(static_cast<RollIndex>(roll));
+        EXPECT_EQ(dice.total(), 5);
+        EXPECT_EQ(dice.sum(), ROLL_TABLE.sum[roll]);
+        EXPECT_EQ(dice.roll_index(), roll);
+    }
+    EXPECT_EQ(Dice().keep_index(), 0);
+    EXPECT_EQ(Dice({6}).keep_index(), KEEP_OFFSETS[2] - 1);
+    EXPECT_THROW(Dice({1, 2}).roll_index(), std::invalid_argument);
+    EXPECT_THROW(Dice({1, 1, 1, 1, 1, 1}).keep_index(), std::invalid_argument);
+    EXPECT_THROW(Dice::from_roll_index(252), std::out_of_range);
+}
+
+TEST(DiceIndexTest, SixDiceTables) {
+    using Counts = SixDice::Counts;
+    const auto &rolls = SHAPE_ROLL_TABLE<SixDice>;
+    const auto &keeps = SHAPE_KEEP_TABLE<SixDice>;
+    const auto &offsets = SHAPE_KEEP_OFFSETS<SixDice>;
+    EXPECT_EQ(SixDice::NUM_ROLLS, 462);
+    EXPECT_EQ(SixDice::NUM_KEEPS, 924);
+
+    std::set<Counts> seen;
+    double total = 0.0;
+    size_t permutations = 0;
+    for (size_t roll = 0; roll < SixDice::NUM_ROLLS; ++roll) {
+        EXPECT_EQ(ToRollIndex<SixDice>(rolls.counts[roll]), roll);
+        EXPECT_EQ(keeps.counts[offsets[SixDice::NUM_DICE] + roll], rolls.counts[roll]);
+        seen.insert(rolls.counts[roll]);
+        total += rolls.probability[roll];
+        permutations += rolls.permutations[roll];
+    }
+    EXPECT_EQ(seen.size(), SixDice::NUM_ROLLS);
+    EXPECT_NEAR(total, 1.0, 1e-12);
+    EXPECT_EQ(permutations, 46656);
+
+    // Every sub-keep row lists each sub-multiset once, in keep order
+    for (size_t keep = 0; keep < SixDice::NUM_KEEPS; ++keep) {
+        EXPECT_EQ(ToKeepIndex<SixDice>(keeps.counts[keep]), keep);
+        size_t expected_size = 1;
+        for (uint8_t count : keeps.counts[keep]) {
+            expected_size *= count + 1u;
+        }
+        const auto row = SHAPE_SUB_KEEP_TABLE<SixDice>.GetRow(static_cast<SixDice::KeepIndex>(keep));
+        ASSERT_EQ(row.size(), expected_size) << keep;
+        for (const SixDice::KeepIndex *sub = row.first; sub != row.last; ++sub) {
+            if (sub != row.first) {
+                EXPECT_LT(sub[-1], *sub);
+            }
+            for (size_t face = 0; face < NUM_FACES; ++face) {
+                EXPECT_LE(keeps.counts[*sub][face], keeps.counts[keep][face]);
+            }
+        }
+    }
+
+    const BasicDice<SixDice> maxi({2, 2, 2, 2, 2, 2});
+    EXPECT_EQ(maxi.roll_index(), ToRollIndex<SixDice>(Counts{0, 6, 0, 0, 0, 0}));
+    EXPECT_EQ(BasicDice<SixDice>::from_roll_index(maxi.roll_index()).sum(), 12);
+    EXPECT_EQ(BasicDice<SixDice>({1, 2, 3, 4, 5}).keep_index(), ToKeepIndex<SixDice>(Counts{1, 1, 1, 1, 1, 0}));
+    EXPECT_THROW(BasicDice<SixDice>({1, 1, 1, 1, 1, 1, 1}).keep_index(), std::invalid_argument);
+}
@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+#include "solver/duel_solver.h"
+#include "solver/strategy_file.h"
+#include "game_state/category.h"
+#include "test_util.h"
+
+#include <cstdio>
+#include <string>
+
+namespace {
+
+constexpr double QUANTIZATION_ERROR = 3.0 / DuelSolver::QUANTUM;
+
+// Chance of a yahtzee in one turn when going for it, see ThresholdSolverTest
+constexpr double YAHTZEE_CHANCE = 0.046029;
+
+const ShortStateKey FULL(ShortStateKey::FULL_MASK, 0, false);
+const ShortStateKey YAHTZEE_ONLY(MaskWithOpen({Category::Yahtzee}), 0, false);
+const ShortStateKey CHANCE_ONLY(MaskWithOpen({Category::Chance}), 0, false);
+
+}  // namespace
+
+TEST(DuelSolverTest, LastTurnAgainstFullSheet) {
+    DuelSolver solver(YAHTZEE_ONLY, FULL);
+    EXPECT_EQ(solver.GetNumTurns(), 1u);
+    solver.Solve(1);
+    EXPECT_EQ(solver.GetFirstSolvedTurn(), 0u);
+
+    // Only a yahtzee scores, ties count half
+    EXPECT_NEAR(solver.GetWinProbability(YAHTZEE_ONLY, FULL, -10), YAHTZEE_CHANCE, 1e-5);
+    EXPECT_NEAR(solver.GetWinProbability(YAHTZEE_ONLY, FULL, 0), 0.5 + 0.5 * YAHTZEE_CHANCE, 1e-5);
+    EXPECT_NEAR(solver.GetWinProbability(YAHTZEE_ONLY, FULL, -50), 0.5 * YAHTZEE_CHANCE, 1e-5);
+    EXPECT_EQ(solver.GetWinProbability(YAHTZEE_ONLY, FULL, -51), 0.0);
+    EXPECT_EQ(solver.GetWinProbability(YAHTZEE_ONLY, FULL, 1), 1.0);
+    EXPECT_EQ(solver.GetWinProbability(FULL, FULL, 1), 1.0);
+    EXPECT_EQ(solver.GetWinProbability(FULL, FULL, 0), 0.5);
+}
+
+TEST(DuelSolverTest, SymmetricLastRound) {
+    DuelSolver solver(YAHTZEE_ONLY, YAHTZEE_ONLY);
+    EXPECT_EQ(solver.GetNumTurns(), 2u);
+    solver.Solve(2);
+
+    // Both go for a yahtzee whatever the first one scored, so a tie is a coin flip
+    EXPECT_NEAR(solver.GetWinProbability(YAHTZEE_ONLY, YAHTZEE_ONLY, 0), 0.5, QUANTIZATION_ERROR);
+    // Ten behind, the first needs a yahtzee and the second must miss one
+    EXPECT_NEAR(solver.GetWinProbability(YAHTZEE_ONLY, YAHTZEE_ONLY, -10), YAHTZEE_CHANCE * (1 - YAHTZEE_CHANCE),
+                1e-4);
+    EXPECT_EQ(solver.GetWinProbability(YAHTZEE_ONLY, YAHTZEE_ONLY, 51), 1.0);
+    EXPECT_THROW(solver.GetWinProbability(CHANCE_ONLY, YAHTZEE_ONLY, 0), std::out_of_range);
+}
+
+TEST(DuelSolverTest, RowsGrowWithTheLead) {
+    const ShortStateKey two_open(MaskWithOpen({Category::Chance, Category::LargeStraight}), 0, false);
+    DuelSolver solver(two_open, two_open);
+    solver.Solve(2);
+    EXPECT_EQ(solver.GetLayerStats().size(), solver.GetNumTurns());
+
+    double previous = 0.0;
+    for (int lead = -80; lead <= 80; ++lead) {
+        const double value = solver.GetWinProbability(two_open, two_open, lead);
+        EXPECT_GE(value, previous - QUANTIZATION_ERROR);
+        previous = value;
+    }
+    EXPECT_EQ(solver.GetWinProbability(two_open, two_open, -71), 0.0);
+    EXPECT_EQ(solver.GetWinProbability(two_open, two_open, 71), 1.0);
+    // Moving first is a disadvantage: the second player knows the score to beat
+    EXPECT_LT(solver.GetWinProbability(two_open, two_open, 0), 0.5);
+}
+
+TEST(DuelSolverTest, TableMatchesSolverAndResumes) {
+    const std::string path = "duel_solver_test.bin";
+    std::remove(path.c_str());
+    const ShortStateKey first(MaskWithOpen({Category::Chance, Category::Yahtzee}), 0, false);
+    const ShortStateKey second(MaskWithOpen({Category::Chance}), 0, false);
+
+    DuelSolver solver(first, second);
+    EXPECT_EQ(solver.GetNumTurns(), 3u);
+    solver.SolveTurn(2);
+    solver.WriteTable(path);
+
+    // Resumes after the turn in the checkpoint
+    DuelSolver resumed(first, second);
+    resumed.Solve(1, path);
+    EXPECT_EQ(resumed.GetLayerStats().size(), 2u);
+    EXPECT_EQ(resumed.GetFirstSolvedTurn(), 0u);
+    {
+        DuelTable table(path);
+        ASSERT_TRUE(table.IsOpen());
+        EXPECT_TRUE(table.VerifyChecksum());
+        EXPECT_EQ(table.GetHeader().layout, static_cast<uint32_t>(TableLayout::DuelPairRows));
+        EXPECT_EQ(table.GetHeader().element_type, static_cast<uint32_t>(ElementType::Fixed16));
+        EXPECT_EQ(table.GetInfo().first_solved_turn, 0u);
+        EXPECT_EQ(table.GetLayers().size(), 3u);
+        for (int lead = -60; lead <= 60; lead += 7) {
+            EXPECT_EQ(table.GetWinProbability(first, second, lead), resumed.GetWinProbability(first, second, lead));
+        }
+        EXPECT_THROW(StrategyTable strategy(path), std::runtime_error);
+    }
+
+    // A finished checkpoint leaves nothing to solve
+    DuelSolver finished(first, second);
+    finished.Solve(1, path);
+    EXPECT_TRUE(finished.GetLayerStats().empty());
+    EXPECT_EQ(finished.GetWinProbability(first, second, 3), resumed.GetWinProbability(first, second, 3));
+
+    DuelSolver other(second, second);
+    EXPECT_THROW(other.Solve(1, path), std::runtime_error);
+    std::remove(path.c_str());
+
+    // Checkpoints between turns are spaced out, but the end of a solve is always written
+    DuelSolver spaced(first, second);
+    EXPECT_THROW(spaced.Solve(1, path, 0), std::invalid_argument);
+    spaced.Solve(1, path, 100);
+    {
+        DuelTable table(path);
+        EXPECT_EQ(table.GetInfo().first_solved_turn, 0u);
+        EXPECT_EQ(table.GetWinProbability(first, second, 3), resumed.GetWinProbability(first, second, 3));
+    }
+    std::remove(path.c_str());
+}
+
+TEST(DuelSolverTest, RejectsBadPositions) {
+    EXPECT_THROW(DuelSolver(FULL, YAHTZEE_ONLY), std::invalid_argument);
+    EXPECT_THROW(DuelSolver(ShortStateKey(), YAHTZEE_ONLY), std::invalid_argument);
+    EXPECT_THROW(DuelSolver(ShortStateKey(0, 0, true), ShortStateKey()), std::invalid_argument);
+
+    DuelSolver solver(YAHTZEE_ONLY, YAHTZEE_ONLY);
+    EXPECT_THROW(solver.SolveTurn(0), std::invalid_argument);
+}
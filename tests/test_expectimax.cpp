@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+#include "solver/expectimax.h"
+#include "solver/advisor.h"
+#include "solver/solver.h"
+#include "solver/threshold_solver.h"
+#include "solver/transposition_table.h"
+#include "test_util.h"
+
+TEST(TranspositionTableTest, StoresAndReplaces) {
+    TranspositionTable table(4);
+    EXPECT_EQ(table.GetNumSlots(), 16);
+
+    double value = 0.0;
+    EXPECT_FALSE(table.Probe(42, value));
+    table.Store(42, 1.5);
+    ASSERT_TRUE(table.Probe(42, value));
+    EXPECT_EQ(value, 1.5);
+
+    table.Store(42, -3.25);
+    ASSERT_TRUE(table.Probe(42, value));
+    EXPECT_EQ(value, -3.25);
+
+    table.Clear();
+    EXPECT_FALSE(table.Probe(42, value));
+    EXPECT_THROW(TranspositionTable(0), std::invalid_argument);
+}
+
+TEST(ExpectimaxTest, OneTurnMatchesAdvisor) {
+    Solver solver;
+    SolveLastLayers(solver, NUM_CATEGORIES - 3);
+    ExpectedScoreObjective objective(solver.GetValues().data());
+    ExpectimaxSearch search(objective, 16);
+
+    GameState state = StateWithOpen({Category::Sixes, Category::FullHouse, Category::Chance});
+    state.SetCurrentDice(Dice({6, 6, 3, 3, 1}));
+    state.SetRemainingRerolls(2);
+
+    Advisor advisor(solver.GetValues().data());
+    Advice advice = advisor.Advise(state);
+    SearchResult result = search.Search(state, 1);
+
+    EXPECT_EQ(result.depth, 1);
+    EXPECT_FALSE(result.timed_out);
+    ASSERT_EQ(result.moves.size(), advice.moves.size());
+    for (size_t i = 0; i < advice.moves.size(); ++i) {
+        EXPECT_EQ(result.moves[i], advice.moves[i]);
+        EXPECT_NEAR(result.values[i], state.GetTotalScore() + advice.values[i], 1e-9);
+    }
+    EXPECT_EQ(result.GetBestMove(), advice.GetBestMove());
+}
+
+TEST(ExpectimaxTest, SearchToTheEndAgreesWithTable) {
+    Solver solver;
+    SolveLastLayers(solver, NUM_CATEGORIES - 2);
+    ExpectedScoreObjective objective(solver.GetValues().data());
+    ExpectimaxSearch search(objective, 18);
+
+    GameState state = StateWithOpen({Category::Yahtzee, Category::Chance});
+    state.SetCurrentDice(Dice({2, 2, 2, 5, 6}));
+    SearchResult full = search.Search(state, 5);
+    SearchResult one_turn = search.Search(state, 1);
+
+    // The table is exact, so the horizon doesn't change the values
+    EXPECT_EQ(full.depth, 2);
+    ASSERT_EQ(full.moves.size(), one_turn.moves.size());
+    for (size_t i = 0; i < full.moves.size(); ++i) {
+        EXPECT_NEAR(full.values[i], one_turn.values[i], 1e-9);
+    }
+    EXPECT_GT(full.table_hits, 0);
+}
+
+TEST(ExpectimaxTest, TargetScoreUsesPointsOnTheSheet) {
+    ThresholdSolver solver;
+    SolveLastLayers(solver, NUM_CATEGORIES - 2);
+
+    GameState state = StateWithOpen({Category::Chance, Category::LargeStraight});
+    state.AddScoreToCategory(Category::Sixes, 24);
+    state.SetCurrentDice(Dice({1, 2, 3, 4, 6}));
+    state.SetRemainingRerolls(1);
+
+    // 24 points on the sheet, 40 more are needed
+    TargetScoreObjective objective(solver, 64);
+    ExpectimaxSearch search(objective, 18);
+    SearchResult exact = search.Search(state, 2);
+    SearchResult leaves = search.Search(state, 1);
+
+    EXPECT_EQ(exact.depth, 2);
+    for (size_t i = 0; i < exact.moves.size(); ++i) {
+        EXPECT_GE(exact.values[i], 0.0);
+        EXPECT_LE(exact.values[i], 1.0);
+        EXPECT_NEAR(exact.values[i], leaves.values[i], 2.0 / ThresholdSolver::QUANTUM);
+    }
+    // Only a large straight reaches the target, so the chance box takes nothing now
+    EXPECT_TRUE(exact.GetBestMove().IsReroll());
+}
+
+TEST(ExpectimaxTest, PassedDeadlineStillAnswers) {
+    Solver solver;
+    SolveLastLayers(solver, NUM_CATEGORIES - 2);
+    ExpectedScoreObjective objective(solver.GetValues().data());
+    ExpectimaxSearch search(objective, 16);
+
+    GameState state = StateWithOpen({Category::Twos, Category::Chance});
+    state.SetCurrentDice(Dice({1, 1, 2, 5, 6}));
+    SearchResult result = search.Search(state, 3, ExpectimaxSearch::Clock::now());
+
+    EXPECT_EQ(result.depth, 0);
+    EXPECT_TRUE(result.timed_out);
+    ASSERT_FALSE(result.moves.empty());
+    EXPECT_LT(result.best, result.moves.size());
+    EXPECT_GT(result.GetBestValue(), 0.0);
+
+    EXPECT_THROW(search.Search(StateWithOpen({Category::Ones}), 1), std::invalid_argument);
+}
@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+#include "solver/lazy_solver.h"
+#include "solver/solver.h"
+#include "solver/state_value_cache.h"
+#include "test_util.h"
+
+#include <thread>
+#include <vector>
+
+TEST(StateValueCacheTest, EvictsLeastRecentlyUsed) {
+    StateValueCache cache(2, 1);
+    cache.Insert(ShortStateKey::FromIndex(1), 1.0);
+    cache.Insert(ShortStateKey::FromIndex(2), 2.0);
+    EXPECT_EQ(cache.Find(ShortStateKey::FromIndex(1)), 1.0);  // 2 is now the oldest
+
+    cache.Insert(ShortStateKey::FromIndex(3), 3.0);
+    EXPECT_FALSE(cache.Find(ShortStateKey::FromIndex(2)).has_value());
+    EXPECT_EQ(cache.Find(ShortStateKey::FromIndex(1)), 1.0);
+    EXPECT_EQ(cache.Find(ShortStateKey::FromIndex(3)), 3.0);
+
+    CacheStats stats = cache.GetStats();
+    EXPECT_EQ(stats.size, 2);
+    EXPECT_EQ(stats.insertions, 3);
+    EXPECT_EQ(stats.evictions, 1);
+    EXPECT_EQ(stats.hits, 3);
+    EXPECT_EQ(stats.misses, 1);
+    EXPECT_DOUBLE_EQ(stats.HitRate(), 0.75);
+
+    cache.Clear();
+    EXPECT_EQ(cache.GetStats().size, 0);
+    EXPECT_THROW(StateValueCache(0), std::invalid_argument);
+}
+
+TEST(StateValueCacheTest, ConcurrentInsertsStayBounded) {
+    StateValueCache cache(1000, 8);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < 4; ++t) {
+        threads.emplace_back([&cache, t] {
+            for (size_t i = 0; i < 5000; ++i) {
+                ShortStateKey key = ShortStateKey::FromIndex(t * 5000 + i);
+                cache.Insert(key, static_cast<double>(key.Index()));
+                std::optional<double> found = cache.Find(key);
+                if (found) {
+                    EXPECT_EQ(*found, static_cast<double>(key.Index()));
+                }
+            }
+        });
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+    CacheStats stats = cache.GetStats();
+    EXPECT_LE(stats.size, 1000);
+    EXPECT_EQ(stats.insertions, 20000);
+    EXPECT_EQ(stats.evictions, 20000 - stats.size);
+}
+
+TEST(LazySolverTest, MatchesSolver) {
+    Solver solver;
+    for (size_t filled = NUM_CATEGORIES + 1; filled-- > NUM_CATEGORIES - 3;) {
+        solver.SolveLayer(filled);
+    }
+    LazySolver lazy;
+    for (ShortStateKey key : GetLayerStates(NUM_CATEGORIES - 3)) {
+        if (key.Index() % 97 == 0) {
+            EXPECT_DOUBLE_EQ(lazy.GetStateValue(key), solver.GetStateValue(key));
+        }
+    }
+    EXPECT_EQ(lazy.GetStateValue(ShortStateKey(ShortStateKey::FULL_MASK, 0, true)), 0.0);
+}
+
+TEST(LazySolverTest, LaterTurnsOfTheGameHitTheCache) {
+    LazySolver lazy;
+    ShortStateKey key(MaskWithOpen({Category::Ones, Category::Fours, Category::FullHouse, Category::Chance}), 20,
+                      false);
+    lazy.GetStateValue(key);
+    const size_t evaluated = lazy.GetEvaluatedStates();
+    EXPECT_GT(evaluated, 0);
+
+    // Next turn after scoring 8 in fours, then the full house
+    ShortStateKey next(key.UsedMask() | (1u << static_cast<uint32_t>(Category::Fours)), 12, false);
+    ShortStateKey after(next.UsedMask() | (1u << static_cast<uint32_t>(Category::FullHouse)), 12, false);
+    lazy.GetStateValue(next);
+    lazy.GetStateValue(after);
+    EXPECT_EQ(lazy.GetEvaluatedStates(), evaluated);
+}
+
+TEST(LazySolverTest, SmallCacheStillGivesExactValues) {
+    LazySolver roomy;
+    LazySolver tiny(8);
+    ShortStateKey key(MaskWithOpen({Category::Twos, Category::Threes, Category::Yahtzee}), 9, false);
+    EXPECT_DOUBLE_EQ(tiny.GetStateValue(key), roomy.GetStateValue(key));
+    EXPECT_LE(tiny.GetCacheStats().size, 8);
+    EXPECT_GT(tiny.GetCacheStats().evictions, 0);
+
+    // Later solves reuse the scratch table of the first, which must come back all zero
+    ShortStateKey other(MaskWithOpen({Category::Twos, Category::Sixes, Category::Chance}), 30, false);
+    EXPECT_DOUBLE_EQ(tiny.GetStateValue(other), roomy.GetStateValue(other));
+    EXPECT_DOUBLE_EQ(tiny.GetStateValue(key), roomy.GetStateValue(key));
+}
+
+TEST(LazySolverTest, WarmingFillsTheCache) {
+    LazySolver lazy;
+    ShortStateKey key(MaskWithOpen({Category::Sixes, Category::SmallStraight, Category::Chance}), 30, true);
+    lazy.Warm(key);
+    lazy.WaitForWarming();
+    const size_t evaluated = lazy.GetEvaluatedStates();
+    EXPECT_GT(evaluated, 0);
+
+    lazy.GetStateValue(key);
+    EXPECT_EQ(lazy.GetEvaluatedStates(), evaluated);
+}
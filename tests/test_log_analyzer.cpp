@@ -0,0 +1,164 @@
+#include <gtest/gtest.h>
+#include "simulation/log_analyzer.h"
+#include "game_state/game_state.h"
+#include "move/move_outcome.h"
+#include "solver/advisor.h"
+#include "test_util.h"
+
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+// With every turn-start value 0 a move is worth the points it can still make this turn
+const std::vector<double> &ZeroValues() {
+    static const std::vector<double> values(ShortStateKey::NUM_INDICES, 0.0);
+    return values;
+}
+
+// Games of random legal moves, with the loss of every decision from an Advisor
+std::string RandomGames(size_t num_games, std::vector<double> &losses, uint64_t &total_score) {
+    std::mt19937 rng(7);
+    Advisor advisor(ZeroValues().data());
+    Advice advice;
+    std::string log = "# random games\n";
+    for (size_t game = 0; game < num_games; ++game) {
+        const std::string player = game % 3 == 0 ? "alice" : "bob";
+        GameState state;
+        for (size_t turn = 0; turn < NUM_CATEGORIES; ++turn) {
+            state.SetRemainingRerolls(2);
+            state.SetCurrentDice(RollAround(DiceCounts{}, rng));
+            while (true) {
+                advisor.Advise(state, advice);
+                const size_t choice = rng() % 4 == 0 ? rng() % advice.moves.size() : advice.best;
+                const CompactMove move = advice.moves[choice];
+                losses.push_back(advice.GetBestValue() - advice.values[choice]);
+                AppendLogDecision(log, std::to_string(game), player, state.GetCurrentDice(), move);
+                MakeMove(state, move);
+                if (!move.IsReroll()) {
+                    break;
+                }
+                state.SetCurrentDice(RollAround(KEEP_TABLE.counts[move.GetKeepIndex()], rng));
+            }
+        }
+        total_score += state.GetTotalScore();
+    }
+    return log;
+}
+
+}  // namespace
+
+TEST(LogAnalyzerTest, GradesByHand) {
+    const std::string log =
+        "# game player dice move\n"
+        "1 alice 66666 s11\n"
+        "\n"
+        "2 bob 66666 s12\n"
+        "3 bob 66666 s0\n"
+        "4 bob 12345 k1234\n"
+        "4 bob 12345 s9\n";
+    LogAnalyzer analyzer(ZeroValues().data(), TableLayout::ShortStateKeyDense, 1);
+    LogAnalysis analysis = analyzer.Analyze(log, true);
+
+    EXPECT_EQ(analysis.games, 4u);
+    EXPECT_EQ(analysis.decisions, 5u);
+    EXPECT_EQ(analysis.invalid_games, 0u);
+    ASSERT_EQ(analysis.grades.size(), 5u);
+    EXPECT_EQ(analysis.grades[0].offset, log.find("1 alice"));
+    EXPECT_FLOAT_EQ(analysis.grades[0].ev_loss, 0.0f);   // yahtzee
+    EXPECT_FLOAT_EQ(analysis.grades[1].ev_loss, 20.0f);  // 30 in chance
+    EXPECT_FLOAT_EQ(analysis.grades[2].ev_loss, 50.0f);  // nothing in ones
+    EXPECT_GT(analysis.grades[3].ev_loss, 0.0f);         // broke a large straight
+    EXPECT_FLOAT_EQ(analysis.grades[4].ev_loss, 10.0f);  // small straight over large
+
+    ASSERT_EQ(analysis.players.size(), 2u);
+    EXPECT_EQ(analysis.players[0].name, "alice");
+    EXPECT_EQ(analysis.players[0].decisions, 1u);
+    EXPECT_EQ(analysis.players[0].suboptimal_decisions, 0u);
+    EXPECT_EQ(analysis.players[1].name, "bob");
+    EXPECT_EQ(analysis.players[1].games, 3u);
+    EXPECT_EQ(analysis.players[1].completed_games, 0u);
+    EXPECT_EQ(analysis.players[1].suboptimal_decisions, 4u);
+    EXPECT_DOUBLE_EQ(analysis.players[1].max_ev_loss, 50.0);
+}
+
+TEST(LogAnalyzerTest, MatchesAdvisorAcrossBlocksAndThreads) {
+    std::vector<double> losses;
+    uint64_t total_score = 0;
+    const size_t num_games = 3000;
+    const std::string log = RandomGames(num_games, losses, total_score);
+    ASSERT_GT(log.size(), 2 * LogAnalyzer::BLOCK_BYTES);
+
+    LogAnalyzer analyzer(ZeroValues().data(), TableLayout::ShortStateKeyDense, 3);
+    LogAnalysis analysis = analyzer.Analyze(log, true);
+    EXPECT_EQ(analysis.games, num_games);
+    EXPECT_EQ(analysis.invalid_games, 0u);
+    ASSERT_EQ(analysis.grades.size(), losses.size());
+    double total_loss = 0.0;
+    for (size_t i = 0; i < losses.size(); ++i) {
+        EXPECT_NEAR(analysis.grades[i].ev_loss, losses[i], 1e-4);
+        if (i > 0) {
+            EXPECT_LT(analysis.grades[i - 1].offset, analysis.grades[i].offset);
+        }
+        total_loss += losses[i];
+    }
+
+    uint64_t completed = 0;
+    uint64_t score = 0;
+    double analyzed_loss = 0.0;
+    for (const PlayerStats &player : analysis.players) {
+        completed += player.completed_games;
+        score += player.total_score;
+        analyzed_loss += player.total_ev_loss;
+    }
+    EXPECT_EQ(completed, num_games);
+    EXPECT_EQ(score, total_score);
+    EXPECT_NEAR(analyzed_loss, total_loss, 1e-6 * losses.size());
+}
+
+TEST(LogAnalyzerTest, SkipsInvalidGames) {
+    const std::string log =
+        "1 alice 6666 s11\n"          // four dice
+        "2 alice 12345 k66\n"         // keeps dice it does not have
+        "3 alice 12345 s13\n"         // no such category
+        "4 alice 12345 k\n"
+        "4 alice 12222 k2222\n"
+        "4 alice 22222 k22222\n"
+        "4 alice 22222 s1\n"          // third reroll
+        "5 alice 12345 k12\n"
+        "5 alice 34566 s12\n"         // dropped the kept dice
+        "6 alice 12345 k\n"
+        "6 bob 12345 s12\n"           // another player
+        "7 alice 12345 s12\n"
+        "7 alice 12345 s12\n";        // used category
+    LogAnalyzer analyzer(ZeroValues().data(), TableLayout::ShortStateKeyDense, 1);
+    LogAnalysis analysis = analyzer.Analyze(log, true);
+    EXPECT_EQ(analysis.invalid_games, 7u);
+    EXPECT_EQ(analysis.games, 0u);
+    EXPECT_TRUE(analysis.grades.empty());
+}
+
+TEST(LogAnalyzerTest, AnalyzesMappedFiles) {
+    const std::string path = "log_analyzer_test.log";
+    std::vector<double> losses;
+    uint64_t total_score = 0;
+    const std::string log = RandomGames(50, losses, total_score);
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << log;
+    }
+    LogAnalyzer analyzer(ZeroValues().data(), TableLayout::ShortStateKeyDense, 2);
+    LogAnalysis from_file = analyzer.AnalyzeFile(path);
+    LogAnalysis from_memory = analyzer.Analyze(log);
+    EXPECT_EQ(from_file.decisions, losses.size());
+    EXPECT_EQ(from_file.decisions, from_memory.decisions);
+    EXPECT_TRUE(from_file.grades.empty());
+
+    { std::ofstream truncate(path, std::ios::binary | std::ios::trunc); }
+    EXPECT_EQ(analyzer.AnalyzeFile(path).games, 0u);
+    std::remove(path.c_str());
+    EXPECT_THROW(analyzer.AnalyzeFile(path), std::runtime_error);
+}
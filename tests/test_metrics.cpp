@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+#include "metrics/metrics.h"
+#include "move/move_list.h"
+#include "move/move_outcome.h"
+#include "solver/solver.h"
+
+#include <thread>
+
+// Runs in both builds: with YAHTZEE_METRICS the counts show up, without it everything stays zero
+TEST(MetricsTest, CountsCallsAndSolvedStates) {
+    ResetMetrics();
+    GameState state;
+    state.SetCurrentDice(Dice{1, 2, 3, 4, 6});
+    MoveList moves;
+    for (size_t i = 0; i < 3; ++i) {
+        GetPossibleMoves(state, moves);
+    }
+    ApplyMove(state, Move(ScoreMove(Category::Chance)));
+    Solver solver;
+    solver.SolveLayer(NUM_CATEGORIES, 1);
+    solver.SolveLayer(NUM_CATEGORIES - 1, 1);
+    // Counts of threads that are gone stay in the totals
+    std::thread([] { CountMetric(MetricCounter::PolicyLookups, 5); }).join();
+
+    const MetricsSnapshot metrics = GetMetrics();
+    EXPECT_EQ(metrics.enabled, METRICS_ENABLED);
+    const uint64_t on = METRICS_ENABLED ? 1 : 0;
+    EXPECT_EQ(metrics.Get(MetricCounter::GetPossibleMovesCalls), 3 * on);
+    EXPECT_EQ(metrics.Get(MetricCounter::ApplyMoveCalls), on);
+    EXPECT_EQ(metrics.Get(MetricCounter::MakeMoveCalls), on);
+    EXPECT_EQ(metrics.Get(MetricCounter::PolicyLookups), 5 * on);
+    const uint64_t states = GetLayerStates(NUM_CATEGORIES).size() + GetLayerStates(NUM_CATEGORIES - 1).size();
+    EXPECT_EQ(metrics.Get(MetricCounter::SolvedStates), states * on);
+    EXPECT_EQ(metrics.Get(MetricCounter::TurnEvaluations), states * on);
+    EXPECT_EQ(metrics.Get(MetricHistogram::SolveLayerNanoseconds).count, 2 * on);
+    if (METRICS_ENABLED) {
+        EXPECT_GT(metrics.GetSolvedStatesPerSecond(), 0.0);
+    }
+
+    ResetMetrics();
+    EXPECT_EQ(GetMetrics().Get(MetricCounter::SolvedStates), 0u);
+    EXPECT_EQ(GetMetrics().Get(MetricCounter::PolicyLookups), 0u);
+}
+
+TEST(MetricsTest, HistogramBuckets) {
+    EXPECT_EQ(HistogramSnapshot::GetBucketLimit(0), 0u);
+    EXPECT_EQ(HistogramSnapshot::GetBucketLimit(1), 1u);
+    EXPECT_EQ(HistogramSnapshot::GetBucketLimit(10), 1023u);
+    EXPECT_EQ(HistogramSnapshot::GetBucketLimit(HistogramSnapshot::NUM_BUCKETS - 1), UINT64_MAX);
+
+    HistogramSnapshot histogram;
+    EXPECT_EQ(histogram.GetQuantile(0.5), 0u);
+    histogram.buckets[3] = 90;  // 4-7
+    histogram.buckets[10] = 10;  // 512-1023
+    histogram.count = 100;
+    histogram.sum = 90 * 5 + 10 * 600;
+    EXPECT_EQ(histogram.GetQuantile(0.5), 7u);
+    EXPECT_EQ(histogram.GetQuantile(0.9), 7u);
+    EXPECT_EQ(histogram.GetQuantile(0.99), 1023u);
+    EXPECT_DOUBLE_EQ(histogram.GetMean(), 64.5);
+}
+
+TEST(MetricsTest, DumpsJsonAndPrometheus) {
+    MetricsSnapshot metrics;
+    metrics.enabled = true;
+    metrics.counters[static_cast<size_t>(MetricCounter::StateCacheHits)] = 3;
+    metrics.counters[static_cast<size_t>(MetricCounter::StateCacheMisses)] = 1;
+    HistogramSnapshot &latency = metrics.histograms[static_cast<size_t>(MetricHistogram::AdvisorQueryNanoseconds)];
+    latency.buckets[2] = 2;
+    latency.buckets[4] = 1;
+    latency.count = 3;
+    latency.sum = 14;
+    EXPECT_DOUBLE_EQ(metrics.GetStateCacheHitRate(), 0.75);
+    EXPECT_EQ(metrics.GetTranspositionHitRate(), 0.0);
+
+    const std::string json = MetricsToJson(metrics);
+    EXPECT_EQ(json.front(), '{');
+    EXPECT_EQ(json.back(), '}');
+    EXPECT_NE(json.find("\"enabled\":true"), std::string::npos);
+    EXPECT_NE(json.find("\"state_cache_hits\":3"), std::string::npos);
+    EXPECT_NE(json.find("\"state_cache_hit_rate\":0.75"), std::string::npos);
+    EXPECT_NE(json.find("\"advisor_query_nanoseconds\":{\"count\":3,\"sum\":14"), std::string::npos);
+    EXPECT_NE(json.find("\"buckets\":[{\"le\":3,\"count\":2},{\"le\":15,\"count\":1}]"), std::string::npos);
+
+    const std::string text = MetricsToPrometheus(metrics);
+    EXPECT_NE(text.find("# TYPE yahtzee_state_cache_hits_total counter\nyahtzee_state_cache_hits_total 3\n"),
+              std::string::npos);
+    EXPECT_NE(text.find("yahtzee_state_cache_hit_rate 0.75\n"), std::string::npos);
+    // Cumulative buckets up to the last value, then +Inf
+    EXPECT_NE(text.find("yahtzee_advisor_query_nanoseconds_bucket{le=\"3\"} 2\n"
+                        "yahtzee_advisor_query_nanoseconds_bucket{le=\"7\"} 2\n"
+                        "yahtzee_advisor_query_nanoseconds_bucket{le=\"15\"} 3\n"
+                        "yahtzee_advisor_query_nanoseconds_bucket{le=\"+Inf\"} 3\n"),
+              std::string::npos);
+    EXPECT_NE(text.find("yahtzee_advisor_query_nanoseconds_count 3\n"), std::string::npos);
+}
@@ -272,3 +272,30 @@ TEST(MoveTest, GetPossibleMovesWithPartialDice) {
     // Should have 2^3 = 8 reroll moves + 13 score moves
     EXPECT_EQ(moves.size(), 8 + 13);
 }
+
+TEST(MoveTest, GetPossibleMovesJokerRuleLowerFilled) {
+    GameState state;
+
+    // Yahtzee recorded, Sixes and the whole lower section filled
+    for (size_t i = static_cast<size_t>(Category::ThreeOfAKind);
+         i <= static_cast<size_t>(Category::Chance); ++i) {
+        state.AddScoreToCategory(static_cast<Category>(i), 0);
+    }
+    state.AddScoreToCategory(Category::Yahtzee, 50);
+    state.AddScoreToCategory(Category::Sixes, 30);
+    state.AddScoreToCategory(Category::Ones, 3);
+    state.SetCurrentDice(Dice({6, 6, 6, 6, 6}));
+
+    // Only the open upper categories are left
+    auto moves = GetPossibleMoves(state);
+    size_t score_moves_count = 0;
+    for (const auto& move : moves) {
+        if (std::holds_alternative<ScoreMove>(move)) {
+            score_moves_count++;
+            Category category = std::get<ScoreMove>(move).GetCategory();
+            EXPECT_LT(static_cast<size_t>(category), static_cast<size_t>(Category::Sixes));
+            EXPECT_NE(category, Category::Ones);
+        }
+    }
+    EXPECT_EQ(score_moves_count, 4);
+}
@@ -0,0 +1,55 @@
+#include <gtest/gtest.h>
+#include "move/move_list.h"
+#include "move/move.h"
+#include "game_state/game_state.h"
+#include "game_state/short_game_state.h"
+
+#include <set>
+
+TEST(MoveListTest, CompactMoveRoundTrip) {
+    CompactMove reroll = CompactMove::Reroll(17);
+    EXPECT_TRUE(reroll.IsReroll());
+    EXPECT_EQ(reroll.GetKeepIndex(), 17);
+
+    CompactMove score = CompactMove::Score(Category::Chance);
+    EXPECT_FALSE(score.IsReroll());
+    EXPECT_EQ(score.GetCategory(), Category::Chance);
+    EXPECT_EQ(sizeof(CompactMove), 2);
+
+    Move move = CompactMove::Reroll(Dice({2, 5, 5}).keep_index()).ToMove();
+    ASSERT_TRUE(std::holds_alternative<RerrolMove>(move));
+    EXPECT_EQ(std::get<RerrolMove>(move).GetKeepValues(), (std::vector<size_t>{2, 5, 5}));
+}
+
+TEST(MoveListTest, MatchesMoveVector) {
+    GameState state;
+    state.AddScoreToCategory(Category::Fours, 8);
+    state.SetCurrentDice(Dice({1, 1, 3, 4, 4}));
+
+    MoveList list;
+    GetPossibleMoves(state, list);
+    auto moves = GetPossibleMoves(state);
+    ASSERT_EQ(list.size(), moves.size());
+
+    // 3 * 2 * 3 distinct keeps + 12 open categories
+    EXPECT_EQ(list.size(), 18 + 12);
+    std::set<uint16_t> distinct;
+    for (size_t i = 0; i < list.size(); ++i) {
+        distinct.insert(list[i].Value());
+        Move adapted = list[i].ToMove();
+        EXPECT_EQ(adapted.index(), moves[i].index());
+    }
+    EXPECT_EQ(distinct.size(), list.size());
+}
+
+TEST(MoveListTest, JokerMask) {
+    ShortGameState state;
+    state.AddScoreToCategory(Category::Yahtzee, 50);
+    state.SetCurrentDice(Dice({2, 2, 2, 2, 2}));
+    EXPECT_EQ(GetScoreMoveMask(state), 1u << static_cast<size_t>(Category::Twos));
+
+    state.AddScoreToCategory(Category::Twos, 4);
+    uint32_t mask = GetScoreMoveMask(state);
+    EXPECT_EQ(mask & 0x3F, 0u);
+    EXPECT_TRUE(mask & (1u << static_cast<size_t>(Category::LargeStraight)));
+}
@@ -92,9 +92,22 @@ TEST(MoveOutcomeTest, ApplyScoreMoveJokerRule) {
     ScoreMove move(Category::Fours);
     auto outcome = ApplyMove(state, move);
     
-    EXPECT_EQ(outcome.score_delta, 20); // Four fours = 20 points
+    // Five fours = 20 points in the box, the yahtzee bonus on top
+    EXPECT_EQ(outcome.score_delta, 20 + YAHTZEE_BONUS);
     EXPECT_TRUE(outcome.new_state.GetCategoryScore(Category::Fours).has_value());
     EXPECT_EQ(outcome.new_state.GetCategoryScore(Category::Fours).value(), 20);
+    EXPECT_EQ(outcome.new_state.GetYahtzeeBonusCount(), 1);
+    EXPECT_EQ(outcome.new_state.GetTotalScore(), 50 + 20 + YAHTZEE_BONUS);
+}
+
+TEST(MoveOutcomeTest, ScratchedYahtzeeEarnsNoBonus) {
+    GameState state;
+    state.AddScoreToCategory(Category::Yahtzee, 0);
+    state.SetCurrentDice(Dice({4, 4, 4, 4, 4}));
+
+    auto outcome = ApplyMove(state, ScoreMove(Category::Fours));
+    EXPECT_EQ(outcome.score_delta, 20);
+    EXPECT_EQ(outcome.new_state.GetYahtzeeBonusCount(), 0);
 }
 
 TEST(MoveOutcomeTest, ApplyRerrolMove) {
@@ -134,4 +147,107 @@ TEST(MoveOutcomeTest, ApplyMoveInvalidCategory) {
     EXPECT_EQ(outcome.score_delta, 0); // No three of a kind
     EXPECT_TRUE(outcome.new_state.GetCategoryScore(Category::ThreeOfAKind).has_value());
     EXPECT_EQ(outcome.new_state.GetCategoryScore(Category::ThreeOfAKind).value(), 0);
-}
\ No newline at end of file
+}
+
+TEST(MoveOutcomeTest, UpperBonusAwardedOnce) {
+    GameState state;
+    state.AddScoreToCategory(Category::Sixes, 30);
+    state.AddScoreToCategory(Category::Fives, 25);
+    state.AddScoreToCategory(Category::Fours, 20);
+    // Bonus already reached, scoring more upper points gives no second bonus
+
+    Dice dice({3, 3, 3, 1, 2});
+    state.SetCurrentDice(dice);
+
+    auto outcome = ApplyMove(state, ScoreMove(Category::Threes));
+    EXPECT_EQ(outcome.score_delta, 9);
+}
+
+TEST(MoveOutcomeTest, ShortGameStateUpperBonus) {
+    GameState full_state;
+    full_state.AddScoreToCategory(Category::Fives, 25);
+    full_state.AddScoreToCategory(Category::Fours, 20);
+    ShortGameState state(full_state);
+    EXPECT_EQ(state.GetRemainingUpperBonus(), 18);
+
+    Dice dice({6, 6, 6, 2, 2});
+    state.SetCurrentDice(dice);
+
+    auto outcome = ApplyMove(state, ScoreMove(Category::Sixes));
+    EXPECT_EQ(outcome.score_delta, 18 + 35);
+    EXPECT_EQ(outcome.new_state.GetRemainingUpperBonus(), 0);
+
+    // Missing the bonus only lowers the remainder
+    auto miss = ApplyMove(state, ScoreMove(Category::Twos));
+    EXPECT_EQ(miss.score_delta, 4);
+    EXPECT_EQ(miss.new_state.GetRemainingUpperBonus(), 14);
+}
+
+TEST(MoveOutcomeTest, MakeUnmakeRestoresGameState) {
+    GameState state;
+    state.AddScoreToCategory(Category::Sixes, 30);
+    state.AddScoreToCategory(Category::Fives, 25);
+    state.AddScoreToCategory(Category::Yahtzee, 50);
+    state.SetCurrentDice(Dice({4, 4, 4, 4, 4}));
+    state.SetRemainingRerolls(1);
+    const GameState before = state;
+
+    MoveList moves;
+    GetPossibleMoves(state, moves);
+    ASSERT_GT(moves.size(), 0);
+    for (size_t i = 0; i < moves.size(); ++i) {
+        const MoveOutcome<GameState> expected = ApplyMove(before, moves[i].ToMove());
+        UndoToken<GameState> token = MakeMove(state, moves[i]);
+        EXPECT_EQ(token.score_delta, expected.score_delta);
+        EXPECT_EQ(state.GetSheet(), expected.new_state.GetSheet());
+        EXPECT_EQ(state.GetRemainingRerolls(), expected.new_state.GetRemainingRerolls());
+
+        UnmakeMove(state, token);
+        EXPECT_EQ(state.GetSheet(), before.GetSheet());
+        EXPECT_EQ(state.GetRemainingRerolls(), before.GetRemainingRerolls());
+        EXPECT_EQ(state.GetCurrentDice().roll_index(), before.GetCurrentDice().roll_index());
+    }
+}
+
+TEST(MoveOutcomeTest, MakeUnmakeNestedShortGameState) {
+    ShortGameState state;
+    state.SetCurrentDice(Dice({3, 3, 3, 2, 2}));
+    const ShortStateKey start = state.GetKey();
+
+    // Two moves in a row, undone in reverse order
+    auto first = MakeMove(state, Move(ScoreMove(Category::Threes)));
+    EXPECT_EQ(first.score_delta, 9);
+    auto second = MakeMove(state, Move(ScoreMove(Category::FullHouse)));
+    EXPECT_EQ(second.score_delta, 25);
+    EXPECT_TRUE(state.IsCategoryUsed(Category::Threes));
+    EXPECT_TRUE(state.IsCategoryUsed(Category::FullHouse));
+    EXPECT_EQ(state.GetRemainingUpperBonus(), UPPER_BONUS_THRESHOLD - 9);
+
+    UnmakeMove(state, second);
+    EXPECT_FALSE(state.IsCategoryUsed(Category::FullHouse));
+    EXPECT_TRUE(state.IsCategoryUsed(Category::Threes));
+    UnmakeMove(state, first);
+    EXPECT_EQ(state.GetKey(), start);
+
+    auto reroll = MakeMove(state, CompactMove::Reroll(0));
+    EXPECT_EQ(reroll.score_delta, 0);
+    EXPECT_EQ(state.GetRemainingRerolls(), 1);
+    UnmakeMove(state, reroll);
+    EXPECT_EQ(state.GetRemainingRerolls(), 2);
+}
+
+TEST(MoveOutcomeTest, MakeMoveKeepsYahtzeeBonusOnSheet) {
+    GameState state;
+    state.AddScoreToCategory(Category::Yahtzee, 50);
+    state.SetCurrentDice(Dice({5, 5, 5, 5, 5}));
+    const GameState before = state;
+
+    auto token = MakeMove(state, CompactMove::Score(Category::Yahtzee));
+    EXPECT_EQ(token.score_delta, 150);
+    EXPECT_EQ(state.GetYahtzeeBonusCount(), 1);
+    EXPECT_EQ(state.GetTotalScore(), 200);
+
+    UnmakeMove(state, token);
+    EXPECT_EQ(state.GetYahtzeeBonusCount(), 0);
+    EXPECT_EQ(state.GetSheet(), before.GetSheet());
+}
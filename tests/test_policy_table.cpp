@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+#include "move/move_outcome.h"
+#include "simulation/log_analyzer.h"
+#include "solver/advisor.h"
+#include "solver/policy_table.h"
+#include "solver/solver.h"
+#include "test_util.h"
+
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+// First layer of EndgameSolver
+constexpr size_t MIN_FILLED = NUM_CATEGORIES - 2;
+
+}  // namespace
+
+TEST(PolicyTableTest, EncodesEveryMoveInAByte) {
+    for (size_t roll = 0; roll < NUM_ROLLS; ++roll) {
+        const auto sub_keeps = SUB_KEEP_TABLE.GetRow(static_cast<KeepIndex>(KEEP_OFFSETS[NUM_DICE] + roll));
+        for (KeepIndex keep : sub_keeps) {
+            const CompactMove move = CompactMove::Reroll(keep);
+            const uint8_t code = PolicyTable::EncodeMove(move, static_cast<RollIndex>(roll));
+            EXPECT_LT(code, PolicyTable::FIRST_SCORE);
+            EXPECT_EQ(PolicyTable::DecodeMove(code, static_cast<RollIndex>(roll)), move);
+        }
+        if (sub_keeps.size() < PolicyTable::FIRST_SCORE) {
+            EXPECT_THROW(PolicyTable::DecodeMove(static_cast<uint8_t>(sub_keeps.size()), static_cast<RollIndex>(roll)),
+                         std::out_of_range);
+        }
+    }
+    const CompactMove chance = CompactMove::Score(Category::Chance);
+    EXPECT_EQ(PolicyTable::DecodeMove(PolicyTable::EncodeMove(chance, 0), 0), chance);
+    EXPECT_THROW(PolicyTable::DecodeMove(PolicyTable::NO_MOVE, 0), std::out_of_range);
+    // Keeping three sixes is not part of a roll of ones
+    EXPECT_THROW(PolicyTable::EncodeMove(CompactMove::Reroll(Dice({6, 6, 6}).keep_index()), 0),
+                 std::invalid_argument);
+}
+
+// One byte per decision is 400 MB for the reachable layout, so only one policy gets built
+TEST(PolicyTableTest, MatchesAdvisor) {
+    const std::string strategy_path = "policy_table_test.bin";
+    const std::string policy_path = GetPolicyPath(strategy_path);
+    const std::vector<double> &values = EndgameSolver().GetValues();
+    WriteStrategyFile(strategy_path, values.data(), values.size(), RuleVariant::Yahtzee,
+                      TableLayout::ShortStateKeyReachable);
+    {
+        StrategyTable strategy(strategy_path);
+        {
+            const std::vector<uint8_t> policy = BuildPolicy(strategy.GetValues(), strategy.GetLayout(), 2, MIN_FILLED);
+            ASSERT_EQ(policy.size(), ReachableIndex::NUM_REACHABLE * PolicyTable::DECISIONS_PER_STATE);
+            WritePolicyFile(policy_path, policy, strategy.GetLayout());
+            EXPECT_THROW(WritePolicyFile(policy_path, policy), std::invalid_argument);
+        }
+
+        PolicyTable table(policy_path);
+        ASSERT_TRUE(table.IsOpen());
+        EXPECT_TRUE(table.VerifyChecksum());
+        EXPECT_EQ(table.GetHeader().element_type, static_cast<uint32_t>(ElementType::Policy8));
+        EXPECT_EQ(table.GetLayout(), TableLayout::ShortStateKeyReachable);
+
+        Advisor advisor(values.data());
+        Advisor with_policy(strategy.GetValues(), strategy.GetLayout(), &table);
+        Advice advice;
+        for (size_t filled : {MIN_FILLED, NUM_CATEGORIES - 1}) {
+            for (const GameState &state : SampleGameStates(300, filled)) {
+                advisor.Advise(state, advice);
+                EXPECT_EQ(table.GetBestMove(state), advice.GetBestMove());
+                EXPECT_EQ(with_policy.GetBestMove(state), advice.GetBestMove());
+                EXPECT_EQ(advisor.GetBestMove(state), advice.GetBestMove());
+            }
+        }
+        // Earlier states were left out, finished ones have no move
+        const GameState early = SampleGameStates(1, 3)[0];
+        EXPECT_THROW(table.GetBestMove(early), std::out_of_range);
+        EXPECT_FALSE(table.FindBestMove(early).has_value());
+        // The advisor evaluates those itself
+        EXPECT_EQ(with_policy.GetBestMove(early), advisor.GetBestMove(early));
+        EXPECT_THROW(table.GetBestMove(ShortStateKey(ShortStateKey::FULL_MASK, 0, false), 0, 0), std::out_of_range);
+        // The table holds two rerolls per turn, a third is evaluated
+        GameState extra_reroll = SampleGameStates(1, NUM_CATEGORIES - 1)[0];
+        extra_reroll.SetRemainingRerolls(TurnEvaluator::MAX_REROLLS);
+        EXPECT_THROW(table.GetBestMove(extra_reroll), std::out_of_range);
+        EXPECT_FALSE(table.FindBestMove(extra_reroll).has_value());
+        EXPECT_EQ(with_policy.GetBestMove(extra_reroll), advisor.GetBestMove(extra_reroll));
+
+        // Log grades take the best move from the policy in the endgame and
+        // evaluate the earlier turns
+        std::mt19937 rng(23);
+        std::string log;
+        for (size_t game = 0; game < 40; ++game) {
+            GameState state;
+            for (size_t turn = 0; turn < NUM_CATEGORIES; ++turn) {
+                state.SetRemainingRerolls(2);
+                state.SetCurrentDice(RollAround(DiceCounts{}, rng));
+                while (true) {
+                    advisor.Advise(state, advice);
+                    const CompactMove move = advice.moves[rng() % 3 == 0 ? rng() % advice.moves.size() : advice.best];
+                    AppendLogDecision(log, std::to_string(game), "alice", state.GetCurrentDice(), move);
+                    MakeMove(state, move);
+                    if (!move.IsReroll()) {
+                        break;
+                    }
+                    state.SetCurrentDice(RollAround(KEEP_TABLE.counts[move.GetKeepIndex()], rng));
+                }
+            }
+        }
+        const LogAnalysis evaluated = LogAnalyzer(strategy.GetValues(), strategy.GetLayout(), 1).Analyze(log, true);
+        const LogAnalysis looked_up =
+            LogAnalyzer(strategy.GetValues(), strategy.GetLayout(), 1, &table).Analyze(log, true);
+        EXPECT_EQ(looked_up.invalid_games, 0u);
+        ASSERT_EQ(looked_up.grades.size(), evaluated.grades.size());
+        for (size_t i = 0; i < evaluated.grades.size(); ++i) {
+            EXPECT_NEAR(looked_up.grades[i].ev_loss, evaluated.grades[i].ev_loss, 1e-4);
+        }
+        EXPECT_EQ(looked_up.players[0].suboptimal_decisions, evaluated.players[0].suboptimal_decisions);
+
+        EXPECT_THROW(StrategyTable policy_as_values(policy_path), std::runtime_error);
+        EXPECT_THROW(PolicyTable values_as_policy(strategy_path), std::runtime_error);
+    }
+    std::remove(strategy_path.c_str());
+    std::remove(policy_path.c_str());
+}
@@ -0,0 +1,307 @@
+#include <gtest/gtest.h>
+#include "solver/quantized_table.h"
+#include "solver/advisor.h"
+#include "solver/policy_table.h"
+#include "solver/strategy_file.h"
+#include "game_state/dice_index.h"
+#include "game_state/short_game_state.h"
+#include "test_util.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <optional>
+#include <random>
+#include <vector>
+
+namespace {
+
+// Smooth like turn-start values, with a little noise
+std::vector<double> MakeValues(size_t count) {
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<double> noise(0.0, 0.5);
+    std::vector<double> values(count);
+    for (size_t i = 0; i < count; ++i) {
+        values[i] = 250.0 * static_cast<double>(count - i) / static_cast<double>(count) + noise(rng);
+    }
+    return values;
+}
+
+// Points of the best score of every roll decide; any state value added to
+// the successors of one category moves decisions towards it
+std::vector<double> ValuesFavoring(Category category, double bonus) {
+    std::vector<double> values(ShortStateKey::NUM_INDICES, 0.0);
+    for (size_t index = 0; index < values.size(); ++index) {
+        if (ShortStateKey::FromIndex(index).IsCategoryUsed(category)) {
+            values[index] = bonus;
+        }
+    }
+    return values;
+}
+
+// A sheet of the key with zeros in the lower boxes, or nothing when the
+// greedy scores of the upper boxes miss its remainder
+std::optional<GameState> StateOfKey(ShortStateKey key) {
+    const uint32_t remaining = key.RemainingUpperBonus();
+    const auto threshold = static_cast<uint32_t>(UPPER_BONUS_THRESHOLD);
+    uint32_t left = remaining > 0 ? threshold - remaining : threshold;
+    GameState state;
+    for (size_t face = NUM_UPPER_CATEGORIES; face-- > 0;) {
+        const auto category = static_cast<Category>(face);
+        if (key.IsCategoryUsed(category)) {
+            const uint32_t count = remaining > 0 ? std::min<uint32_t>(NUM_DICE, left / (face + 1)) : NUM_DICE;
+            const uint32_t score = count * static_cast<uint32_t>(face + 1);
+            state.AddScoreToCategory(category, score);
+            left -= std::min(left, score);
+        }
+    }
+    for (size_t index = NUM_UPPER_CATEGORIES; index < NUM_CATEGORIES; ++index) {
+        const auto category = static_cast<Category>(index);
+        if (key.IsCategoryUsed(category)) {
+            state.AddScoreToCategory(category, category == Category::Yahtzee && key.IsYahtzeeRecorded() ? 50 : 0);
+        }
+    }
+    if (ShortGameState(state).GetKey() != key) {
+        return std::nullopt;
+    }
+    return state;
+}
+
+}  // namespace
+
+TEST(QuantizedTableTest, EncodingsRoundTrip) {
+    const size_t count = 10 * QuantizedTable::BLOCK_VALUES + 17;
+    const std::vector<double> values = MakeValues(count);
+    for (ElementType element_type : {ElementType::Fixed16, ElementType::Float16, ElementType::DeltaRice}) {
+        const std::vector<unsigned char> data = EncodeQuantizedValues(values.data(), count, element_type);
+        QuantizedTable table(data.data(), data.size(), element_type, count);
+        ASSERT_TRUE(table.IsOpen());
+        EXPECT_EQ(table.GetNumBlocks(), 11u);
+
+        std::vector<double> decoded;
+        table.Decode(decoded);
+        ASSERT_EQ(decoded.size(), count);
+        double max_error = 0.0;
+        for (size_t i = 0; i < count; ++i) {
+            max_error = std::max(max_error, std::abs(decoded[i] - values[i]));
+            EXPECT_EQ(table.GetValue(i), decoded[i]);
+        }
+        EXPECT_EQ(max_error, table.GetInfo().max_error);
+        EXPECT_THROW(table.GetValue(count), std::out_of_range);
+        EXPECT_THROW(table.GetHeader(), std::logic_error);
+
+        double block[QuantizedTable::BLOCK_VALUES];
+        EXPECT_EQ(table.DecodeBlock(10, block), 17u);
+        EXPECT_EQ(block[16], decoded[count - 1]);
+    }
+}
+
+TEST(QuantizedTableTest, ErrorsFollowTheEncoding) {
+    const std::vector<double> values = MakeValues(4096);
+    auto max_error = [&](ElementType element_type, double step) {
+        const std::vector<unsigned char> data =
+            EncodeQuantizedValues(values.data(), values.size(), element_type, step);
+        return QuantizedTable(data.data(), data.size(), element_type, values.size()).GetInfo().max_error;
+    };
+    // Half a step of 250.5 / 65535, half of the float16 spacing of 128-256, half of 2^-12
+    EXPECT_LE(max_error(ElementType::Fixed16, 0.0), 0.5 * 250.5 / 65535 + 1e-12);
+    EXPECT_LE(max_error(ElementType::Float16, 0.0), 0.0625);
+    EXPECT_GT(max_error(ElementType::Float16, 0.0), 0.01);
+    EXPECT_LE(max_error(ElementType::DeltaRice, 0.0), std::ldexp(0.5, -12));
+    EXPECT_LE(max_error(ElementType::DeltaRice, 1e-6), 0.5e-6);
+
+    // Differences of the smooth values take far fewer bits than their codes
+    const std::vector<unsigned char> delta =
+        EncodeQuantizedValues(values.data(), values.size(), ElementType::DeltaRice);
+    EXPECT_LT(delta.size(), values.size() * sizeof(uint16_t));
+
+    EXPECT_THROW(EncodeQuantizedValues(values.data(), values.size(), ElementType::Float64), std::invalid_argument);
+    EXPECT_THROW(EncodeQuantizedValues(values.data(), values.size(), ElementType::Fixed16, 1e-3),
+                 std::invalid_argument);
+    EXPECT_THROW(EncodeQuantizedValues(values.data(), values.size(), ElementType::Float16, 1.0),
+                 std::invalid_argument);
+    const double negative = -1.0;
+    EXPECT_THROW(EncodeQuantizedValues(&negative, 1, ElementType::DeltaRice), std::invalid_argument);
+}
+
+TEST(QuantizedTableTest, WritesAndMapsFiles) {
+    const std::string path = "quantized_table_test.bin";
+    std::vector<double> values(ShortStateKey::NUM_INDICES);
+    for (size_t i = 0; i < values.size(); ++i) {
+        values[i] = static_cast<double>(i % 1000) * 0.25;
+    }
+    const ShortStateKey key(0x803, 60, true);  // ones, twos and a yahtzee
+    ASSERT_TRUE(IsReachable(key));
+    for (ElementType element_type : {ElementType::Fixed16, ElementType::Float16, ElementType::DeltaRice}) {
+        WriteStrategyFile(path, values.data(), values.size(), RuleVariant::Yahtzee,
+                          TableLayout::ShortStateKeyReachable, element_type);
+        {
+            QuantizedTable table(path);
+            ASSERT_TRUE(table.IsOpen());
+            EXPECT_TRUE(table.VerifyChecksum());
+            EXPECT_EQ(table.GetHeader().element_type, static_cast<uint32_t>(element_type));
+            EXPECT_EQ(table.GetLayout(), TableLayout::ShortStateKeyReachable);
+            EXPECT_EQ(table.GetNumValues(), ReachableIndex::NUM_REACHABLE);
+            EXPECT_LT(table.GetDataSize(), ReachableIndex::NUM_REACHABLE * sizeof(double) / 3);
+            EXPECT_NEAR(table.GetStateValue(key), values[key.Index()], table.GetInfo().max_error);
+            EXPECT_NEAR(table.GetStateValue(ShortStateKey()), values[ShortStateKey().Index()],
+                        table.GetInfo().max_error);
+            EXPECT_THROW(StrategyTable strategy(path), std::runtime_error);
+        }
+    }
+    // Corrections follow the codes of any encoding
+    const size_t offset = ReachableIndex::Offset(key, TableLayout::ShortStateKeyReachable);
+    const std::vector<uint64_t> corrections = {
+        (offset * PolicyTable::DECISIONS_PER_STATE + 7) << 8 | 3,
+        (offset * PolicyTable::DECISIONS_PER_STATE + 9) << 8 | (PolicyTable::FIRST_SCORE + 12)};
+    for (ElementType element_type : {ElementType::Fixed16, ElementType::Float16, ElementType::DeltaRice}) {
+        WriteStrategyFile(path, values.data(), values.size(), RuleVariant::Yahtzee,
+                          TableLayout::ShortStateKeyReachable, element_type, corrections);
+        QuantizedTable table(path);
+        EXPECT_TRUE(table.VerifyChecksum());
+        EXPECT_EQ(table.GetNumCorrections(), corrections.size());
+        EXPECT_EQ(table.GetCorrection(key, 7), 3);
+        EXPECT_EQ(table.GetCorrection(key, 8), QuantizedTable::NO_CORRECTION);
+        EXPECT_EQ(table.GetCorrection(key, 9), PolicyTable::FIRST_SCORE + 12);
+        EXPECT_EQ(table.GetCorrection(ShortStateKey(), 7), QuantizedTable::NO_CORRECTION);
+        EXPECT_NEAR(table.GetStateValue(key), values[key.Index()], table.GetInfo().max_error);
+    }
+    EXPECT_THROW(WriteStrategyFile(path, values.data(), values.size(), RuleVariant::Yahtzee,
+                                   TableLayout::ShortStateKeyReachable, ElementType::Float64, corrections),
+                 std::invalid_argument);
+    WriteStrategyFile(path, values.data(), values.size());
+    EXPECT_THROW(QuantizedTable table(path), std::runtime_error);
+    std::remove(path.c_str());
+}
+
+TEST(QuantizedTableTest, ComparesDecisions) {
+    const std::vector<double> exact(ShortStateKey::NUM_INDICES, 0.0);
+    const size_t stride = 1001;
+
+    QuantizationReport same =
+        CompareDecisions(exact.data(), exact.data(), exact.size(), TableLayout::ShortStateKeyDense, 2, stride);
+    EXPECT_GT(same.decisions, 0u);
+    EXPECT_EQ(same.decisions % (3 * NUM_ROLLS), 0u);
+    EXPECT_EQ(same.changed_decisions, 0u);
+    EXPECT_EQ(same.max_ev_error, 0.0);
+    EXPECT_GT(same.min_decision_gap, DECISION_TOLERANCE);
+
+    // Errors below half the smallest gap leave the best moves alone, large ones favor chance
+    const double error = same.min_decision_gap / 4;
+    const std::vector<double> small = ValuesFavoring(Category::Chance, error);
+    QuantizationReport report = CompareDecisions(exact.data(), small.data(), exact.size(),
+                                                 TableLayout::ShortStateKeyDense, 2, stride);
+    EXPECT_EQ(report.decisions, same.decisions);
+    EXPECT_EQ(report.changed_decisions, 0u);
+    EXPECT_DOUBLE_EQ(report.max_ev_error, error);
+
+    const std::vector<double> large = ValuesFavoring(Category::Chance, 20.0);
+    report = CompareDecisions(exact.data(), large.data(), exact.size(), TableLayout::ShortStateKeyDense, 2, stride);
+    EXPECT_GT(report.changed_decisions, 0u);
+    EXPECT_LE(report.max_decision_loss, 20.0 + 1e-9);
+
+    EXPECT_THROW(CompareDecisions(exact.data(), exact.data(), 10), std::invalid_argument);
+}
+
+TEST(QuantizedTableTest, CorrectionsRestoreTheBestMoves) {
+    std::mt19937 rng(9);
+    std::uniform_real_distribution<double> noise(0.0, 5.0);
+    std::vector<double> exact(ShortStateKey::NUM_INDICES);
+    for (double &value : exact) {
+        value = noise(rng);
+    }
+    const size_t stride = 2003;
+    const double step = 0.5;
+
+    const std::vector<unsigned char> plain =
+        EncodeQuantizedValues(exact.data(), exact.size(), ElementType::Fixed16, step);
+    const QuantizedTable plain_table(plain.data(), plain.size(), ElementType::Fixed16, exact.size());
+    std::vector<double> decoded;
+    plain_table.Decode(decoded);
+    std::vector<uint64_t> corrections;
+    const QuantizationReport report = CompareDecisions(exact.data(), decoded.data(), exact.size(),
+                                                       TableLayout::ShortStateKeyDense, 2, stride, &corrections);
+    ASSERT_EQ(corrections.size(), report.changed_decisions);
+    ASSERT_GT(report.changed_decisions, 0u);
+    EXPECT_TRUE(std::is_sorted(corrections.begin(), corrections.end()));
+
+    const std::vector<unsigned char> data =
+        EncodeQuantizedValues(exact.data(), exact.size(), ElementType::Fixed16, step, corrections);
+    const QuantizedTable table(data.data(), data.size(), ElementType::Fixed16, exact.size());
+    EXPECT_EQ(plain_table.GetNumCorrections(), 0u);
+    EXPECT_EQ(table.GetNumCorrections(), corrections.size());
+    EXPECT_EQ(table.GetValue(12345), plain_table.GetValue(12345));
+    // Gaps and move bytes take far less than a word per correction
+    EXPECT_LT(data.size() - plain.size(), corrections.size() * 4);
+    for (uint64_t correction : corrections) {
+        const uint64_t position = correction >> 8;
+        const ShortStateKey key = ShortStateKey::FromIndex(position / PolicyTable::DECISIONS_PER_STATE);
+        ASSERT_EQ(table.GetCorrection(key, position % PolicyTable::DECISIONS_PER_STATE), correction & 0xFFu);
+        if (position % PolicyTable::DECISIONS_PER_STATE > 0) {
+            const uint8_t before = table.GetCorrection(key, position % PolicyTable::DECISIONS_PER_STATE - 1);
+            EXPECT_TRUE(before == QuantizedTable::NO_CORRECTION ||
+                        std::binary_search(corrections.begin(), corrections.end(), (position - 1) << 8 | before));
+        }
+    }
+
+    // The advisors read the quantized values in place; the exact one tells
+    // what their moves are worth
+    Advisor exact_advisor(exact.data());
+    Advisor plain_advisor(plain_table);
+    Advisor corrected_advisor(table);
+    Advice advice;
+    const auto exact_value = [&advice](CompactMove move) {
+        for (size_t i = 0; i < advice.moves.size(); ++i) {
+            if (advice.moves[i] == move) {
+                return advice.values[i];
+            }
+        }
+        return -1.0;
+    };
+    size_t states = 0;
+    size_t changed = 0;
+    size_t reachable = 0;
+    for (size_t index = 0; index < ShortStateKey::NUM_INDICES; ++index) {
+        const ShortStateKey key = ShortStateKey::FromIndex(index);
+        if (!IsReachable(key) || key.IsGameOver() || reachable++ % stride != 0) {
+            continue;
+        }
+        std::optional<GameState> state = StateOfKey(key);
+        if (!state) {
+            continue;
+        }
+        ++states;
+        for (size_t rerolls = 0; rerolls <= TurnEvaluator::TURN_REROLLS; ++rerolls) {
+            state->SetRemainingRerolls(rerolls);
+            for (size_t roll = 0; roll < NUM_ROLLS; ++roll) {
+                state->SetCurrentDice(Dice::from_roll_index(static_cast<RollIndex>(roll)));
+                exact_advisor.Advise(*state, advice);
+                const double best = advice.GetBestValue();
+                changed += exact_value(plain_advisor.GetBestMove(*state)) < best - DECISION_TOLERANCE ? 1 : 0;
+                ASSERT_GE(exact_value(corrected_advisor.GetBestMove(*state)), best - DECISION_TOLERANCE);
+            }
+        }
+    }
+    EXPECT_GT(states, 50u);
+    EXPECT_GT(changed, 0u);
+
+    // With three rerolls left the decision would be that of the next state
+    GameState extra_reroll = StateWithOpen({Category::Ones, Category::Chance});
+    extra_reroll.SetRemainingRerolls(TurnEvaluator::MAX_REROLLS);
+    extra_reroll.SetCurrentDice(Dice({1, 1, 1, 1, 1}));
+    const CompactMove chance = CompactMove::Score(Category::Chance);
+    const uint64_t next_state_decision = (ShortGameState(extra_reroll).GetKey().Index() + 1) *
+                                             PolicyTable::DECISIONS_PER_STATE +
+                                         extra_reroll.GetCurrentDice().roll_index();
+    const std::vector<uint64_t> aliased = {next_state_decision << 8 | PolicyTable::EncodeMove(chance, 0)};
+    const std::vector<unsigned char> aliased_data =
+        EncodeQuantizedValues(exact.data(), exact.size(), ElementType::Fixed16, step, aliased);
+    const QuantizedTable aliased_table(aliased_data.data(), aliased_data.size(), ElementType::Fixed16, exact.size());
+    Advisor aliased_advisor(aliased_table);
+    ASSERT_NE(plain_advisor.GetBestMove(extra_reroll), chance);
+    EXPECT_EQ(aliased_advisor.GetBestMove(extra_reroll), plain_advisor.GetBestMove(extra_reroll));
+
+    const std::vector<uint64_t> unsorted = {corrections[1], corrections[0]};
+    EXPECT_THROW(EncodeQuantizedValues(exact.data(), exact.size(), ElementType::Fixed16, step, unsorted),
+                 std::invalid_argument);
+}
@@ -0,0 +1,51 @@
+#include <gtest/gtest.h>
+#include "move/reroll_matrix.h"
+#include "move/move_outcome.h"
+#include "game_state/dice.h"
+
+TEST(RerollMatrixTest, RowsAreDistributions) {
+    for (size_t keep = 0; keep < NUM_KEEPS; ++keep) {
+        RerollMatrix::Row row = REROLL_MATRIX.GetRow(static_cast<KeepIndex>(keep));
+        double total = 0.0;
+        for (size_t i = 0; i < row.size; ++i) {
+            total += row.probabilities[i];
+            if (i > 0) {
+                EXPECT_LT(row.rolls[i - 1], row.rolls[i]);
+            }
+            // Every outcome still contains the kept dice
+            for (size_t face = 0; face < NUM_FACES; ++face) {
+                EXPECT_GE(ROLL_TABLE.counts[row.rolls[i]][face], KEEP_TABLE.counts[keep][face]);
+            }
+        }
+        EXPECT_NEAR(total, 1.0, 1e-12);
+    }
+}
+
+TEST(RerollMatrixTest, RowSizes) {
+    EXPECT_EQ(REROLL_MATRIX.GetRow(Dice().keep_index()).size, NUM_ROLLS);
+    EXPECT_EQ(REROLL_MATRIX.GetRow(Dice({3}).keep_index()).size, 126);
+    EXPECT_EQ(REROLL_MATRIX.GetRow(Dice({1, 2, 3, 4}).keep_index()).size, 6);
+
+    RerollMatrix::Row all = REROLL_MATRIX.GetRow(Dice({1, 2, 3, 4, 5}).keep_index());
+    ASSERT_EQ(all.size, 1);
+    EXPECT_EQ(all.rolls[0], Dice({1, 2, 3, 4, 5}).roll_index());
+    EXPECT_DOUBLE_EQ(all.probabilities[0], 1.0);
+}
+
+TEST(RerollMatrixTest, EmptyKeepMatchesRollProbabilities) {
+    RerollMatrix::Row row = REROLL_MATRIX.GetRow(0);
+    for (size_t i = 0; i < row.size; ++i) {
+        EXPECT_EQ(row.rolls[i], i);
+        EXPECT_DOUBLE_EQ(row.probabilities[i], ROLL_TABLE.probability[i]);
+    }
+}
+
+TEST(RerollMatrixTest, GetRerollOutcomes) {
+    auto outcomes = GetRerollOutcomes(RerrolMove({6, 6, 6, 6}));
+    ASSERT_EQ(outcomes.size(), 6);
+    for (const auto& [dice, probability] : outcomes) {
+        EXPECT_EQ(dice.total(), 5);
+        EXPECT_GE(dice[6], 4);
+        EXPECT_NEAR(probability, 1.0 / 6.0, 1e-12);
+    }
+}
@@ -0,0 +1,192 @@
+#include <gtest/gtest.h>
+#include "game_state/rules.h"
+#include "game_state/short_game_state.h"
+#include "move/move_list.h"
+#include "move/move_outcome.h"
+#include "move/score_table.h"
+#include "solver/solver.h"
+#include "solver/turn_evaluator.h"
+#include "test_util.h"
+
+namespace {
+
+using YatzyKey = YatzyRules::StateKey;
+
+// Key with every category used except the given one
+YatzyKey YatzyKeyWithOpen(YatzyCategory open, uint32_t remaining = 0) {
+    return YatzyKey(YatzyKey::FULL_MASK & ~(uint32_t{1} << static_cast<uint32_t>(open)), remaining, false);
+}
+
+}  // namespace
+
+// The policy of the Yahtzee rules is the reference CalculateScore, partial rolls included
+TEST(RulesTest, YahtzeeScoresMatchCalculateScore) {
+    for (size_t keep = 0; keep < NUM_KEEPS; ++keep) {
+        Dice dice;
+        for (size_t face = 0; face < NUM_FACES; ++face) {
+            for (size_t die = 0; die < KEEP_TABLE.counts[keep][face]; ++die) {
+                dice.add_die(face + 1);
+            }
+        }
+        for (size_t i = 0; i < NUM_CATEGORIES; ++i) {
+            const Category category = static_cast<Category>(i);
+            EXPECT_EQ(CalculateScore<YahtzeeRules>(dice, category), CalculateScore(dice, category))
+                << "keep " << keep << ", " << CategoryToString(category);
+            EXPECT_EQ(CalculateScore<FreeJokerYahtzeeRules>(dice, category), CalculateScore(dice, category));
+        }
+    }
+    EXPECT_EQ(&SCORE_TABLE, &RULE_SCORE_TABLE<YahtzeeRules>);
+    EXPECT_EQ(RULE_JOKER_SCORE_TABLE<YatzyRules>, RULE_SCORE_TABLE<YatzyRules>);
+}
+
+TEST(RulesTest, YatzyScores) {
+    auto score = [](std::initializer_list<size_t> values, YatzyCategory category) {
+        return CalculateScore<YatzyRules>(Dice(values), category);
+    };
+    EXPECT_EQ(score({1, 1, 2, 2, 6}, YatzyCategory::OnePair), 4u);
+    EXPECT_EQ(score({1, 1, 2, 2, 6}, YatzyCategory::TwoPairs), 6u);
+    EXPECT_EQ(score({3, 3, 3, 5, 5}, YatzyCategory::FullHouse), 19u);
+    EXPECT_EQ(score({3, 3, 3, 5, 5}, YatzyCategory::ThreeOfAKind), 9u);
+    EXPECT_EQ(score({3, 3, 3, 5, 5}, YatzyCategory::OnePair), 10u);
+    EXPECT_EQ(score({1, 2, 3, 4, 5}, YatzyCategory::SmallStraight), 15u);
+    EXPECT_EQ(score({1, 2, 3, 4, 5}, YatzyCategory::LargeStraight), 0u);
+    EXPECT_EQ(score({2, 3, 4, 5, 6}, YatzyCategory::LargeStraight), 20u);
+    EXPECT_EQ(score({2, 3, 4, 5, 6}, YatzyCategory::SmallStraight), 0u);
+    // Five of a kind is one pair twice over and no full house
+    EXPECT_EQ(score({4, 4, 4, 4, 4}, YatzyCategory::Yatzy), 50u);
+    EXPECT_EQ(score({4, 4, 4, 4, 4}, YatzyCategory::FourOfAKind), 16u);
+    EXPECT_EQ(score({4, 4, 4, 4, 4}, YatzyCategory::TwoPairs), 0u);
+    EXPECT_EQ(score({4, 4, 4, 4, 4}, YatzyCategory::FullHouse), 0u);
+    EXPECT_EQ(score({6, 6}, YatzyCategory::OnePair), 12u);
+}
+
+TEST(RulesTest, FreeJokerTakesAnyOpenCategory) {
+    ShortGameState state;
+    state.AddScoreToCategory(Category::Yahtzee, 50);
+    state.SetCurrentDice(Dice({3, 3, 3, 3, 3}));
+    const uint32_t open = ShortStateKey::FULL_MASK & ~(uint32_t{1} << static_cast<uint32_t>(Category::Yahtzee));
+    EXPECT_EQ(GetScoreMoveMask(state), 1u << static_cast<size_t>(Category::Threes));
+    EXPECT_EQ((GetScoreMoveMask<ShortGameState, FreeJokerYahtzeeRules>(state)), open);
+
+    const RollIndex roll = state.GetCurrentDice().roll_index();
+    EXPECT_EQ(GetAllowedCategoryMask(state.GetKey(), roll), 1u << static_cast<size_t>(Category::Threes));
+    EXPECT_EQ(GetAllowedCategoryMask<FreeJokerYahtzeeRules>(state.GetKey(), roll), open);
+    // The joker scores the same under both rules, the yahtzee bonus included
+    EXPECT_EQ(GetScoreOutcome<FreeJokerYahtzeeRules>(state.GetKey(), roll, Category::LargeStraight).points,
+              LARGE_STRAIGHT_SCORE + YAHTZEE_BONUS);
+    EXPECT_EQ(GetScoreOutcome(state.GetKey(), roll, Category::Threes).points, 15 + YAHTZEE_BONUS);
+
+    MoveList moves;
+    GetPossibleMoves<ShortGameState, FreeJokerYahtzeeRules>(state, moves);
+    EXPECT_EQ(moves.size(), SUB_KEEP_TABLE.GetRow(state.GetCurrentDice().keep_index()).size() + NUM_CATEGORIES - 1);
+}
+
+TEST(RulesTest, YahtzeeBonusDoesNotCountTowardsUpperBonus) {
+    const ShortStateKey key(MaskWithOpen({Category::Threes, Category::Chance}), 20, true);
+    const RollIndex threes = Dice({3, 3, 3, 3, 3}).roll_index();
+    const auto outcome = GetScoreOutcome(key, threes, Category::Threes);
+    EXPECT_EQ(outcome.points, 15 + YAHTZEE_BONUS);
+    EXPECT_EQ(outcome.next.RemainingUpperBonus(), 5u);
+
+    // Without a yahtzee in its box a yahtzee roll scores plainly
+    const ShortStateKey scratched(MaskWithOpen({Category::Threes, Category::Chance}), 20, false);
+    EXPECT_EQ(GetScoreOutcome(scratched, threes, Category::Threes).points, 15u);
+}
+
+TEST(RulesTest, YatzyKeysHaveNoYahtzeeBit) {
+    EXPECT_EQ(YatzyKey::NUM_INDICES, size_t{1} << (YatzyRules::NUM_CATEGORIES + 6));
+    const YatzyKey key(0x7FFF, 63, true);
+    EXPECT_FALSE(key.IsYahtzeeRecorded());
+    EXPECT_EQ(key.RemainingUpperBonus(), 63u);
+    EXPECT_TRUE(key.IsGameOver());
+    EXPECT_FALSE(YatzyKey().IsCategoryUsed(YatzyCategory::Yatzy));
+
+    // An upper score crossing the threshold earns the Yatzy bonus of 50
+    const RollIndex sixes = Dice({6, 6, 6, 6, 1}).roll_index();
+    const auto outcome = GetScoreOutcome<YatzyRules>(YatzyKeyWithOpen(YatzyCategory::Sixes, 20), sixes,
+                                                     YatzyCategory::Sixes);
+    EXPECT_EQ(outcome.points, 24u + YatzyRules::UPPER_BONUS);
+    EXPECT_EQ(outcome.next.RemainingUpperBonus(), 0u);
+    EXPECT_TRUE(outcome.next.IsGameOver());
+}
+
+TEST(RulesTest, SolvesYatzyEndgames) {
+    BasicSolver<YatzyRules> solver;
+    for (size_t filled = YatzyRules::NUM_CATEGORIES + 1; filled-- > YatzyRules::NUM_CATEGORIES - 1;) {
+        solver.SolveLayer(filled, 1);
+    }
+    EXPECT_EQ(solver.GetValues().size(), YatzyKey::NUM_INDICES);
+    EXPECT_NEAR(solver.GetStateValue(YatzyKeyWithOpen(YatzyCategory::Chance)), 5.0 * 14.0 / 3.0, 1e-9);
+    // Five of a kind within three rolls, 4.6%
+    EXPECT_NEAR(solver.GetStateValue(YatzyKeyWithOpen(YatzyCategory::Yatzy)), 50 * 0.046028643, 1e-6);
+    EXPECT_THROW(BasicTurnEvaluator<YatzyRules>(solver.GetValues().data(), TableLayout::ShortStateKeyReachable),
+                 std::invalid_argument);
+}
+
+// Solve runs every layer of the rules, not only the 13 of Yahtzee
+TEST(RulesTest, SolvesWholeYatzyGame) {
+    BasicSolver<YatzyRules> solver;
+    solver.Solve();
+    const std::vector<LayerStats> &layers = solver.GetLayerStats();
+    ASSERT_EQ(layers.size(), YatzyRules::NUM_CATEGORIES + 1);
+    EXPECT_EQ(layers.front().filled_count, YatzyRules::NUM_CATEGORIES);
+    EXPECT_NEAR(solver.GetStateValue(YatzyKeyWithOpen(YatzyCategory::Chance)), 5.0 * 14.0 / 3.0, 1e-9);
+    EXPECT_NEAR(solver.GetStateValue(YatzyKey()), 248.44, 1e-4);
+}
+
+// More choice for the joker can only help
+TEST(RulesTest, FreeJokerIsWorthAtLeastTheForcedOne) {
+    Solver forced;
+    BasicSolver<FreeJokerYahtzeeRules> free;
+    for (size_t filled = NUM_CATEGORIES + 1; filled-- > NUM_CATEGORIES - 2;) {
+        forced.SolveLayer(filled, 1);
+        free.SolveLayer(filled, 1);
+    }
+    bool better = false;
+    for (size_t filled = NUM_CATEGORIES - 2; filled <= NUM_CATEGORIES; ++filled) {
+        for (ShortStateKey key : GetLayerStates(filled)) {
+            EXPECT_GE(free.GetStateValue(key), forced.GetStateValue(key) - 1e-9);
+            better = better || free.GetStateValue(key) > forced.GetStateValue(key) + 1e-9;
+        }
+    }
+    EXPECT_TRUE(better);
+}
+
+TEST(RulesTest, MaxiYatzyScores) {
+    auto score = [](std::initializer_list<size_t> values, MaxiYatzyCategory category) {
+        return CalculateScore<MaxiYatzyNoSavedRerollsRules>(BasicDice<SixDice>(values), category);
+    };
+    EXPECT_EQ(score({6, 6, 6, 6, 6, 1}, MaxiYatzyCategory::Sixes), 30u);
+    EXPECT_EQ(score({1, 1, 2, 2, 3, 3}, MaxiYatzyCategory::ThreePairs), 12u);
+    EXPECT_EQ(score({1, 1, 2, 2, 3, 3}, MaxiYatzyCategory::TwoPairs), 10u);
+    EXPECT_EQ(score({4, 4, 4, 4, 4, 2}, MaxiYatzyCategory::FiveOfAKind), 20u);
+    EXPECT_EQ(score({1, 2, 3, 4, 5, 5}, MaxiYatzyCategory::SmallStraight), 15u);
+    EXPECT_EQ(score({1, 2, 3, 4, 5, 6}, MaxiYatzyCategory::LargeStraight), 20u);
+    EXPECT_EQ(score({1, 2, 3, 4, 5, 6}, MaxiYatzyCategory::FullStraight), 21u);
+    EXPECT_EQ(score({1, 2, 3, 4, 5, 5}, MaxiYatzyCategory::FullStraight), 0u);
+    EXPECT_EQ(score({2, 2, 2, 5, 5, 6}, MaxiYatzyCategory::FullHouse), 16u);
+    // A full house may be split out of four of a kind and a pair
+    EXPECT_EQ(score({5, 5, 5, 5, 2, 2}, MaxiYatzyCategory::FullHouse), 19u);
+    EXPECT_EQ(score({5, 5, 5, 5, 2, 2}, MaxiYatzyCategory::Tower), 24u);
+    EXPECT_EQ(score({3, 3, 3, 6, 6, 6}, MaxiYatzyCategory::Villa), 27u);
+    EXPECT_EQ(score({3, 3, 3, 6, 6, 6}, MaxiYatzyCategory::Tower), 0u);
+    EXPECT_EQ(score({1, 1, 2, 3, 4, 6}, MaxiYatzyCategory::Chance), 17u);
+    EXPECT_EQ(score({2, 2, 2, 2, 2, 2}, MaxiYatzyCategory::MaxiYatzy), 100u);
+    EXPECT_EQ(score({2, 2, 2, 2, 2, 1}, MaxiYatzyCategory::MaxiYatzy), 0u);
+}
+
+TEST(RulesTest, MaxiYatzyKeysAndOutcomes) {
+    using MaxiKey = MaxiYatzyNoSavedRerollsRules::StateKey;
+    EXPECT_EQ(MaxiKey::NUM_INDICES, size_t{1} << (MaxiYatzyNoSavedRerollsRules::NUM_CATEGORIES + 7));
+    const MaxiKey key(MaxiKey::FULL_MASK & ~(uint32_t{1} << static_cast<uint32_t>(MaxiYatzyCategory::Sixes)), 30,
+                      false);
+    EXPECT_FALSE(key.IsCategoryUsed(MaxiYatzyCategory::Sixes));
+    EXPECT_EQ(key.RemainingUpperBonus(), 30u);
+
+    const auto roll = BasicDice<SixDice>({6, 6, 6, 6, 6, 1}).roll_index();
+    const auto outcome = GetScoreOutcome<MaxiYatzyNoSavedRerollsRules>(key, roll, MaxiYatzyCategory::Sixes);
+    EXPECT_EQ(outcome.points, 30u + MaxiYatzyNoSavedRerollsRules::UPPER_BONUS);
+    EXPECT_TRUE(outcome.next.IsGameOver());
+    EXPECT_EQ(GetAllowedCategoryMask<MaxiYatzyNoSavedRerollsRules>(key, roll),
+              uint32_t{1} << static_cast<uint32_t>(MaxiYatzyCategory::Sixes));
+}
@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+#include "game_state/game_state.h"
+#include "game_state/score_sheet.h"
+
+TEST(ScoreSheetTest, EmptySheet) {
+    ScoreSheet sheet;
+    EXPECT_EQ(sheet.GetFilledMask(), 0u);
+    EXPECT_EQ(sheet.GetUpperTotal(), 0);
+    EXPECT_EQ(sheet.GetTotalScore(), 0);
+    EXPECT_EQ(sheet.GetYahtzeeBonusCount(), 0);
+    EXPECT_EQ(sheet.GetRemainingUpperBonus(), UPPER_BONUS_THRESHOLD);
+    for (size_t i = 0; i < NUM_CATEGORIES; ++i) {
+        EXPECT_FALSE(sheet.GetCategoryScore(static_cast<Category>(i)).has_value());
+    }
+}
+
+TEST(ScoreSheetTest, TracksAggregates) {
+    ScoreSheet sheet;
+    sheet.AddScore(Category::Sixes, 24);
+    sheet.AddScore(Category::Chance, 22);
+    sheet.AddScore(Category::FullHouse, 0);
+
+    EXPECT_EQ(sheet.GetFilledMask(), (1u << 5) | (1u << 12) | (1u << 8));
+    EXPECT_EQ(sheet.GetUpperTotal(), 24);
+    EXPECT_EQ(sheet.GetTotalScore(), 46);
+    EXPECT_EQ(sheet.GetScore(Category::Chance), 22);
+    EXPECT_TRUE(sheet.IsFilled(Category::FullHouse));
+    EXPECT_EQ(sheet.GetCategoryScore(Category::FullHouse).value(), 0);
+    EXPECT_EQ(sheet.GetRemainingUpperBonus(), UPPER_BONUS_THRESHOLD - 24);
+}
+
+TEST(ScoreSheetTest, UpperBonusAddedOnce) {
+    ScoreSheet sheet;
+    sheet.AddScore(Category::Sixes, 30);
+    sheet.AddScore(Category::Fives, 25);
+    EXPECT_EQ(sheet.GetTotalScore(), 55);
+
+    sheet.AddScore(Category::Fours, 12);
+    EXPECT_EQ(sheet.GetUpperTotal(), 67);
+    EXPECT_EQ(sheet.GetRemainingUpperBonus(), 0);
+    EXPECT_EQ(sheet.GetTotalScore(), 67 + UPPER_BONUS);
+
+    sheet.AddScore(Category::Threes, 9);
+    EXPECT_EQ(sheet.GetTotalScore(), 76 + UPPER_BONUS);
+}
+
+TEST(ScoreSheetTest, YahtzeeBonuses) {
+    ScoreSheet sheet;
+    sheet.AddScore(Category::Yahtzee, 50);
+    sheet.AddYahtzeeBonus();
+    sheet.AddYahtzeeBonus();
+    EXPECT_EQ(sheet.GetYahtzeeBonusCount(), 2);
+    EXPECT_EQ(sheet.GetTotalScore(), 50 + 2 * YAHTZEE_BONUS);
+    EXPECT_EQ(sheet.GetScore(Category::Yahtzee), 50);
+}
+
+TEST(ScoreSheetTest, CapacityLimits) {
+    ScoreSheet sheet;
+    sheet.AddScore(Category::Yahtzee, 50);
+    sheet.AddScore(Category::Yahtzee, 50);
+    EXPECT_EQ(sheet.GetScore(Category::Yahtzee), 100);
+
+    EXPECT_THROW(sheet.AddScore(Category::Ones, ScoreSheet::GetCapacity(Category::Ones) + 1), std::out_of_range);
+    EXPECT_THROW(sheet.AddScore(static_cast<Category>(NUM_CATEGORIES), 1), std::out_of_range);
+    EXPECT_THROW(sheet.GetCategoryScore(static_cast<Category>(NUM_CATEGORIES)), std::out_of_range);
+
+    for (size_t i = 0; i < ScoreSheet::MAX_YAHTZEE_BONUSES; ++i) {
+        sheet.AddYahtzeeBonus();
+    }
+    EXPECT_THROW(sheet.AddYahtzeeBonus(), std::out_of_range);
+}
+
+TEST(ScoreSheetTest, GameStateStaysCompact) {
+    EXPECT_EQ(sizeof(ScoreSheet), 16u);
+
+    GameState state;
+    state.AddScoreToCategory(Category::Twos, 8);
+    state.AddScoreToCategory(Category::LargeStraight, 40);
+    EXPECT_EQ(state.GetFilledMask(), (1u << 1) | (1u << 10));
+    EXPECT_EQ(state.GetUpperTotal(), 8);
+    EXPECT_EQ(state.GetTotalScore(), 48);
+}
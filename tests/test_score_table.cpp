@@ -0,0 +1,57 @@
+#include <gtest/gtest.h>
+#include "move/score_table.h"
+#include "move/move_outcome.h"
+#include "game_state/dice.h"
+
+TEST(ScoreTableTest, MatchesCalculateScore) {
+    for (size_t roll = 0; roll < NUM_ROLLS; ++roll) {
+        Dice dice = Dice::from_roll_index(static_cast<RollIndex>(roll));
+        for (size_t i = 0; i < NUM_CATEGORIES; ++i) {
+            Category category = static_cast<Category>(i);
+            EXPECT_EQ(RollScore(static_cast<RollIndex>(roll), category), CalculateScore(dice, category))
+                << "roll " << roll << ", " << CategoryToString(category);
+        }
+    }
+}
+
+TEST(ScoreTableTest, JokerOnlyChangesYahtzeeStraights) {
+    for (size_t roll = 0; roll < NUM_ROLLS; ++roll) {
+        for (size_t i = 0; i < NUM_CATEGORIES; ++i) {
+            Category category = static_cast<Category>(i);
+            size_t base = RollScore(static_cast<RollIndex>(roll), category);
+            size_t joker = JokerRollScore(static_cast<RollIndex>(roll), category);
+            bool straight = category == Category::SmallStraight || category == Category::LargeStraight;
+            if (ROLL_TABLE.is_yahtzee[roll] && straight) {
+                EXPECT_EQ(base, 0);
+                EXPECT_GT(joker, 0);
+            } else {
+                EXPECT_EQ(base, joker);
+            }
+        }
+    }
+}
+
+TEST(ScoreTableTest, JokerScores) {
+    RollIndex roll = Dice({3, 3, 3, 3, 3}).roll_index();
+    EXPECT_EQ(JokerRollScore(roll, Category::Threes), 15);
+    EXPECT_EQ(JokerRollScore(roll, Category::FullHouse), 25);
+    EXPECT_EQ(JokerRollScore(roll, Category::SmallStraight), 30);
+    EXPECT_EQ(JokerRollScore(roll, Category::LargeStraight), 40);
+    EXPECT_EQ(JokerRollScore(roll, Category::Chance), 15);
+}
+
+TEST(ScoreTableTest, ApplyMoveScoresJokerStraight) {
+    GameState state;
+    state.AddScoreToCategory(Category::Yahtzee, 50);
+    state.AddScoreToCategory(Category::Twos, 4);
+    state.SetCurrentDice(Dice({2, 2, 2, 2, 2}));
+
+    // The joker scores the straight and earns the yahtzee bonus
+    auto outcome = ApplyMove(state, ScoreMove(Category::LargeStraight));
+    EXPECT_EQ(outcome.score_delta, 40 + YAHTZEE_BONUS);
+
+    // Without a recorded yahtzee there is no joker
+    GameState plain;
+    plain.SetCurrentDice(Dice({2, 2, 2, 2, 2}));
+    EXPECT_EQ(ApplyMove(plain, ScoreMove(Category::LargeStraight)).score_delta, 0);
+}
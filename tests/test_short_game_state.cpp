@@ -134,3 +134,20 @@ TEST(ShortGameStateTest, CategoryUsageTracking) {
     EXPECT_FALSE(state.IsCategoryUsed(Category::Yahtzee));
     EXPECT_FALSE(state.IsCategoryUsed(Category::LargeStraight));
 }
+
+TEST(ShortGameStateTest, UpperBonusTracking) {
+    ShortGameState state;
+    EXPECT_EQ(state.GetRemainingUpperBonus(), 63);
+
+    state.AddScoreToCategory(Category::Sixes, 24);
+    EXPECT_EQ(state.GetRemainingUpperBonus(), 39);
+
+    // Lower categories don't count towards the bonus
+    state.AddScoreToCategory(Category::Chance, 30);
+    EXPECT_EQ(state.GetRemainingUpperBonus(), 39);
+
+    // Remainder stops at zero
+    state.AddScoreToCategory(Category::Fives, 25);
+    state.AddScoreToCategory(Category::Fours, 20);
+    EXPECT_EQ(state.GetRemainingUpperBonus(), 0);
+}
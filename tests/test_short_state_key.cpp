@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+#include "game_state/short_state_key.h"
+#include "game_state/short_game_state.h"
+#include "game_state/game_state.h"
+
+#include <unordered_set>
+
+TEST(ShortStateKeyTest, DefaultIsGameStart) {
+    ShortStateKey key;
+    EXPECT_EQ(key.UsedMask(), 0);
+    EXPECT_EQ(key.RemainingUpperBonus(), 63);
+    EXPECT_FALSE(key.IsYahtzeeRecorded());
+    EXPECT_EQ(key.FilledCount(), 0);
+    EXPECT_FALSE(key.IsGameOver());
+    EXPECT_EQ(ShortGameState().GetKey(), key);
+}
+
+TEST(ShortStateKeyTest, FieldsRoundTrip) {
+    ShortStateKey key(0b1000000100101, 17, true);
+    EXPECT_EQ(key.UsedMask(), 0b1000000100101);
+    EXPECT_EQ(key.RemainingUpperBonus(), 17);
+    EXPECT_TRUE(key.IsYahtzeeRecorded());
+    EXPECT_EQ(key.FilledCount(), 4);
+    EXPECT_TRUE(key.IsCategoryUsed(Category::Ones));
+    EXPECT_TRUE(key.IsCategoryUsed(Category::Threes));
+    EXPECT_TRUE(key.IsCategoryUsed(Category::Sixes));
+    EXPECT_TRUE(key.IsCategoryUsed(Category::Chance));
+    EXPECT_FALSE(key.IsCategoryUsed(Category::Yahtzee));
+}
+
+TEST(ShortStateKeyTest, IndexIsDenseAndPerfect) {
+    EXPECT_EQ(ShortStateKey::NUM_INDICES, (size_t{1} << NUM_CATEGORIES) * 64 * 2);
+    EXPECT_EQ(sizeof(ShortStateKey), 4);
+
+    std::vector<bool> seen(ShortStateKey::NUM_INDICES, false);
+    for (uint32_t mask = 0; mask <= ShortStateKey::FULL_MASK; ++mask) {
+        for (uint32_t remaining = 0; remaining <= 63; ++remaining) {
+            for (bool yahtzee : {false, true}) {
+                ShortStateKey key(mask, remaining, yahtzee);
+                ASSERT_LT(key.Index(), ShortStateKey::NUM_INDICES);
+                EXPECT_FALSE(seen[key.Index()]);
+                seen[key.Index()] = true;
+                EXPECT_EQ(ShortStateKey::FromIndex(key.Index()), key);
+            }
+        }
+    }
+}
+
+TEST(ShortStateKeyTest, MatchesShortGameState) {
+    GameState full_state;
+    full_state.AddScoreToCategory(Category::Twos, 6);
+    full_state.AddScoreToCategory(Category::Yahtzee, 50);
+    full_state.AddScoreToCategory(Category::Chance, 21);
+
+    ShortGameState state(full_state);
+    ShortStateKey key = state.GetKey();
+    EXPECT_EQ(key.UsedMask(), (1u << 1) | (1u << 11) | (1u << 12));
+    EXPECT_EQ(key.RemainingUpperBonus(), 57);
+    EXPECT_TRUE(key.IsYahtzeeRecorded());
+
+    ShortGameState restored(key);
+    EXPECT_EQ(restored.GetKey(), key);
+    EXPECT_TRUE(restored.IsCategoryUsed(Category::Twos));
+    EXPECT_FALSE(restored.IsCategoryUsed(Category::Threes));
+    EXPECT_EQ(restored.GetRemainingUpperBonus(), 57);
+    EXPECT_TRUE(restored.IsYahtzeeRecorded());
+    EXPECT_EQ(restored.GetRemainingRerolls(), 2);
+}
+
+TEST(ShortStateKeyTest, HashSpreadsKeys) {
+    std::unordered_set<ShortStateKey> keys;
+    for (uint32_t mask = 0; mask < 256; ++mask) {
+        keys.insert(ShortStateKey(mask, mask % 64, mask & 1));
+    }
+    EXPECT_EQ(keys.size(), 256);
+    EXPECT_TRUE(keys.count(ShortStateKey(3, 3, true)));
+    EXPECT_NE(ShortStateKeyHash{}(ShortStateKey(0, 0, false)), ShortStateKeyHash{}(ShortStateKey(1, 0, false)));
+}
@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+#include "simulation/simulator.h"
+#include "simulation/philox.h"
+#include "solver/solver.h"
+#include "test_util.h"
+
+#include <memory>
+#include <numeric>
+
+namespace {
+
+Simulator::PolicyFactory Greedy() {
+    return [] { return std::make_unique<GreedyPolicy>(); };
+}
+
+}  // namespace
+
+TEST(PhiloxTest, KnownAnswers) {
+    // Reference vectors of the Random123 library
+    EXPECT_EQ(Philox4x32::Generate({0, 0, 0, 0}, 0),
+              (Philox4x32::Block{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}));
+    EXPECT_EQ(Philox4x32::Generate({0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff}, ~uint64_t{0}),
+              (Philox4x32::Block{0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}));
+}
+
+TEST(PhiloxTest, StreamsAreIndependentAndRepeatable) {
+    Philox4x32 first(42, 0);
+    Philox4x32 again(42, 0);
+    Philox4x32 other(42, 1);
+    size_t same_as_other = 0;
+    for (int i = 0; i < 100; ++i) {
+        uint32_t value = first();
+        EXPECT_EQ(value, again());
+        same_as_other += value == other() ? 1 : 0;
+    }
+    EXPECT_LT(same_as_other, 2u);
+}
+
+TEST(PhiloxTest, UniformDiceAreFair) {
+    Philox4x32 rng(7, 0);
+    std::array<size_t, 6> counts{};
+    for (int i = 0; i < 60000; ++i) {
+        uint32_t face = rng.Uniform(6);
+        ASSERT_LT(face, 6u);
+        ++counts[face];
+    }
+    for (size_t count : counts) {
+        EXPECT_NEAR(static_cast<double>(count), 10000.0, 500.0);
+    }
+}
+
+TEST(SimulatorTest, GreedyGamesFillTheSheet) {
+    Simulator simulator(Greedy(), 2);
+    SimulationStats stats = simulator.Run(GameState(), 2000, 1);
+    EXPECT_EQ(stats.num_games, 2000u);
+    EXPECT_EQ(std::accumulate(stats.score_histogram.begin(), stats.score_histogram.end(), uint64_t{0}), 2000u);
+    EXPECT_EQ(std::accumulate(stats.yahtzee_bonus_histogram.begin(), stats.yahtzee_bonus_histogram.end(),
+                              uint64_t{0}), 2000u);
+    // One roll per category: chance always scores, yahtzees are rare
+    EXPECT_EQ(stats.GetCategoryFillRate(Category::Chance), 1.0);
+    EXPECT_LT(stats.GetCategoryFillRate(Category::Yahtzee), 0.2);
+    EXPECT_GT(stats.GetMeanScore(), 100.0);
+    EXPECT_LT(stats.GetMeanScore(), 200.0);
+    EXPECT_LE(stats.GetUpperBonusRate(), 1.0);
+}
+
+TEST(SimulatorTest, ReproducibleForAnyThreadCount) {
+    Simulator single(Greedy(), 1);
+    Simulator multi(Greedy(), 4);
+    SimulationStats a = single.Run(GameState(), 1000, 123);
+    SimulationStats b = multi.Run(GameState(), 1000, 123);
+    SimulationStats c = multi.Run(GameState(), 1000, 124);
+    EXPECT_EQ(a.score_histogram, b.score_histogram);
+    EXPECT_EQ(a.category_scored, b.category_scored);
+    EXPECT_EQ(a.yahtzee_bonus_histogram, b.yahtzee_bonus_histogram);
+    EXPECT_NE(a.score_histogram, c.score_histogram);
+}
+
+TEST(SimulatorTest, CountsPointsAlreadyOnTheSheet) {
+    GameState start = StateWithOpen({Category::Chance});
+    start.AddScoreToCategory(Category::Sixes, 30);
+    start.AddScoreToCategory(Category::Fives, 25);
+    start.AddScoreToCategory(Category::Fours, 20);
+    Simulator simulator(Greedy(), 1);
+    SimulationStats stats = simulator.Run(start, 200, 5);
+    // 75 upper points with the bonus, plus a chance of 5 to 30
+    for (size_t score = 0; score < stats.score_histogram.size(); ++score) {
+        if (stats.score_histogram[score] > 0) {
+            EXPECT_GE(score, 110u + 5u);
+            EXPECT_LE(score, 110u + 30u);
+        }
+    }
+    EXPECT_EQ(stats.GetUpperBonusRate(), 1.0);
+}
+
+TEST(SimulatorTest, OptimalPolicyMatchesSolverValue) {
+    Solver solver;
+    solver.SolveLayer(NUM_CATEGORIES);
+    solver.SolveLayer(NUM_CATEGORIES - 1);
+    const double *values = solver.GetValues().data();
+
+    Simulator simulator([values] { return std::make_unique<OptimalPolicy>(values); }, 2);
+    GameState start = StateWithOpen({Category::Chance});
+    SimulationStats stats = simulator.Run(start, 20000, 9);
+    // Standard error of the mean is about 0.03
+    EXPECT_NEAR(stats.GetMeanScore(), solver.GetStateValue(ShortGameState(start)), 0.15);
+}
+
+TEST(SimulatorTest, RejectsInvalidPolicyChoice) {
+    struct BadPolicy : Policy {
+        size_t ChooseMove(const GameState &, const MoveList &moves) override { return moves.size(); }
+    };
+    BadPolicy policy;
+    Philox4x32 rng(0, 0);
+    SimulationStats stats;
+    EXPECT_THROW(Simulator::PlayGame(GameState(), policy, rng, stats), std::out_of_range);
+}
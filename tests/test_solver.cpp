@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+#include "solver/solver.h"
+#include "game_state/game_state.h"
+#include "game_state/short_game_state.h"
+#include "test_util.h"
+
+TEST(SolverTest, FullSheetIsWorthNothing) {
+    Solver solver;
+    SolveLastLayers(solver, NUM_CATEGORIES);
+    EXPECT_DOUBLE_EQ(solver.GetStateValue(ShortGameState(StateWithOpen({}))), 0.0);
+}
+
+TEST(SolverTest, ChanceOnly) {
+    Solver solver;
+    SolveLastLayers(solver, NUM_CATEGORIES - 1);
+    // Each die is kept on 5-6 after the first roll and on 4-6 after the second
+    double value = solver.GetStateValue(ShortGameState(StateWithOpen({Category::Chance})));
+    EXPECT_NEAR(value, 5.0 * 14.0 / 3.0, 1e-9);
+}
+
+TEST(SolverTest, YahtzeeOnly) {
+    Solver solver;
+    SolveLastLayers(solver, NUM_CATEGORIES - 1);
+    // Probability of a yahtzee within three rolls is about 4.6%
+    double value = solver.GetStateValue(ShortGameState(StateWithOpen({Category::Yahtzee})));
+    EXPECT_NEAR(value, 50.0 * 0.046029, 1e-4);
+}
+
+TEST(SolverTest, SixesOnlyWithBonusReached) {
+    Solver solver;
+    SolveLastLayers(solver, NUM_CATEGORIES - 1);
+    GameState state = StateWithOpen({Category::Sixes});
+    state.AddScoreToCategory(Category::Fives, 25);
+    state.AddScoreToCategory(Category::Fours, 20);
+    state.AddScoreToCategory(Category::Threes, 15);
+    state.AddScoreToCategory(Category::Twos, 10);
+    // Every die independently ends up a six with probability 1 - (5/6)^3
+    double value = solver.GetStateValue(ShortGameState(state));
+    EXPECT_NEAR(value, 30.0 * 91.0 / 216.0, 1e-9);
+}
+
+TEST(SolverTest, SixesOnlyWithBonusPending) {
+    Solver solver;
+    SolveLastLayers(solver, NUM_CATEGORIES - 1);
+    GameState reached = StateWithOpen({Category::Sixes});
+    reached.AddScoreToCategory(Category::Fives, 25);
+    reached.AddScoreToCategory(Category::Fours, 20);
+    reached.AddScoreToCategory(Category::Threes, 15);
+    reached.AddScoreToCategory(Category::Twos, 10);
+
+    GameState pending = StateWithOpen({Category::Sixes});
+    pending.AddScoreToCategory(Category::Fives, 25);
+    pending.AddScoreToCategory(Category::Fours, 20);
+    // 18 points (three sixes) are still missing for the bonus
+    double reached_value = solver.GetStateValue(ShortGameState(reached));
+    double pending_value = solver.GetStateValue(ShortGameState(pending));
+    EXPECT_GT(pending_value, reached_value);
+    EXPECT_LT(pending_value, reached_value + UPPER_BONUS);
+}
+
+TEST(SolverTest, LayersAgreeWithOneCategoryAtATime) {
+    Solver solver;
+    SolveLastLayers(solver, NUM_CATEGORIES - 2);
+    double chance = solver.GetStateValue(ShortGameState(StateWithOpen({Category::Chance})));
+    double yahtzee = solver.GetStateValue(ShortGameState(StateWithOpen({Category::Yahtzee})));
+    double both = solver.GetStateValue(ShortGameState(StateWithOpen({Category::Chance, Category::Yahtzee})));
+    // Two turns are worth at least two independent single-category games
+    EXPECT_GE(both, chance + yahtzee);
+    EXPECT_LT(both, 50.0 + 30.0);
+}
+
+TEST(SolverTest, ThreadCountDoesNotChangeValues) {
+    Solver single;
+    Solver multi;
+    for (size_t filled = NUM_CATEGORIES + 1; filled-- > NUM_CATEGORIES - 2;) {
+        single.SolveLayer(filled, 1);
+        multi.SolveLayer(filled, 4);
+    }
+    ShortGameState state(StateWithOpen({Category::Ones, Category::FullHouse}));
+    EXPECT_DOUBLE_EQ(single.GetStateValue(state), multi.GetStateValue(state));
+}
+
+TEST(SolverTest, RecordsLayerStats) {
+    Solver solver;
+    solver.SolveLayer(NUM_CATEGORIES, 3);
+    solver.SolveLayer(NUM_CATEGORIES - 1, 3);
+    const auto &layers = solver.GetLayerStats();
+    ASSERT_EQ(layers.size(), 2u);
+    EXPECT_EQ(layers[0].filled_count, NUM_CATEGORIES);
+    // The full sheet with and without a recorded yahtzee, every upper remainder
+    EXPECT_EQ(layers[0].num_states, 2u * (UPPER_BONUS_THRESHOLD + 1));
+    EXPECT_EQ(layers[1].filled_count, NUM_CATEGORIES - 1);
+    EXPECT_EQ(layers[1].num_threads, 3u);
+    EXPECT_GE(layers[1].imbalance, 1.0);
+}
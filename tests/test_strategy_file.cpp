@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+#include "solver/strategy_file.h"
+#include "solver/advisor.h"
+
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
+static std::vector<double> MakeValues() {
+    std::vector<double> values(ShortStateKey::NUM_INDICES);
+    for (size_t i = 0; i < values.size(); ++i) {
+        values[i] = static_cast<double>(i % 1000) * 0.25;
+    }
+    return values;
+}
+
+TEST(StrategyFileTest, WriteAndMap) {
+    const std::string path = "strategy_file_test.bin";
+    std::vector<double> values = MakeValues();
+    WriteStrategyFile(path, values.data(), values.size());
+
+    {
+        StrategyTable table(path);
+        ASSERT_TRUE(table.IsOpen());
+        const StrategyFileHeader& header = table.GetHeader();
+        EXPECT_EQ(header.version, StrategyFileHeader::VERSION);
+        EXPECT_EQ(header.rule_variant, static_cast<uint32_t>(RuleVariant::Yahtzee));
+        EXPECT_EQ(header.layout, static_cast<uint32_t>(TableLayout::ShortStateKeyDense));
+        EXPECT_EQ(header.element_type, static_cast<uint32_t>(ElementType::Float64));
+        EXPECT_EQ(header.num_elements, ShortStateKey::NUM_INDICES);
+        EXPECT_EQ(header.data_offset % 4096, 0u);
+        EXPECT_TRUE(table.VerifyChecksum());
+
+        ShortStateKey key(0x155, 20, true);
+        EXPECT_DOUBLE_EQ(table.GetStateValue(key), values[key.Index()]);
+        EXPECT_DOUBLE_EQ(table.GetStateValue(ShortStateKey()), values[ShortStateKey().Index()]);
+
+        StrategyTable moved = std::move(table);
+        EXPECT_FALSE(table.IsOpen());
+        EXPECT_DOUBLE_EQ(moved.GetStateValue(key), values[key.Index()]);
+    }
+    std::remove(path.c_str());
+}
+
+TEST(StrategyFileTest, RejectsBadFiles) {
+    EXPECT_THROW(StrategyTable("missing_strategy_file.bin"), std::runtime_error);
+
+    const std::string path = "strategy_file_bad.bin";
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << "definitely not a strategy table, but long enough to hold a header......";
+    }
+    EXPECT_THROW(StrategyTable table(path), std::runtime_error);
+
+    // Flipping a header byte breaks the header checksum
+    std::vector<double> values = MakeValues();
+    WriteStrategyFile(path, values.data(), values.size());
+    {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(offsetof(StrategyFileHeader, rule_variant));
+        file.put(7);
+    }
+    EXPECT_THROW(StrategyTable table(path), std::runtime_error);
+
+    EXPECT_THROW(WriteStrategyFile(path, values.data(), 10), std::invalid_argument);
+    std::remove(path.c_str());
+}
+
+TEST(StrategyFileTest, ChecksumDetectsDataChanges) {
+    const std::string path = "strategy_file_data.bin";
+    std::vector<double> values = MakeValues();
+    WriteStrategyFile(path, values.data(), values.size());
+    {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(4096 + 12345);
+        file.put(42);
+    }
+    {
+        StrategyTable table(path);
+        EXPECT_FALSE(table.VerifyChecksum());
+    }
+    std::remove(path.c_str());
+}
+
+TEST(StrategyFileTest, ReachableLayoutLeavesOutImpossibleStates) {
+    const std::string path = "strategy_file_reachable.bin";
+    std::vector<double> values = MakeValues();
+    WriteStrategyFile(path, values.data(), values.size(), RuleVariant::Yahtzee, TableLayout::ShortStateKeyReachable);
+    {
+        StrategyTable table(path);
+        const StrategyFileHeader &header = table.GetHeader();
+        EXPECT_EQ(header.layout, static_cast<uint32_t>(TableLayout::ShortStateKeyReachable));
+        EXPECT_EQ(header.num_elements, ReachableIndex::NUM_REACHABLE);
+        EXPECT_EQ(table.GetLayout(), TableLayout::ShortStateKeyReachable);
+        EXPECT_TRUE(table.VerifyChecksum());
+
+        for (size_t i = 0; i < values.size(); i += 7) {
+            ShortStateKey key = ShortStateKey::FromIndex(i);
+            if (IsReachable(key)) {
+                ASSERT_DOUBLE_EQ(table.GetStateValue(key), values[i]) << i;
+            }
+        }
+
+        // Advice from the reachable table is the advice from the dense one
+        GameState state;
+        state.AddScoreToCategory(Category::Threes, 9);
+        state.AddScoreToCategory(Category::Chance, 21);
+        state.SetCurrentDice(Dice({3, 3, 4, 5, 6}));
+        Advice dense = Advisor(values.data()).Advise(state);
+        Advice reachable = Advisor(table.GetValues(), table.GetLayout()).Advise(state);
+        ASSERT_EQ(dense.moves.size(), reachable.moves.size());
+        for (size_t i = 0; i < dense.moves.size(); ++i) {
+            EXPECT_DOUBLE_EQ(dense.values[i], reachable.values[i]);
+        }
+    }
+    std::remove(path.c_str());
+}
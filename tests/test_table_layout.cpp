@@ -0,0 +1,64 @@
+#include <gtest/gtest.h>
+#include "solver/table_layout.h"
+
+namespace {
+
+uint32_t Bit(Category category) {
+    return uint32_t{1} << static_cast<uint32_t>(category);
+}
+
+}  // namespace
+
+TEST(TableLayoutTest, UpperRemaindersOfFilledCategories) {
+    // Nothing filled: only the full remainder
+    EXPECT_EQ(UPPER_REMAINDERS[0], uint64_t{1} << UPPER_BONUS_THRESHOLD);
+
+    // Only ones: 0 to 5 points
+    for (uint32_t remaining = 0; remaining <= UPPER_BONUS_THRESHOLD; ++remaining) {
+        EXPECT_EQ(IsReachable(ShortStateKey(Bit(Category::Ones), remaining, false)), remaining >= 58) << remaining;
+    }
+
+    // Only sixes: multiples of 6 up to 30
+    const uint32_t sixes = Bit(Category::Sixes) | Bit(Category::Chance);
+    EXPECT_TRUE(IsReachable(ShortStateKey(sixes, UPPER_BONUS_THRESHOLD - 24, false)));
+    EXPECT_FALSE(IsReachable(ShortStateKey(sixes, UPPER_BONUS_THRESHOLD - 25, false)));
+    EXPECT_FALSE(IsReachable(ShortStateKey(sixes, UPPER_BONUS_THRESHOLD - 36, false)));
+
+    // Every upper category filled reaches every remainder
+    EXPECT_EQ(UPPER_REMAINDERS[63], ~uint64_t{0});
+
+    // The yahtzee flag needs the yahtzee box
+    EXPECT_FALSE(IsReachable(ShortStateKey(0, UPPER_BONUS_THRESHOLD, true)));
+    EXPECT_TRUE(IsReachable(ShortStateKey(Bit(Category::Yahtzee), UPPER_BONUS_THRESHOLD, true)));
+}
+
+TEST(TableLayoutTest, ReachableIndexIsDenseAndOrdered) {
+    size_t next = 0;
+    for (size_t i = 0; i < ShortStateKey::NUM_INDICES; ++i) {
+        ShortStateKey key = ShortStateKey::FromIndex(i);
+        EXPECT_EQ(ReachableIndex::Offset(key, TableLayout::ShortStateKeyDense), i);
+        if (IsReachable(key)) {
+            ASSERT_EQ(ReachableIndex::Index(key), next) << i;
+            ASSERT_EQ(ReachableIndex::Offset(key, TableLayout::ShortStateKeyReachable), next);
+            ++next;
+        }
+    }
+    EXPECT_EQ(next, ReachableIndex::NUM_REACHABLE);
+    EXPECT_LT(2 * ReachableIndex::NUM_REACHABLE, ShortStateKey::NUM_INDICES + ShortStateKey::NUM_INDICES / 20);
+}
+
+TEST(TableLayoutTest, RuleReachabilityMatchesYahtzee) {
+    for (size_t i = 0; i < ShortStateKey::NUM_INDICES; ++i) {
+        const ShortStateKey key = ShortStateKey::FromIndex(i);
+        ASSERT_EQ(IsReachable<YahtzeeRules>(key), IsReachable(key)) << i;
+    }
+
+    // Six dice put up to 36 points in one upper box
+    using MaxiRules = MaxiYatzyNoSavedRerollsRules;
+    using MaxiKey = MaxiRules::StateKey;
+    const uint32_t sixes = uint32_t{1} << static_cast<uint32_t>(MaxiYatzyCategory::Sixes);
+    EXPECT_TRUE(IsReachable<MaxiRules>(MaxiKey(sixes, MaxiRules::UPPER_BONUS_THRESHOLD - 36, false)));
+    EXPECT_FALSE(IsReachable<MaxiRules>(MaxiKey(sixes, MaxiRules::UPPER_BONUS_THRESHOLD - 35, false)));
+    EXPECT_FALSE(IsReachable<MaxiRules>(MaxiKey(sixes, MaxiRules::UPPER_BONUS_THRESHOLD - 42, false)));
+    EXPECT_TRUE(IsReachable<MaxiRules>(MaxiKey(0x3F, 0, false)));
+}
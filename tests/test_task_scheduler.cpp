@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+#include "solver/task_scheduler.h"
+
+#include <atomic>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+TEST(TaskSchedulerTest, RunsEveryItemOnce) {
+    TaskScheduler scheduler(4);
+    EXPECT_EQ(scheduler.GetNumThreads(), 4u);
+    std::vector<std::atomic<int>> visits(1003);
+    ParallelForStats stats = scheduler.ParallelFor(visits.size(), 10, [&](size_t begin, size_t end, size_t worker) {
+        EXPECT_LT(worker, 4u);
+        EXPECT_LE(end - begin, 10u);
+        for (size_t i = begin; i < end; ++i) {
+            ++visits[i];
+        }
+    });
+    for (const auto &count : visits) {
+        EXPECT_EQ(count, 1);
+    }
+    EXPECT_EQ(std::accumulate(stats.chunks.begin(), stats.chunks.end(), size_t{0}), 101u);
+    EXPECT_EQ(stats.busy_seconds.size(), 4u);
+    EXPECT_GE(stats.Imbalance(), 1.0);
+}
+
+TEST(TaskSchedulerTest, IdleWorkersStealUnevenWork) {
+    TaskScheduler scheduler(4);
+    std::atomic<size_t> sum{0};
+    // All the work sits in the range of worker 0, the others have to steal it
+    ParallelForStats stats = scheduler.ParallelFor(400, 1, [&](size_t begin, size_t, size_t) {
+        if (begin < 100) {
+            volatile double x = 0;
+            for (int i = 0; i < 20000; ++i) {
+                x = x + i;
+            }
+        }
+        sum += begin;
+    });
+    EXPECT_EQ(sum, 400u * 399u / 2);
+    EXPECT_EQ(std::accumulate(stats.chunks.begin(), stats.chunks.end(), size_t{0}), 400u);
+}
+
+TEST(TaskSchedulerTest, ReusableAcrossCalls) {
+    TaskScheduler scheduler(3);
+    for (size_t round = 0; round < 20; ++round) {
+        std::atomic<size_t> count{0};
+        scheduler.ParallelFor(round * 7, 3, [&](size_t begin, size_t end, size_t) { count += end - begin; });
+        EXPECT_EQ(count, round * 7);
+    }
+}
+
+TEST(TaskSchedulerTest, EmptyLoop) {
+    TaskScheduler scheduler(2);
+    bool called = false;
+    ParallelForStats stats = scheduler.ParallelFor(0, 4, [&](size_t, size_t, size_t) { called = true; });
+    EXPECT_FALSE(called);
+    EXPECT_EQ(stats.steals, 0u);
+}
+
+TEST(TaskSchedulerTest, RethrowsTaskException) {
+    TaskScheduler scheduler(4);
+    EXPECT_THROW(scheduler.ParallelFor(100, 1, [](size_t begin, size_t, size_t) {
+        if (begin == 42) {
+            throw std::runtime_error("task failed");
+        }
+    }), std::runtime_error);
+    // Still usable afterwards
+    std::atomic<size_t> count{0};
+    scheduler.ParallelFor(10, 1, [&](size_t, size_t, size_t) { ++count; });
+    EXPECT_EQ(count, 10u);
+}
+
+TEST(TaskSchedulerTest, RejectsZeroChunkSize) {
+    TaskScheduler scheduler(1);
+    EXPECT_THROW(scheduler.ParallelFor(10, 0, [](size_t, size_t, size_t) {}), std::invalid_argument);
+}
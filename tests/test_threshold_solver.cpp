@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+#include "solver/threshold_solver.h"
+#include "solver/solver.h"
+#include "game_state/category.h"
+#include "test_util.h"
+
+namespace {
+
+constexpr double QUANTIZATION_ERROR = 2.0 / ThresholdSolver::QUANTUM;
+
+}  // namespace
+
+TEST(ThresholdSolverTest, FullSheetScoresNothingMore) {
+    ThresholdSolver solver;
+    SolveLastLayers(solver, NUM_CATEGORIES);
+    ShortStateKey key(ShortStateKey::FULL_MASK, 0, false);
+    EXPECT_EQ(solver.GetProbability(key, 0), 1.0);
+    EXPECT_EQ(solver.GetProbability(key, 1), 0.0);
+}
+
+TEST(ThresholdSolverTest, YahtzeeOnly) {
+    ThresholdSolver solver;
+    SolveLastLayers(solver, NUM_CATEGORIES - 1);
+    ShortStateKey key(MaskWithOpen({Category::Yahtzee}), 0, false);
+    EXPECT_EQ(solver.GetProbability(key, 0), 1.0);
+    EXPECT_NEAR(solver.GetProbability(key, 1), 0.046029, 1e-5);
+    EXPECT_NEAR(solver.GetProbability(key, 50), 0.046029, 1e-5);
+    EXPECT_EQ(solver.GetProbability(key, 51), 0.0);
+}
+
+TEST(ThresholdSolverTest, ChanceOnlyIsCertainUpToFive) {
+    ThresholdSolver solver;
+    SolveLastLayers(solver, NUM_CATEGORIES - 1);
+    ShortStateKey key(MaskWithOpen({Category::Chance}), 0, false);
+    EXPECT_EQ(solver.GetProbability(key, 5), 1.0);
+    EXPECT_EQ(solver.GetProbability(key, 31), 0.0);
+    // Thirty needs five sixes: every die is rerolled until it shows a six
+    double all_sixes = 91.0 / 216.0;
+    EXPECT_NEAR(solver.GetProbability(key, 30), all_sixes * all_sixes * all_sixes * all_sixes * all_sixes, 1e-5);
+}
+
+TEST(ThresholdSolverTest, UpperBonusCountsTowardsThresholds) {
+    ThresholdSolver solver;
+    SolveLastLayers(solver, NUM_CATEGORIES - 1);
+    ShortStateKey pending(MaskWithOpen({Category::Sixes}), 18, false);
+    ShortStateKey reached(MaskWithOpen({Category::Sixes}), 0, false);
+    // Three sixes score 18 plus the bonus, so 53 is as likely as 18
+    EXPECT_NEAR(solver.GetProbability(pending, 53), solver.GetProbability(pending, 18), QUANTIZATION_ERROR);
+    EXPECT_GT(solver.GetProbability(pending, 53), 0.3);
+    EXPECT_EQ(solver.GetProbability(reached, 31), 0.0);
+}
+
+TEST(ThresholdSolverTest, ProbabilitiesDecreaseAndBoundExpectedScore) {
+    ThresholdSolver thresholds;
+    Solver expected;
+    SolveLastLayers(thresholds, NUM_CATEGORIES - 2);
+    SolveLastLayers(expected, NUM_CATEGORIES - 2);
+
+    for (ShortStateKey key : GetLayerStates(NUM_CATEGORIES - 2)) {
+        double previous = 1.0;
+        double sum = 0.0;
+        for (size_t points = 1; points <= ThresholdSolver::MAX_REMAINING_SCORE; ++points) {
+            double probability = thresholds.GetProbability(key, points);
+            EXPECT_LE(probability, previous + QUANTIZATION_ERROR);
+            previous = probability;
+            sum += probability;
+        }
+        // Every threshold is maximised on its own, their sum bounds the best expectation
+        EXPECT_GE(sum + 1e-3, expected.GetStateValue(key));
+    }
+}
+
+TEST(ThresholdSolverTest, ThreadCountDoesNotChangeRows) {
+    ThresholdSolver single;
+    ThresholdSolver multi;
+    for (size_t filled = NUM_CATEGORIES + 1; filled-- > NUM_CATEGORIES - 1;) {
+        single.SolveLayer(filled, 1);
+        multi.SolveLayer(filled, 3);
+    }
+    ShortStateKey key(MaskWithOpen({Category::Fours}), 8, true);
+    std::vector<size_t> thresholds{0, 1, 4, 8, 12, 16, 43, 55, 56};
+    EXPECT_EQ(single.GetProbabilities(key, thresholds), multi.GetProbabilities(key, thresholds));
+    EXPECT_EQ(single.GetStorageBytes(), multi.GetStorageBytes());
+}
@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+#include "solver/turn_kernels.h"
+#include "move/reroll_matrix.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <random>
+
+namespace {
+
+template<typename T, typename Shape = FiveDice>
+std::array<T, Shape::NUM_ROLLS> RandomRollValues(unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> distribution(0.0, 400.0);
+    std::array<T, Shape::NUM_ROLLS> values{};
+    for (T &value : values) {
+        value = static_cast<T>(distribution(rng));
+    }
+    return values;
+}
+
+template<typename T, typename Shape = FiveDice>
+void ExpectKernelsMatchScalar() {
+    const TurnKernels<T> &scalar = GetTurnKernels<T, Shape>(KernelIsa::Scalar);
+    for (KernelIsa isa : {KernelIsa::Avx2, KernelIsa::Avx512}) {
+        const TurnKernels<T> &kernels = GetTurnKernels<T, Shape>(isa);
+        for (unsigned seed = 0; seed < 8; ++seed) {
+            auto roll_values = RandomRollValues<T, Shape>(seed);
+            auto score_values = RandomRollValues<T, Shape>(seed + 100);
+            std::array<T, Shape::NUM_KEEPS> expected_keeps{}, keeps{};
+            std::array<T, Shape::NUM_ROLLS> expected_rolls{}, rolls{};
+
+            scalar.reduce_keeps(roll_values.data(), expected_keeps.data());
+            kernels.reduce_keeps(roll_values.data(), keeps.data());
+            EXPECT_EQ(0, std::memcmp(expected_keeps.data(), keeps.data(), sizeof(keeps)))
+                << KernelIsaToString(kernels.isa);
+
+            scalar.max_rolls(score_values.data(), expected_keeps.data(), expected_rolls.data());
+            kernels.max_rolls(score_values.data(), expected_keeps.data(), rolls.data());
+            EXPECT_EQ(0, std::memcmp(expected_rolls.data(), rolls.data(), sizeof(rolls)))
+                << KernelIsaToString(kernels.isa);
+        }
+    }
+}
+
+}  // namespace
+
+TEST(TurnKernelsTest, DispatchNeverExceedsDetectedIsa) {
+    EXPECT_EQ(GetTurnKernels<double>(KernelIsa::Scalar).isa, KernelIsa::Scalar);
+    EXPECT_LE(GetTurnKernels<double>(KernelIsa::Avx512).isa, DetectKernelIsa());
+    EXPECT_LE(GetTurnKernels<float>(KernelIsa::Avx512).isa, DetectKernelIsa());
+    EXPECT_EQ(GetTurnKernels<double>().isa, DetectKernelIsa());
+}
+
+TEST(TurnKernelsTest, DoubleKernelsMatchScalar) {
+    ExpectKernelsMatchScalar<double>();
+}
+
+TEST(TurnKernelsTest, FloatKernelsMatchScalar) {
+    ExpectKernelsMatchScalar<float>();
+}
+
+TEST(TurnKernelsTest, SixDiceKernelsMatchScalar) {
+    ExpectKernelsMatchScalar<double, SixDice>();
+    ExpectKernelsMatchScalar<float, SixDice>();
+}
+
+TEST(TurnKernelsTest, ReduceKeepMatchesKernelAndMatrix) {
+    auto roll_values = RandomRollValues<double>(7);
+    std::array<double, NUM_KEEPS> keeps{};
+    GetTurnKernels<double>().reduce_keeps(roll_values.data(), keeps.data());
+    for (size_t keep = 0; keep < NUM_KEEPS; ++keep) {
+        EXPECT_EQ(ReduceKeep(static_cast<KeepIndex>(keep), roll_values.data()), keeps[keep]);
+
+        RerollMatrix::Row row = REROLL_MATRIX.GetRow(static_cast<KeepIndex>(keep));
+        double expected = 0.0;
+        for (size_t i = 0; i < row.size; ++i) {
+            expected += row.probabilities[i] * roll_values[row.rolls[i]];
+        }
+        EXPECT_NEAR(keeps[keep], expected, 1e-9);
+    }
+}
+
+TEST(TurnKernelsTest, MaxRollsTakesBestSubKeep) {
+    auto score_values = RandomRollValues<double>(3);
+    std::array<double, NUM_KEEPS> keeps{};
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<double> distribution(0.0, 400.0);
+    for (double &value : keeps) {
+        value = distribution(rng);
+    }
+    std::array<double, NUM_ROLLS> rolls{};
+    GetTurnKernels<double>().max_rolls(score_values.data(), keeps.data(), rolls.data());
+    for (size_t roll = 0; roll < NUM_ROLLS; ++roll) {
+        double best = score_values[roll];
+        for (KeepIndex keep : SUB_KEEP_TABLE.GetRow(static_cast<KeepIndex>(KEEP_OFFSETS[NUM_DICE] + roll))) {
+            best = std::max(best, keeps[keep]);
+        }
+        EXPECT_EQ(rolls[roll], best);
+    }
+}
+
+TEST(TurnKernelsTest, SixDiceReduceKeepMatchesMatrix) {
+    auto roll_values = RandomRollValues<double, SixDice>(5);
+    std::array<double, SixDice::NUM_KEEPS> keeps{};
+    GetTurnKernels<double, SixDice>().reduce_keeps(roll_values.data(), keeps.data());
+    for (size_t keep = 0; keep < SixDice::NUM_KEEPS; ++keep) {
+        const auto index = static_cast<SixDice::KeepIndex>(keep);
+        EXPECT_EQ((ReduceKeep<double, SixDice>(index, roll_values.data())), keeps[keep]);
+
+        const auto row = SHAPE_REROLL_MATRIX<SixDice>.GetRow(index);
+        double expected = 0.0;
+        for (size_t i = 0; i < row.size; ++i) {
+            expected += row.probabilities[i] * roll_values[row.rolls[i]];
+        }
+        EXPECT_NEAR(keeps[keep], expected, 1e-9);
+    }
+}
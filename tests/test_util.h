@@ -0,0 +1,63 @@
+#pragma once
+
+#include "game_state/dice_index.h"
+#include "game_state/game_state.h"
+#include "game_state/game_state_utils.h"
+#include "game_state/short_state_key.h"
+#include "solver/solver.h"
+
+#include <algorithm>
+#include <initializer_list>
+#include <random>
+
+// Game state with every category used except the given ones
+inline GameState StateWithOpen(std::initializer_list<Category> open) {
+    GameState state;
+    for (size_t i = 0; i < NUM_CATEGORIES; ++i) {
+        Category category = static_cast<Category>(i);
+        if (std::find(open.begin(), open.end(), category) == open.end()) {
+            state.AddScoreToCategory(category, 0);
+        }
+    }
+    return state;
+}
+
+// Used categories of a key with every category used except the given ones
+inline uint32_t MaskWithOpen(std::initializer_list<Category> open) {
+    uint32_t mask = ShortStateKey::FULL_MASK;
+    for (Category category : open) {
+        mask &= ~(uint32_t{1} << static_cast<uint32_t>(category));
+    }
+    return mask;
+}
+
+// The full solve is far too slow for unit tests, only the last layers are solved
+template<typename S>
+void SolveLastLayers(S &solver, size_t down_to) {
+    for (size_t filled = NUM_CATEGORIES + 1; filled-- > down_to;) {
+        solver.SolveLayer(filled);
+    }
+}
+
+// The last three layers, solved once for every test that needs them
+inline const Solver &EndgameSolver() {
+    static const Solver solver = [] {
+        Solver solved;
+        SolveLastLayers(solved, NUM_CATEGORIES - 2);
+        return solved;
+    }();
+    return solver;
+}
+
+// A roll showing the kept dice, the others thrown with rng
+inline Dice RollAround(const DiceCounts &kept, std::mt19937 &rng) {
+    DiceCounts counts = kept;
+    size_t total = 0;
+    for (uint8_t count : counts) {
+        total += count;
+    }
+    for (; total < NUM_DICE; ++total) {
+        ++counts[rng() % NUM_FACES];
+    }
+    return Dice::from_roll_index(ToRollIndex(counts));
+}